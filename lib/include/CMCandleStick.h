@@ -170,7 +170,22 @@ class CMCandleStick {
     return &m_timestamp;
   }
 
-  void* getMemberPtr(size_t i);
+  // visits the columns of m_fields in the same order, used by the row codec in DbUtils
+  template <typename V>
+  inline void visitFields(V& visitor) {
+    visitor(m_market_cap_usd);
+    visitor(m_price_btc);
+    visitor(m_price_usd);
+    visitor(m_volume_usd);
+  }
+
+  template <typename V>
+  inline void visitFields(V& visitor) const {
+    visitor(m_market_cap_usd);
+    visitor(m_price_btc);
+    visitor(m_price_usd);
+    visitor(m_volume_usd);
+  }
 
   double get(candle_price_t price) {
     switch (price) {
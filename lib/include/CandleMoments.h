@@ -0,0 +1,57 @@
+//
+// Created by subhagato on 10/18/26.
+//
+
+#ifndef CRYPTOTRADER_CANDLEMOMENTS_H
+#define CRYPTOTRADER_CANDLEMOMENTS_H
+
+#include "Candlestick.h"
+#include "utils/TimeUtils.h"
+#include "utils/Volume.h"
+
+/*******
+ *
+ * Running statistics of the ticks of one candle: OHLC, volume, and the volume weighted mean and M2 (sum of weighted
+ * squared deviations), updated with West's weighted form of Welford's algorithm.
+ *
+ * Moments of two consecutive parts of a candle merge exactly (Chan et al.), so a candle can be built from day chunks
+ * of ticks in parallel, and a coarser candle from the finer candles it covers. Unweighted moments are kept as well,
+ * they are used when all ticks of the candle have zero volume (same as the Candlestick constructor).
+ */
+
+typedef struct candle_moments_t {
+  Time start_time;
+  int64_t num_ticks = 0;
+
+  double open = 0;
+  double close = 0;
+  double low = 0;
+  double high = 0;
+
+  Volume volume;
+
+  // volume weighted
+  double weight = 0;
+  double mean = 0;
+  double m2 = 0;
+
+  // unweighted
+  double count_mean = 0;
+  double count_m2 = 0;
+
+  candle_moments_t() = default;
+
+  explicit candle_moments_t(const Time a_start_time) : start_time(a_start_time) {}
+
+  // moments of a candle built earlier, the deviations of its ticks are only known through the stddev
+  explicit candle_moments_t(const Candlestick& a_candle);
+
+  void add(const double a_price, const double a_size);
+
+  // a_later holds the ticks which follow the ones of this candle
+  void merge(const candle_moments_t& a_later);
+
+  Candlestick toCandlestick() const;
+} candle_moments_t;
+
+#endif  // CRYPTOTRADER_CANDLEMOMENTS_H
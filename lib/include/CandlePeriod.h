@@ -6,9 +6,11 @@
 #define CRYPTOTRADER_CANDLEPERIOD_H
 
 #include "CMCandleStick.h"
+#include "CandleMoments.h"
 #include "Candlestick.h"
 #include <deque>
 #include <iostream>
+#include <vector>
 
 class Tick;
 class CoinAPITick;
@@ -16,6 +18,7 @@ template <typename T>
 class TickPeriodT;
 template <typename T>
 class Database;
+class TickColumns;
 
 template <typename C, typename T>
 class CandlePeriodT : public std::deque<C> {
@@ -28,6 +31,16 @@ class CandlePeriodT : public std::deque<C> {
 
   double m_last_price;
 
+  // running moments of the last candle, ticks appended one by one update it without rebuilding the candle
+  candle_moments_t m_last_moments;
+
+  // only candles with ticks are stored, a gap between two stored candles is a run of flat candles at the close of the
+  // earlier one
+  bool m_sparse = false;
+
+  // candles removed from the front by evictFront, flat ones included
+  size_t m_num_evicted = 0;
+
  public:
   CandlePeriodT() {
     m_first_ts = 0;
@@ -52,8 +65,39 @@ class CandlePeriodT : public std::deque<C> {
 
   bool convertFrom(TickPeriodT<T>& trade_period);
 
+  // converts the ticks to candles of all the periods in one go, periods whose interval is a multiple of another one
+  // are derived from its candle moments, the others are built from day chunks of the ticks in parallel
+  static bool sConvertFrom(TickPeriodT<T>& trade_period, const std::vector<CandlePeriodT<C, T>*>& a_candle_periods);
+
+  // same candles as from a TickPeriod, built from the columns of a TickColumns
+  bool convertFrom(const TickColumns& a_ticks);
+
+  // rebuilds an already built candle from the ticks of a non consecutive trade period, after late ticks are merged
+  bool updateCandle(TickPeriodT<T>& trade_period, const Time a_start_time);
+
   int appendTick(const T& t);
 
+  bool isSparse() const {
+    return m_sparse;
+  }
+
+  // changes the mode of an empty period only
+  bool setSparse(const bool a_sparse);
+
+  // number of candles including the flat ones which aren't stored in a sparse period
+  size_t getNumCandles() const;
+
+  // candle at an index (flat ones counted) from the beginning or the end, in O(log n) for a sparse period
+  C getCandle(const size_t a_idx) const;
+  C getCandleFromEnd(const size_t a_idx_from_back) const;
+
+  // candle starting at a_start_time, which should be between the first and the last candle
+  C getCandleAt(const Time a_start_time) const;
+
+  // gets the candle starting at a_start_time, returns the number of same candles from it till a_end_time, which is
+  // more than 1 only for a run of flat candles in a sparse period
+  size_t getCandleRun(const Time a_start_time, const Time a_end_time, C& a_candle) const;
+
   Time getFirstTimestamp() const {
     return m_first_ts;
   }
@@ -93,8 +137,22 @@ class CandlePeriodT : public std::deque<C> {
     m_last_price = last_price;
   }
 
+  const candle_moments_t& getLastMoments() const {
+    return m_last_moments;
+  }
+  void setLastMoments(const candle_moments_t& a_moments) {
+    m_last_moments = a_moments;
+  }
+
   int append(const C& cs);
 
+  // removes the oldest a_num_candles candles, the last one (which is still being built) is always kept
+  size_t evictFront(const size_t a_num_candles);
+
+  size_t getNumEvicted() const {
+    return m_num_evicted;
+  }
+
   int appendSmallerCandle(const C& cs, Duration interval);
 
   int storeToDatabase(Database<C>* db);
@@ -144,8 +144,30 @@ class Candlestick {
     m_stddev = 0;
   }
 
-  void* getMemberPtr(size_t i);
-  void setMemberPtr(void* value, size_t i);
+  // visits the columns of m_fields in the same order, used by the row codec in DbUtils
+  template <typename V>
+  inline void visitFields(V& visitor) {
+    visitor(m_open);
+    visitor(m_close);
+    visitor(m_low);
+    visitor(m_high);
+    visitor(m_mean);
+    visitor(m_stddev);
+    visitor(m_volume.getBuyVolume());
+    visitor(m_volume.getSellVolume());
+  }
+
+  template <typename V>
+  inline void visitFields(V& visitor) const {
+    visitor(m_open);
+    visitor(m_close);
+    visitor(m_low);
+    visitor(m_high);
+    visitor(m_mean);
+    visitor(m_stddev);
+    visitor(m_volume.getBuyVolume());
+    visitor(m_volume.getSellVolume());
+  }
 
   double get(candle_price_t price) const {
     switch (price) {
@@ -96,8 +96,18 @@ class CoinAPITick {
     return &m_flags;
   }
 
-  void* getMemberPtr(const size_t i);
-  void setMemberPtr(const void* value, const size_t i);
+  // visits the columns of m_fields in the same order, used by the row codec in DbUtils
+  template <typename V>
+  inline void visitFields(V& visitor) {
+    visitor(m_price);
+    visitor(m_size);
+  }
+
+  template <typename V>
+  inline void visitFields(V& visitor) const {
+    visitor(m_price);
+    visitor(m_size);
+  }
 
   friend std::ostream& operator<<(std::ostream& os, const CoinAPITick& tick) {
     os << std::setprecision(6) << std::fixed;
@@ -12,6 +12,9 @@
 #pragma once
 
 #include "exchanges/Exchange.h"
+#include "indicators/IndicatorRegistry.h"
+#include <queue>
+#include <tuple>
 
 class Time;
 class CurrencyPair;
@@ -23,6 +26,9 @@ class Controller {
 
   TradeAlgo* mp_TradeAlgo;
 
+  // indicators of the algo, an indicator asked for several times is computed once
+  IndicatorRegistry m_indicator_registry;
+
   Time m_start_time;
   Time m_end_time;
   Duration m_history;
@@ -52,11 +58,36 @@ class Controller {
   // order log
   FILE* m_order_log;
 
+  // next tick of a trading pair in simulation
+  typedef struct sim_cursor_t {
+    Time timestamp;
+    int64_t trade_id;
+    size_t pair_idx;  // keeps the order of trading pairs for ticks with the same time and id
+    const TradeHistory* p_full_trade_history;
+    TradeHistory* p_past_trade_history;
+  } sim_cursor_t;
+
+  struct LaterSimCursor {
+    bool operator()(const sim_cursor_t& lhs, const sim_cursor_t& rhs) const {
+      return (std::tie(lhs.timestamp, lhs.trade_id, lhs.pair_idx) >
+              std::tie(rhs.timestamp, rhs.trade_id, rhs.pair_idx));
+    }
+  };
+
+  // min heap of the trading pairs which still have ticks before end time, merges their ticks in time order
+  std::priority_queue<sim_cursor_t, std::vector<sim_cursor_t>, LaterSimCursor> m_sim_cursors;
+
+  void initSimulationCursors();
+
+  void pushSimulationCursor(sim_cursor_t& a_cursor);
+
   bool getNextTradeForSimulation();
 
   void adjustTimeAndCheckForIntervalEvents(const Time& a_tick_time);
 
-  void updateTick(const TradeHistory* p_full_trade_history, TradeHistory* p_delayed_trade_history);
+  // moves the delayed history a_num_ticks ticks forward, tick events are handled once for the last tick
+  void updateTick(const TradeHistory* p_full_trade_history, TradeHistory* p_delayed_trade_history,
+                  const size_t a_num_ticks = 1);
   void handleTickEvent(const exchange_t a_exchange_id, const CurrencyPair& currency_pair);
 
   std::vector<TradeHistory*> getPastTradeHistories() const;
@@ -138,7 +169,10 @@ class Controller {
   void saveHeaderInCSV(FILE* ap_file, const exchange_t a_exchange_id) const;
   void saveStatsInCSV(FILE* ap_file, const exchange_t a_exchange_id);
 
-  void doRealTimeTrading(const TradeHistory* ap_trade_history);
+  void doRealTimeTrading(const TradeHistory* ap_trade_history, const size_t a_num_new_ticks = 1);
+
+  // late ticks of ap_trade_history rewrote its candles from a_from on, the delayed history follows
+  void doCandleUpdate(const TradeHistory* ap_trade_history, const Time a_from);
 
   const Order* getOrder(const exchange_t a_exchange_id, const order_id_t a_order_id) const;
   const Order* lastCancelledOrder(const exchange_t exchange_id) const;
@@ -42,6 +42,50 @@ typedef struct primary_key_t {
 
 } primary_key_t;
 
+// Partitions of a table are time buckets of a fixed width. The partition key (date column) is the index of the bucket
+// since epoch and the time column is micros since the start of the bucket, so day buckets are days since epoch and
+// micros since midnight, the layout of tables created before the width was configurable.
+class TimeBucket {
+ private:
+  bucket_width_t m_width;
+  int64_t m_width_micros;
+
+ public:
+  explicit TimeBucket(const bucket_width_t a_width = bucket_width_t::DAY)
+      : m_width(a_width), m_width_micros(static_cast<int64_t>(a_width) * 3600 * 1000000LL) {}
+
+  bucket_width_t getWidth() const {
+    return m_width;
+  }
+
+  int32_t getBucket(const Time a_time) const {
+    return static_cast<int32_t>(static_cast<int64_t>(a_time) / m_width_micros);
+  }
+
+  int32_t getBucket(const primary_key_t& a_key) const {
+    return getBucket(Time(a_key.date, a_key.time));
+  }
+
+  int64_t getOffset(const Time a_time) const {
+    return static_cast<int64_t>(a_time) - getBucket(a_time) * m_width_micros;
+  }
+
+  Time getTime(const int32_t a_bucket, const int64_t a_offset) const {
+    return Time(a_bucket * m_width_micros + a_offset);
+  }
+
+  // first and last possible keys of a bucket
+  primary_key_t getStartKey(const int32_t a_bucket) const {
+    const Time start = getTime(a_bucket, 0);
+    return primary_key_t(start.days_since_epoch(), start.micros_since_midnight(), 0);
+  }
+
+  primary_key_t getEndKey(const int32_t a_bucket) const {
+    const Time end = getTime(a_bucket, m_width_micros - 1);
+    return primary_key_t(end.days_since_epoch(), end.micros_since_midnight(), INT64_MAX);
+  }
+};
+
 typedef std::vector<std::pair<std::string, std::string>> field_t;
 
 inline std::ostream& operator<<(std::ostream& os, const primary_key_t& primary_key) {
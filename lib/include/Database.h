@@ -6,8 +6,14 @@
 #define CRYPTOTRADER_DATABASES_H
 
 #define CASS_MAX_BATCH_STATEMENTS 25
+#define CASS_MAX_BATCH_BYTES 4096       // below cassandra's default batch_size_warn_threshold (5kB)
+#define CASS_MAX_BATCHES_IN_FLIGHT 32   // concurrent batches executed by storeDataInBatch
+#define CASS_LOAD_DAYS_IN_FLIGHT 8      // day partitions queried concurrently by loadData
+#define CASS_LOAD_PAGE_SIZE 5000        // rows per page while loading
+#define CASS_MAX_WRITES_IN_FLIGHT 256   // default number of concurrent inserts by insertMultipleRowsToDatabase
 
 #include "CurrencyPair.h"
+#include "ExistenceIndex.h"
 #include "dbMetadata.h"
 #include "iterator_tpl.h"
 #include "utils/TimeUtils.h"
@@ -27,17 +33,29 @@
     }
 */
 
+// insert or batch executing on the driver's IO threads
+typedef struct pending_write_t {
+  size_t first_row;  // index of the first row in the inserted range
+  size_t num_rows;
+  CassFuture* future;
+} pending_write_t;
+
 template <typename T>
 class Database {
  private:
   field_t m_row_fields;
   std::string m_create_table_cql;
+  std::string m_select_columns;
   std::string m_insert_cql;
+  std::string m_insert_check_cql;  // insert with IF NOT EXISTS
   std::string m_select_cql;
   std::string m_delete_cql;
+  std::string m_newest_row_cql;
+  std::string m_oldest_row_cql;
   std::string m_table_name;
   std::string m_key_space;
   std::string m_name;
+  std::string m_symbol;  // partition key of a shared table, empty if the table has only one symbol
 
   bool m_consecutive;
   bool m_check_insert;
@@ -46,11 +64,26 @@ class Database {
   primary_key_t m_end_key;
 
   CassStatement* m_cass_statement;
-  CassBatch* m_cass_batch;
   size_t m_primary_key_fields;
+  size_t m_insert_fields;
 
   dbMetadata* m_db_metadata;
 
+  TimeBucket m_bucket;  // partition width of the table
+
+  // prepared statements of this table, keyed by CQL
+  mutable std::map<std::string, const CassPrepared*> m_prepared_statements;
+  mutable std::mutex m_prepared_mutex;
+  bool m_use_prepared_statements;
+
+  size_t m_max_writes_in_flight;
+
+  // rows known to be new or present, lets inserts skip IF NOT EXISTS
+  ExistenceIndex m_existence_index;
+  bool m_use_existence_index;
+
+  CassStatement* newCassStatement(const std::string& a_cql, size_t a_num_params) const;
+
   bool generateInsertQuery(bool check_for_existance = false);
 
   bool generateSelectQuery(bool greater_equal = true, bool less_equal = false);
@@ -59,45 +92,87 @@ class Database {
 
   bool generateDeleteQuery(bool greater_equal = true, bool less_equal = false, bool delete_all = false);
 
-  std::string generateSingleRowQuery(int32_t date, bool latest = true) const;
+  std::string generateSingleRowQuery(bool latest = true) const;
 
-  void bindRowToCassStatement(CassStatement* cass_statement, T& row) const;
+  void bindRowToCassStatement(CassStatement* cass_statement, const T& row) const;
 
-  void bindQueryParamsToCassStatement(CassStatement* cass_statement, int32_t date, Time time_start,
-                                      Time time_end) const;
+  void bindQueryParamsToCassStatement(CassStatement* cass_statement, int32_t bucket, int64_t offset_start,
+                                      int64_t offset_end) const;
 
   void bindQueryParamsToCassStatement(CassStatement* cass_statement, primary_key_t start_key,
                                       primary_key_t end_key) const;
 
   T getRowFromCassIterator(const CassRow* cass_row) const;
 
-  bool addStatementToCassBatch(T& row);
+  size_t addStatementToCassBatch(CassBatch* cass_batch, const T& row) const;
 
   bool insertSingleRowToDatabase(T& row);
 
   size_t insertMultipleRowsToDatabase(typename std::deque<T>::iterator start_itr,
                                       typename std::deque<T>::iterator end_itr, bool check_if_exists = true);
 
-  bool createBatchSession();
+  void waitForOldestWrite(std::deque<pending_write_t>& pending_writes, std::vector<bool>& result) const;
+
+  // range of one partition to be loaded into data
+  typedef struct load_query_t {
+    const Database<T>* db;
+    std::deque<T>* data;
+    int32_t bucket;
+    int64_t start_offset;
+    int64_t end_offset;
+    bool cacheable;  // served through the local partition cache
+  } load_query_t;
+
+  void addLoadQueries(std::deque<T>& data, Time start_time, Time end_time, std::vector<load_query_t>& queries) const;
 
-  bool executeBatchSession() const;
+  std::string getCacheKey(const int32_t a_bucket) const;
 
-  void executeCassStatements(std::vector<CassStatement*>& cass_statements, std::vector<bool>& result, size_t start = 0,
-                             size_t end = SIZE_MAX);
+  bool isInLoadQuery(const load_query_t& query, const T& row) const;
 
-  bool getSingleRow(std::string statement, T& row);
+  // drops cached partitions overlapping [a_start_key, a_end_key]
+  void invalidateCache(const primary_key_t& a_start_key, const primary_key_t& a_end_key) const;
 
+  static int sRunLoadQueries(const std::vector<load_query_t>& queries);
+
+  bool getSingleRow(const std::string& cql, int32_t bucket, T& row);
+
+  // summary of one partition scanned by fixDatabase
+  typedef struct bucket_scan_t {
+    bool valid;  // false if the query failed
+    int64_t num_entries;
+    int64_t first_unique_id;
+    int64_t last_unique_id;
+    primary_key_t first_key;
+    primary_key_t last_key;
+    primary_key_t max_key;
+    std::vector<std::pair<primary_key_t, primary_key_t>> discontinuities;  // inside the partition
+  } bucket_scan_t;
+
+  void scanBucket(const std::string& a_cql, const primary_key_t a_start_key, const primary_key_t a_end_key,
+                  bucket_scan_t& a_bucket_scan) const;
+
+  // with blind_write the rows were written without IF NOT EXISTS, so only the ones after the last entry are counted
   size_t updateMetadata(typename std::deque<T>::iterator start_itr, typename std::deque<T>::iterator end_itr,
-                        std::vector<bool>& results, bool check_if_exists = true);
+                        std::vector<bool>& results, bool check_if_exists = true, bool blind_write = false);
 
-  bool storeDataInBatch(std::deque<T>& a_data);
+  // a write is in flight from its first statement till endWrite counts its rows in the metadata
+  void beginWrite() const;
+
+  size_t endWrite(typename std::deque<T>::iterator start_itr, typename std::deque<T>::iterator end_itr,
+                  std::vector<bool>& results, bool check_if_exists = true, bool blind_write = false);
 
  public:
+  // a_bucket_width is the partition width of a new table, existing tables keep the width stored in their metadata.
+  // With a_symbol the rows are stored in the shared table name, with the symbol as part of the partition key.
   Database(const std::string& key_space, const std::string& name, const bool a_consecutive = true,
-           const bool a_check_insert = true);
+           const bool a_check_insert = true, const bucket_width_t a_bucket_width = bucket_width_t::DAY,
+           const std::string& a_symbol = "");
   Database(const std::string& key_space, exchange_t exchange_id, CurrencyPair currency_pair,
-           const bool a_consecutive = true, const bool a_check_insert = true)
-      : Database(key_space, getTableName(exchange_id, currency_pair), a_consecutive, a_check_insert) {}
+           const bool a_consecutive = true, const bool a_check_insert = true,
+           const bucket_width_t a_bucket_width = bucket_width_t::DAY, const bool a_shared_table = false)
+      : Database(key_space, a_shared_table ? getSharedTableName() : getTableName(exchange_id, currency_pair),
+                 a_consecutive, a_check_insert, a_bucket_width,
+                 a_shared_table ? getTableName(exchange_id, currency_pair) : "") {}
 
   ~Database();
 
@@ -111,17 +186,35 @@ class Database {
 
   static std::string getTableName(exchange_t exchange_id, CurrencyPair currency_pair, bool lower = true);
 
+  // table holding all symbols of type T
+  static std::string getSharedTableName();
+
+  const std::string& getSymbol() const {
+    return m_symbol;
+  }
+
   bool createTable() const;
 
   // If possible following two function can be made private and accessed through friend class.
   int loadData(std::deque<T>& data, Time start_time = Time(),
                Time end_time = Time());  // by default it will load all data from database
 
+  // loads the same time range of several tables (usually symbols of a shared table) in one pass, rows of a_dbs[i]
+  // are appended to a_data[i]
+  static int sLoadData(const std::vector<Database<T>*>& a_dbs, const std::vector<std::deque<T>*>& a_data,
+                       Time start_time = Time(), Time end_time = Time());
+
   // by default it wil store all data to database
   size_t storeData(std::deque<T>& data, Time start_time = Time(), Time end_time = Time(), bool check_if_exists = true);
 
   size_t storeData(typename std::deque<T>::iterator start_itr, typename std::deque<T>::iterator end_itr);
 
+  // bulk insert with unlogged single partition batches, rows are written blindly (no IF NOT EXISTS) and assumed to
+  // be new. Rows should be sorted by time, as a batch only takes consecutive rows of the same partition.
+  size_t storeDataInBatch(typename std::deque<T>::iterator start_itr, typename std::deque<T>::iterator end_itr);
+
+  size_t storeDataInBatch(std::deque<T>& a_data);
+
   // by default it wil delete all data from database
   size_t deleteData(Time start_time = Time(), Time end_time = Time());
 
@@ -131,6 +224,23 @@ class Database {
   bool getNewestRow(T& row);
   bool getOldestRow(T& row);
 
+  bucket_width_t getBucketWidth() const {
+    return m_bucket.getWidth();
+  }
+
+  // copies all rows into a_name (created with a_bucket_width if it doesn't exist), returns number of rows copied
+  size_t copyToTable(const std::string& a_name, const bucket_width_t a_bucket_width);
+
+  // drops a table and its metadata
+  static void sDropTable(const std::string& a_key_space, const std::string& a_name);
+
+  // rewrites a table into partitions of a_bucket_width through a temporary copy. The partition key can't be altered,
+  // so the table is dropped and recreated in between: its writers (captures of every process) have to be stopped
+  // first, rows written during the migration are lost. a_consecutive tells whether trade ids of the table are
+  // consecutive, as given to the constructor.
+  static bool sMigrateTable(const std::string& a_key_space, const std::string& a_name,
+                            const bucket_width_t a_bucket_width, const bool a_consecutive);
+
   bool fixDatabase(bool full_scan, bool fix_metadata, primary_key_t& min_key, primary_key_t& max_key,
                    primary_key_t& last_key, int64_t& num_entries,
                    std::vector<std::pair<primary_key_t, primary_key_t>>& discontinuity_id_pairs);
@@ -154,6 +264,21 @@ class Database {
     return m_db_metadata;
   }
 
+  // prepared statements are used by default, disabling is only useful for measurements
+  void setUsePreparedStatements(const bool a_use_prepared_statements) {
+    m_use_prepared_statements = a_use_prepared_statements;
+  }
+
+  // with the index disabled every checked insert is a lightweight transaction
+  void setUseExistenceIndex(const bool a_use_existence_index) {
+    m_use_existence_index = a_use_existence_index;
+  }
+
+  // upper bound of inserts waiting on the cluster at once, larger values need a larger driver request queue
+  void setMaxWritesInFlight(const size_t a_max_writes_in_flight) {
+    m_max_writes_in_flight = std::max<size_t>(a_max_writes_in_flight, 1);
+  }
+
   // Iterators from https://github.com/VinGarcia/Simple-Iterator-Template/
 
   STL_TYPEDEFS(T);  // (Optional)
@@ -195,7 +320,8 @@ class Database {
 
     primary_key_t start_day_key;
     primary_key_t end_day_key;
-    int32_t current_date;
+    int32_t current_bucket;
+    int32_t end_bucket;
     bool end_of_table;
     bool next_exist;
 
@@ -203,24 +329,24 @@ class Database {
     primary_key_t end_key;
 
     inline void next(const Database* ref) {
-      for (; current_date <= end_key.date; current_date++) {
+      for (; current_bucket <= end_bucket; current_bucket++) {
         if (!next_exist) {
-          CassStatement* cass_statement = cass_statement_new(ref->m_select_cql.c_str(), ref->m_primary_key_fields);
+          CassStatement* cass_statement = ref->newCassStatement(ref->m_select_cql, ref->m_primary_key_fields);
 
-          if (current_date == start_key.date)
-            start_day_key = ref->m_start_key;
+          if (current_bucket == ref->m_bucket.getBucket(start_key))
+            start_day_key = start_key;
           else
-            start_day_key = {current_date, 0, 0};  // start of day
+            start_day_key = ref->m_bucket.getStartKey(current_bucket);
 
-          if (current_date == end_key.date) {
-            end_day_key = ref->m_end_key;
-            if (end_day_key.time == 0) {
+          if (current_bucket == end_bucket) {
+            end_day_key = end_key;
+            if (Time(end_day_key.date, end_day_key.time) == ref->m_bucket.getTime(end_bucket, 0)) {
               end_of_table = true;
               break;
             }
 
           } else {
-            end_day_key = {current_date, static_cast<int64_t>(Duration(1, 0, 0, 0, 0, -1)), INT64_MAX};  // end of day
+            end_day_key = ref->m_bucket.getEndKey(current_bucket);
           }
 
           ref->bindQueryParamsToCassStatement(cass_statement, start_day_key, end_day_key);
@@ -251,7 +377,7 @@ class Database {
         if (next_exist) {
           break;
         } else {
-          if (current_date == end_key.date) {
+          if (current_bucket == end_bucket) {
             end_of_table = true;
           }
           try_to_free_iterator();
@@ -276,7 +402,8 @@ class Database {
         end_key = ref->m_db_metadata->getMaxEntryKey();
       }
 
-      current_date = start_key.date;
+      current_bucket = ref->m_bucket.getBucket(start_key);
+      end_bucket = ref->m_bucket.getBucket(end_key);
       end_of_table = false;
       next_exist = false;
 
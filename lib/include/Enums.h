@@ -33,4 +33,6 @@ enum class tradeAlgo_t { BASICMARKET = 0, BASICLIMIT };
 
 enum class trade_algo_trigger_t { NEW_CANDLESTICK = 0, NEW_TICK, NEW_INTERVAL };
 
+enum class bucket_width_t { HOUR = 1, SIX_HOURS = 6, DAY = 24, WEEK = 168 };  // partition width of a table in hours
+
 #endif  // ENUMS_H
@@ -0,0 +1,88 @@
+//
+// Created by subhagato on 10/18/26.
+//
+
+#ifndef CRYPTOTRADER_EXISTENCEINDEX_H
+#define CRYPTOTRADER_EXISTENCEINDEX_H
+
+#include "DataTypes.h"
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#define EXISTENCE_INDEX_MAX_DAYS 8  // most recently used days of rows kept in memory
+
+/*******
+ *
+ * In memory index deciding if a row can be inserted without IF NOT EXISTS.
+ *
+ * A row is certainly new if it's outside [min_entry_key, max_entry_key] of the table metadata, or inside a
+ * discontinuity found by the last fixDatabase scan. A row is certainly present if it was written by this process.
+ * Everything else is ambiguous and needs a lightweight transaction.
+ *
+ * The metadata is re-read before each claimed batch, see Database::insertMultipleRowsToDatabase, so rows written by
+ * other processes up to their max entry key are ambiguous as well.
+ *
+ * Rows claimed as new are recorded immediately, so the same row sent twice (even from two threads) is only written
+ * and counted once. Rows are tracked per day, least recently used days are evicted together with their
+ * discontinuities.
+ */
+
+class ExistenceIndex {
+ private:
+  // (time, unique id) of a row, unique id is 0 for types without one. It's the unique id clustering column of the
+  // row, which isn't always the unique id of its primary key (0 for CoinAPITick)
+  typedef std::pair<int64_t, int64_t> row_id_t;
+
+  struct row_id_hash {
+    size_t operator()(const row_id_t& a_id) const {
+      return std::hash<int64_t>()(a_id.first) ^ (std::hash<int64_t>()(a_id.second) * 0x9e3779b97f4a7c15ULL);
+    }
+  };
+
+  typedef struct day_index_t {
+    std::unordered_set<row_id_t, row_id_hash> row_ids;
+    std::list<int32_t>::iterator lru_itr;  // position in m_lru_days
+  } day_index_t;
+
+  // rows known to be in the table, keyed by days since epoch
+  std::map<int32_t, day_index_t> m_days;
+
+  // days of m_days, most recently used first
+  std::list<int32_t> m_lru_days;
+
+  // (last key before, first key after) of ranges known to have no rows
+  std::vector<std::pair<primary_key_t, primary_key_t>> m_gaps;
+
+  size_t m_max_days;
+
+  mutable std::mutex m_mutex;
+
+  bool isInGap(const primary_key_t& a_key) const;
+
+  void addToDay(const primary_key_t& a_key, const int64_t a_unique_id);
+
+ public:
+  typedef enum existence_t { cNew = 0, cExists, cUnknown } existence_t;
+
+  ExistenceIndex(const size_t a_max_days = EXISTENCE_INDEX_MAX_DAYS) : m_max_days(a_max_days) {}
+
+  // classifies a row with primary key a_key and unique id a_unique_id against the metadata snapshot, rows found to be
+  // new are recorded as present
+  existence_t claim(const primary_key_t& a_key, const int64_t a_unique_id, const primary_key_t& a_min_key,
+                    const primary_key_t& a_max_key, const bool a_empty_table);
+
+  void insert(const primary_key_t& a_key, const int64_t a_unique_id);
+
+  // forgets a row claimed as new whose write failed
+  void erase(const primary_key_t& a_key, const int64_t a_unique_id);
+
+  void setGaps(const std::vector<std::pair<primary_key_t, primary_key_t>>& a_gaps);
+
+  void clear();
+};
+
+#endif  // CRYPTOTRADER_EXISTENCEINDEX_H
@@ -9,10 +9,14 @@
 //
 
 #include <cassandra.h>
+#include <atomic>
+#include <condition_variable>
 #include <iostream>
 #include <mutex>
+#include <set>
 
 class CassServer;
+class PartitionCache;
 
 // ASSERT: debug assert
 #ifdef DEBUG
@@ -71,6 +75,13 @@ GLOBAL(bool g_update_cass, false);
 GLOBAL(CassSession* g_cass_session, NULL);
 GLOBAL(CassServer* g_cass_server, NULL);
 GLOBAL(std::string g_cassandra_ip, "127.0.0.1");
+GLOBAL(std::string g_tick_store_dir, "");
+GLOBAL(bool g_shared_tables, false);  // symbols of a type share one table instead of a table per symbol
+GLOBAL(PartitionCache* g_partition_cache, NULL);  // local cache of immutable partitions, disabled if NULL
+GLOBAL(int64_t g_sparse_candle_sec, 0);  // candle periods up to this interval only store candles with ticks
+GLOBAL(size_t g_retention_ticks, 0);     // ticks kept in memory per history in real time, 0 keeps all
+GLOBAL(size_t g_retention_candles, 0);   // candles kept in memory per interval in real time, 0 keeps all
+GLOBAL(bool g_lazy_indicators, false);  // indicators are computed only when read, except the ones logged to CSV
 
 GLOBAL(bool g_random, true);
 GLOBAL(bool g_exiting, false);
@@ -79,4 +90,12 @@ GLOBAL(int g_order_idx, 0);
 
 GLOBAL_NOINIT(std::mutex g_critcal_task);
 
+// database writes issued but not yet counted in the metadata, changed under g_critcal_task and signalled when it drops
+GLOBAL_NOINIT(std::atomic<size_t> g_db_writes_in_flight);
+GLOBAL_NOINIT(std::condition_variable g_db_writes_drained);
+
+// tables (<key space>.<table>) created by this process, schema queries aren't repeated for them
+GLOBAL_NOINIT(std::set<std::string> g_created_tables);
+GLOBAL_NOINIT(std::mutex g_created_tables_mutex);
+
 // After adding a global variable here, it should be include in 'TraderBot::resetGlobals()' if required.
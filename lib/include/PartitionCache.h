@@ -0,0 +1,76 @@
+//
+// Created by subhagato on 10/18/26.
+//
+
+#ifndef CRYPTOTRADER_PARTITIONCACHE_H
+#define CRYPTOTRADER_PARTITIONCACHE_H
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+#define PARTITION_CACHE_MAX_MB 4096  // default size cap of the local partition cache
+
+/*******
+ *
+ * Local read-through cache of Cassandra partitions.
+ *
+ * <dir>/<hash of key>.part    length of key (uint32_t), key, encoded rows of the whole partition
+ *
+ * Files are content addressed by (table, version of the table, partition width, partition). Database only caches
+ * partitions before the consistent entry key of the table, which don't change anymore, and uses the generation of the
+ * table (incremented by repairs and deletes) as version, so partitions cached before another process repaired the
+ * table are misses. The key is stored in the file as well, so a hash collision is a miss. Least recently used files
+ * are evicted when the total size exceeds the cap, usage survives restarts through file modification times.
+ */
+
+class PartitionCache {
+ private:
+  typedef struct entry_t {
+    size_t bytes;
+    uint64_t last_used;
+  } entry_t;
+
+  std::string m_dir;
+  size_t m_max_bytes;
+  size_t m_total_bytes = 0;
+
+  // cached files, keyed by file name
+  std::map<std::string, entry_t> m_entries;
+  uint64_t m_use_count = 0;
+
+  mutable std::mutex m_mutex;
+
+  std::string getFilename(const std::string& a_key) const;
+
+  void evict();
+
+  void removeFile(const std::string& a_filename);
+
+ public:
+  PartitionCache(const std::string& a_dir, const size_t a_max_bytes = PARTITION_CACHE_MAX_MB * 1024ULL * 1024ULL);
+
+  PartitionCache(const PartitionCache&) = delete;
+  PartitionCache& operator=(const PartitionCache&) = delete;
+
+  static std::string sMakeKey(const std::string& a_table_name, const std::string& a_table_version,
+                              const int32_t a_bucket_hours, const int32_t a_bucket);
+
+  const std::string& getDir() const {
+    return m_dir;
+  }
+
+  size_t getNumBytes() const;
+
+  size_t getNumEntries() const;
+
+  // reads the rows of a partition, returns false on a miss
+  bool get(const std::string& a_key, std::string& a_rows);
+
+  void put(const std::string& a_key, const std::string& a_rows);
+
+  void erase(const std::string& a_key);
+};
+
+#endif  // CRYPTOTRADER_PARTITIONCACHE_H
@@ -88,9 +88,18 @@ class Tick {
     m_trade_id = static_cast<int64_t>(unique_id);
   };
 
-  void* getMemberPtr(size_t i);
+  // visits the columns of m_fields in the same order, used by the row codec in DbUtils
+  template <typename V>
+  inline void visitFields(V& visitor) {
+    visitor(m_price);
+    visitor(m_size);
+  }
 
-  void setMemberPtr(void* value, size_t i);
+  template <typename V>
+  inline void visitFields(V& visitor) const {
+    visitor(m_price);
+    visitor(m_size);
+  }
 
   friend std::ostream& operator<<(std::ostream& os, const Tick& tick) {
     os << std::setprecision(6) << std::fixed;
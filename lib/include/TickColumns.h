@@ -0,0 +1,221 @@
+//
+// Created by subhagato on 10/18/26.
+//
+
+#ifndef CRYPTOTRADER_TICKCOLUMNS_H
+#define CRYPTOTRADER_TICKCOLUMNS_H
+
+#include "Tick.h"
+#include "TickPeriod.h"
+#include "TickStore.h"
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <vector>
+
+#define TICK_COLUMNS_CHUNK_SIZE 4096  // rows per chunk, a multiple of 8 keeps every column 64 byte aligned
+
+/*******
+ *
+ * In memory, chunked, columnar (structure of arrays) storage of ticks.
+ *
+ * Rows live in fixed size chunks holding one 64 byte aligned array per column. Chunks are added at either end, so
+ * push_front and push_back never move rows which are already written and an index is resolved in O(1). Contiguous
+ * parts of the columns are handed out as tick_columns_t spans (same as a TickStore scan), so candle conversion and
+ * indicators can run tight, vectorizable loops over price, size and timestamp only.
+ *
+ * operator[] and the iterators materialize a Tick, with the read accessors of a TickPeriod, so code reading the ticks
+ * of getTickPeriod() (range for loops, begin() + idx, front/back, first and last timestamps and ids) compiles against
+ * a TickColumns as well. assign() is the adapter from a TickPeriod.
+ */
+
+class TickColumns {
+ private:
+  typedef struct chunk_t {
+    int64_t timestamp[TICK_COLUMNS_CHUNK_SIZE];
+    int64_t trade_id[TICK_COLUMNS_CHUNK_SIZE];
+    double price[TICK_COLUMNS_CHUNK_SIZE];
+    double size[TICK_COLUMNS_CHUNK_SIZE];
+  } chunk_t;
+
+  std::deque<chunk_t*> m_chunks;
+
+  // row of m_chunks.front() holding the first tick
+  size_t m_front_offset = 0;
+  size_t m_num_ticks = 0;
+
+  static chunk_t* sAllocateChunk();
+
+  inline void set(const size_t a_row, const Tick& a_tick) {
+    chunk_t* p_chunk = m_chunks[a_row / TICK_COLUMNS_CHUNK_SIZE];
+    const size_t offset = a_row % TICK_COLUMNS_CHUNK_SIZE;
+
+    p_chunk->timestamp[offset] = static_cast<int64_t>(a_tick.getTimeStamp());
+    p_chunk->trade_id[offset] = a_tick.getUniqueID();
+    p_chunk->price[offset] = a_tick.getPrice();
+    p_chunk->size[offset] = a_tick.getSize();
+  }
+
+ public:
+  TickColumns() = default;
+
+  TickColumns(const TickColumns&) = delete;
+  TickColumns& operator=(const TickColumns&) = delete;
+
+  ~TickColumns() {
+    clear();
+  }
+
+  // random access iterator over the rows, dereferencing materializes the Tick
+  class const_iterator : public std::iterator<std::random_access_iterator_tag, Tick, std::ptrdiff_t, void, Tick> {
+   private:
+    const TickColumns* mp_columns;
+    size_t m_idx;
+
+   public:
+    const_iterator(const TickColumns* ap_columns, const size_t a_idx) : mp_columns(ap_columns), m_idx(a_idx) {}
+
+    Tick operator*() const {
+      return (*mp_columns)[m_idx];
+    }
+    Tick operator[](const std::ptrdiff_t a_offset) const {
+      return (*mp_columns)[m_idx + a_offset];
+    }
+
+    const_iterator& operator++() {
+      m_idx++;
+      return *this;
+    }
+    const_iterator& operator--() {
+      m_idx--;
+      return *this;
+    }
+    const_iterator& operator+=(const std::ptrdiff_t a_offset) {
+      m_idx += a_offset;
+      return *this;
+    }
+    const_iterator& operator-=(const std::ptrdiff_t a_offset) {
+      m_idx -= a_offset;
+      return *this;
+    }
+
+    const_iterator operator+(const std::ptrdiff_t a_offset) const {
+      return const_iterator(mp_columns, m_idx + a_offset);
+    }
+    const_iterator operator-(const std::ptrdiff_t a_offset) const {
+      return const_iterator(mp_columns, m_idx - a_offset);
+    }
+    std::ptrdiff_t operator-(const const_iterator& rhs) const {
+      return static_cast<std::ptrdiff_t>(m_idx) - static_cast<std::ptrdiff_t>(rhs.m_idx);
+    }
+
+    bool operator==(const const_iterator& rhs) const {
+      return (m_idx == rhs.m_idx);
+    }
+    bool operator!=(const const_iterator& rhs) const {
+      return (m_idx != rhs.m_idx);
+    }
+    bool operator<(const const_iterator& rhs) const {
+      return (m_idx < rhs.m_idx);
+    }
+  };
+
+  size_t size() const {
+    return m_num_ticks;
+  }
+
+  bool empty() const {
+    return (m_num_ticks == 0);
+  }
+
+  inline void push_back(const Tick& a_tick) {
+    const size_t row = m_front_offset + m_num_ticks;
+
+    if (row == (m_chunks.size() * TICK_COLUMNS_CHUNK_SIZE)) m_chunks.push_back(sAllocateChunk());
+
+    set(row, a_tick);
+    m_num_ticks++;
+  }
+
+  inline void push_front(const Tick& a_tick) {
+    if (m_front_offset == 0) {
+      m_chunks.push_front(sAllocateChunk());
+      m_front_offset = TICK_COLUMNS_CHUNK_SIZE;
+    }
+
+    m_front_offset--;
+    set(m_front_offset, a_tick);
+    m_num_ticks++;
+  }
+
+  // replaces the content with the ticks of a TickPeriod, which can be a view
+  void assign(const TickPeriodT<Tick>& a_tick_period);
+
+  void pop_front();
+
+  void pop_back();
+
+  inline int64_t getTimestamp(const size_t a_idx) const {
+    const size_t row = m_front_offset + a_idx;
+    return m_chunks[row / TICK_COLUMNS_CHUNK_SIZE]->timestamp[row % TICK_COLUMNS_CHUNK_SIZE];
+  }
+
+  inline double getPrice(const size_t a_idx) const {
+    const size_t row = m_front_offset + a_idx;
+    return m_chunks[row / TICK_COLUMNS_CHUNK_SIZE]->price[row % TICK_COLUMNS_CHUNK_SIZE];
+  }
+
+  inline double getSize(const size_t a_idx) const {
+    const size_t row = m_front_offset + a_idx;
+    return m_chunks[row / TICK_COLUMNS_CHUNK_SIZE]->size[row % TICK_COLUMNS_CHUNK_SIZE];
+  }
+
+  inline Tick operator[](const size_t a_idx) const {
+    const size_t row = m_front_offset + a_idx;
+    const chunk_t* p_chunk = m_chunks[row / TICK_COLUMNS_CHUNK_SIZE];
+    const size_t offset = row % TICK_COLUMNS_CHUNK_SIZE;
+
+    return Tick(Time(p_chunk->timestamp[offset]), p_chunk->trade_id[offset], p_chunk->price[offset],
+                p_chunk->size[offset]);
+  }
+
+  Tick front() const {
+    return (*this)[0];
+  }
+
+  Tick back() const {
+    return (*this)[m_num_ticks - 1];
+  }
+
+  const_iterator begin() const {
+    return const_iterator(this, 0);
+  }
+
+  const_iterator end() const {
+    return const_iterator(this, m_num_ticks);
+  }
+
+  Time getFirstTimestamp() const {
+    return empty() ? Time() : Time(getTimestamp(0));
+  }
+
+  Time getLastTimestamp() const {
+    return empty() ? Time() : Time(getTimestamp(m_num_ticks - 1));
+  }
+
+  int64_t getFirstUniqueId() const {
+    return empty() ? 0 : m_chunks.front()->trade_id[m_front_offset];
+  }
+
+  int64_t getLastUniqueId() const {
+    const size_t row = m_front_offset + m_num_ticks - 1;
+    return empty() ? 0 : m_chunks[row / TICK_COLUMNS_CHUNK_SIZE]->trade_id[row % TICK_COLUMNS_CHUNK_SIZE];
+  }
+
+  // contiguous column spans covering ticks [a_start_idx, a_end_idx), returns the number of spans added
+  size_t getSpans(const size_t a_start_idx, const size_t a_end_idx, std::vector<tick_columns_t>& a_spans) const;
+
+  void clear();
+};
+
+#endif  // CRYPTOTRADER_TICKCOLUMNS_H
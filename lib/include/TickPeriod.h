@@ -8,12 +8,15 @@
 #include "utils/TimeUtils.h"
 #include <deque>
 #include <iostream>
+#include <stdexcept>
+#include <vector>
 
 class Tick;
 class CoinAPITick;
 class CMCandleStick;
 template <typename T>
 class Database;
+class TickStore;
 
 template <typename T>
 class TickPeriodT : public std::deque<T> {
@@ -27,8 +30,24 @@ class TickPeriodT : public std::deque<T> {
   typename std::deque<T>::iterator m_last_stored_itr;
   int m_num_saved = 0;
 
+  // ticks evicted from the front since the period was cleared
+  size_t m_num_evicted = 0;
+
+  // set when this period is a view of the ticks of another period, sharing its storage. m_view_end counts the ticks of
+  // the source in the view including the ones evicted from the source, so a view stays valid while its source evicts.
+  // The std::deque base of a view is empty, so a view is never passed on as a std::deque<T>& (asserted where periods
+  // are converted).
+  TickPeriodT<T>* mp_source = NULL;
+  size_t m_view_end = 0;
+
   void reset();
 
+  void detachView();
+
+  int advanceView(const T& t);
+
+  bool updateLoadedRange(const int num_loaded);
+
  public:
   TickPeriodT(bool consecutive = true);
 
@@ -37,6 +56,78 @@ class TickPeriodT : public std::deque<T> {
     m_last_tid = dummy_tid;
   }
 
+  typedef typename std::deque<T>::iterator iterator;
+  typedef typename std::deque<T>::const_iterator const_iterator;
+  typedef typename std::deque<T>::size_type size_type;
+
+  // accessors hide the ones of std::deque, so a view reads the ticks of its source up to its own size
+  size_type size() const {
+    if (!mp_source) return std::deque<T>::size();
+
+    return ((m_view_end > mp_source->m_num_evicted) ? (m_view_end - mp_source->m_num_evicted) : 0);
+  }
+
+  bool empty() const {
+    return (size() == 0);
+  }
+
+  iterator begin() {
+    return (mp_source ? mp_source->std::deque<T>::begin() : std::deque<T>::begin());
+  }
+
+  const_iterator begin() const {
+    return (mp_source ? const_iterator(mp_source->std::deque<T>::begin()) : std::deque<T>::begin());
+  }
+
+  iterator end() {
+    return (begin() + size());
+  }
+
+  const_iterator end() const {
+    return (begin() + size());
+  }
+
+  T& operator[](const size_type idx) {
+    return *(begin() + idx);
+  }
+
+  const T& operator[](const size_type idx) const {
+    return *(begin() + idx);
+  }
+
+  T& at(const size_type idx) {
+    if (idx >= size()) throw std::out_of_range("TickPeriodT::at");
+    return (*this)[idx];
+  }
+
+  const T& at(const size_type idx) const {
+    if (idx >= size()) throw std::out_of_range("TickPeriodT::at");
+    return (*this)[idx];
+  }
+
+  T& front() {
+    return *begin();
+  }
+
+  const T& front() const {
+    return *begin();
+  }
+
+  T& back() {
+    return *(end() - 1);
+  }
+
+  const T& back() const {
+    return *(end() - 1);
+  }
+
+  bool isView() const {
+    return (mp_source != NULL);
+  }
+
+  // turns this period into a view of the first a_num_ticks ticks of ap_source, later ticks are added with append()
+  void setView(TickPeriodT<T>* ap_source, const size_t a_num_ticks);
+
   Time getFirstTimestamp() const {
     return m_first_ts;
   }
@@ -61,12 +152,42 @@ class TickPeriodT : public std::deque<T> {
     return m_last_stored_itr;
   }
 
+  bool isConsecutive() const {
+    return m_consecutive;
+  }
+
+  // order of the ticks in a non consecutive period
+  static bool sIsBefore(const T& lhs, const T& rhs) {
+    return ((lhs.getTimeStamp() < rhs.getTimeStamp()) ||
+            ((lhs.getTimeStamp() == rhs.getTimeStamp()) && (lhs.getUniqueID() < rhs.getUniqueID())));
+  }
+
   int append(T& t, FILE* ap_csv_file = NULL);
 
+  // merges out of order ticks of a non consecutive period in one pass, returns the number of ticks added
+  int merge(std::vector<T>& a_ticks);
+
+  // removes the oldest a_num_ticks ticks, which are kept in the database or the tick store. A view doesn't own its
+  // ticks, they are evicted through its source. Returns the number of ticks evicted.
+  size_t evictFront(const size_t a_num_ticks);
+
+  size_t getNumEvicted() const {
+    return m_num_evicted;
+  }
+
   int storeToDatabase(Database<T>* db);
 
   bool loadFromDatabase(Database<T>* db, Time start_time, Time end_time);
 
+  bool loadFromDatabase(TickStore* store, Time start_time, Time end_time);
+
+  // ticks before store_end_time from the tick store, the later ones from db (today's ticks aren't in the store)
+  bool loadFromDatabase(TickStore* store, Database<T>* db, Time start_time, Time store_end_time, Time end_time);
+
+  // loads tick_periods[i] from dbs[i] with a single multi-symbol query pass
+  static bool sLoadFromDatabase(const std::vector<Database<T>*>& dbs, const std::vector<TickPeriodT<T>*>& tick_periods,
+                                Time start_time, Time end_time);
+
   void saveToCSV(FILE* a_csv_file);
 
   void clear();
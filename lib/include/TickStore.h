@@ -0,0 +1,122 @@
+//
+// Created by subhagato on 10/17/26.
+//
+
+#ifndef CRYPTOTRADER_TICKSTORE_H
+#define CRYPTOTRADER_TICKSTORE_H
+
+#include "utils/TimeUtils.h"
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*******
+ *
+ * Local, append-only, memory mapped columnar store for ticks.
+ *
+ * <root_dir>/<table_name>/<date>.timestamp   int64_t micros since epoch
+ * <root_dir>/<table_name>/<date>.trade_id    int64_t
+ * <root_dir>/<table_name>/<date>.price       double
+ * <root_dir>/<table_name>/<date>.size        double
+ *
+ * <root_dir>/<table_name>/generation        generation of the table the segments were copied from
+ *
+ * One segment (4 column files) per day. Rows inside a segment are sorted by (timestamp, trade_id), so range scans are
+ * binary searches on the mapped timestamp column and don't need any deserialization. Segments (empty days included)
+ * copied from another generation of the table are dropped, see dbMetadata::getGeneration.
+ */
+
+class Tick;
+
+// columns of one day segment (or a part of it), pointing directly into the mapped files
+typedef struct tick_columns_t {
+  const int64_t* timestamp;
+  const int64_t* trade_id;
+  const double* price;
+  const double* size;
+  size_t num_ticks;
+} tick_columns_t;
+
+class TickStore {
+ private:
+  enum column_t { cTimestamp = 0, cTradeId, cPrice, cSize, cNumColumns };
+
+  typedef struct segment_t {
+    void* columns[cNumColumns];
+    size_t mapped_bytes[cNumColumns];
+    size_t num_ticks;
+  } segment_t;
+
+  std::string m_dir;
+
+  // mapped segments, keyed by days since epoch
+  std::map<int32_t, segment_t> m_segments;
+
+  mutable std::mutex m_segment_mutex;
+
+  static const char* s_column_names[cNumColumns];
+
+  std::string getColumnFilename(const int32_t a_date, const column_t a_column) const;
+
+  std::string getGenerationFilename() const {
+    return m_dir + "/generation";
+  }
+
+  const segment_t* mapSegment(const int32_t a_date);
+
+  void unmapSegment(const int32_t a_date);
+
+  // scan with m_segment_mutex held by the caller
+  size_t scanLocked(const Time a_start_time, const Time a_end_time, std::vector<tick_columns_t>& a_ranges);
+
+  // writes all columns or, on a failure, none of them
+  size_t appendToSegment(const int32_t a_date, const std::vector<int64_t>& a_timestamps,
+                         const std::vector<int64_t>& a_trade_ids, const std::vector<double>& a_prices,
+                         const std::vector<double>& a_sizes);
+
+ public:
+  TickStore(const std::string& a_root_dir, const std::string& a_table_name);
+
+  ~TickStore();
+
+  TickStore(const TickStore&) = delete;
+  TickStore& operator=(const TickStore&) = delete;
+
+  const std::string& getDir() const {
+    return m_dir;
+  }
+
+  // -1 if no segment was copied yet
+  int64_t getGeneration() const;
+
+  // drops all segments if they were copied from another generation of the table
+  void setGeneration(const int64_t a_generation);
+
+  // true for the days appended so far, the ones added as empty included
+  bool hasSegment(const int32_t a_date) const;
+
+  // records a day without ticks, so it isn't looked up again
+  void addEmptyDay(const int32_t a_date);
+
+  // appends ticks sorted by time, ticks older than the last stored tick of their day are skipped
+  size_t append(std::deque<Tick>::const_iterator a_start_itr, std::deque<Tick>::const_iterator a_end_itr);
+
+  size_t append(const std::deque<Tick>& a_ticks) {
+    return append(a_ticks.begin(), a_ticks.end());
+  }
+
+  // collects columns of all ticks in [a_start_time, a_end_time), one entry per day.
+  // Pointers stay valid till the next append to the same day or destruction of the store.
+  size_t scan(const Time a_start_time, const Time a_end_time, std::vector<tick_columns_t>& a_ranges);
+
+  template <typename T>
+  int loadData(std::deque<T>& a_data, const Time a_start_time, const Time a_end_time);
+};
+
+// only Tick has the columnar layout, other types return -1
+template <>
+int TickStore::loadData(std::deque<Tick>& a_data, const Time a_start_time, const Time a_end_time);
+
+#endif  // CRYPTOTRADER_TICKSTORE_H
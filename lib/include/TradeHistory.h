@@ -7,7 +7,9 @@
 
 #include "CurrencyPair.h"
 #include "Enums.h"
+#include "indicators/ContinuousIndicator.h"
 #include "indicators/DiscreteIndicator.h"
+#include "utils/SeqLock.h"
 #include "utils/TimeUtils.h"
 
 #include <iostream>
@@ -20,6 +22,7 @@ class CoinAPITick;
 class Candlestick;
 template <typename T>
 class Database;
+class TickStore;
 template <typename T>
 class TickPeriodT;
 template <typename C, typename T>
@@ -27,6 +30,24 @@ class CandlePeriodT;
 template <typename C, typename T>
 class DiscreteIndicatorA;
 
+#define TRADE_REORDER_WINDOW_SIZE 64    // late ticks of a non consecutive history merged together
+#define TRADE_REORDER_WINDOW_MSEC 1000  // or once the oldest of them waited this long
+#define TRADE_RETENTION_SLACK_DIV 8    // a limit is enforced once it's exceeded by 1/8th, evicting in batches
+#define TRADE_SNAPSHOT_NUM_CANDLES 4   // last candles of every interval published to readers
+
+// data kept in memory by a history which runs for long, older data is left to the database (or the tick store)
+typedef struct retention_t {
+  size_t max_ticks;    // 0 keeps all ticks
+  size_t max_candles;  // per interval, also the number of values kept per indicator, 0 keeps all
+} retention_t;
+
+// last candles of an interval as of the last appended tick, read by trading algos without locking the history
+typedef struct candle_snapshot_t {
+  int64_t num_candles = 0;  // candles built so far, evicted ones included
+  int64_t num_recent = 0;   // valid entries of recent_candles
+  Candlestick recent_candles[TRADE_SNAPSHOT_NUM_CANDLES];  // the last candle (still being built) first
+} candle_snapshot_t;
+
 template <typename T>
 class TradeHistoryT {
  private:
@@ -37,13 +58,36 @@ class TradeHistoryT {
 
   // candle sticks dependent data structures
   std::map<Duration, CandlePeriodT<Candlestick, T>*> m_candle_periods;
-  std::map<Duration, DiscreteIndicatorA<Candlestick, T>*> m_indicators;
+  // several indicators of an interval are fed in the order they are added
+  std::multimap<Duration, DiscreteIndicatorA<Candlestick, T>*> m_indicators;
+  // updated with every tick added at the end
+  std::vector<ContinuousIndicatorA<T>*> m_continuous_indicators;
   std::map<Duration, FILE*> m_logs;
 
+  // published after every change of the candles, entries are added with the candle periods before trading starts
+  std::map<Duration, SeqLock<candle_snapshot_t>> m_candle_snapshots;
+
   Database<T>* m_db;
 
+  // local columnar tick store, used instead of m_db for loading when enabled
+  TickStore* m_tick_store;
+
+  // ticks of a non consecutive history which arrived after a later one, waiting to be merged
+  std::vector<T> m_reorder_window;
+  Time m_reorder_window_start;  // arrival of the oldest tick of the window
+
+  // earliest late tick merged into the candles since the last notification, Time::sMax() if none
+  Time m_candles_updated_from;
+
+  retention_t m_retention;
+
   bool m_ongoing_trading;
 
+  // controller notifications and the new ticks they carried, counted on the appending thread
+  size_t m_num_callbacks;
+  size_t m_num_callback_ticks;
+  size_t m_num_candle_updates;
+
   // mutex
   mutable std::mutex m_new_tick;
 
@@ -53,7 +97,37 @@ class TradeHistoryT {
 
   void saveStatsInCSV(const Duration a_interval) const;
 
-  void controllerCallBack() const;
+  // notifies the controller once for a_num_new_ticks ticks added at the end
+  void controllerCallBack(const size_t a_num_new_ticks = 1);
+
+  // notifies the controller that the candles from a_from on were rewritten with late ticks
+  void candleUpdateCallBack(const Time a_from);
+
+  // returns m_candles_updated_from and resets it, with the locks held
+  Time takeCandlesUpdatedFrom();
+
+  // appends a tick with the locks held, returns 1 if it's added at the end, 0 if it's buffered or already exists
+  // and -1 if it can't be added
+  int appendTradeLocked(T& t);
+
+  void loadTicks(const Time a_start_time, const Time a_end_time);
+
+  void mergeReorderWindow();
+
+  // converts the ticks to the candles of all intervals in one go
+  void convertTicksToCandles();
+
+  // publishes the last candles of an interval (of all intervals by default) to the readers of the snapshots
+  void publishCandles(const Duration a_interval);
+  void publishCandles();
+
+  CandlePeriodT<Candlestick, T>* newCandlePeriod(const Duration a_interval) const;
+
+  // evicts the oldest ticks, candles and indicator values beyond the retention limits
+  void enforceRetention();
+
+  // copies the oldest a_num_ticks ticks to the tick store (if it's enabled) before they're evicted
+  void spillTicks(const size_t a_num_ticks);
 
  public:
   TradeHistoryT(
@@ -81,21 +155,48 @@ class TradeHistoryT {
 
   bool appendTrade(T& t);
 
+  // appends a batch of ticks taking the locks once, the controller is notified once for all the new ticks
   bool appendTrades(TickPeriodT<T>& tick_period);
 
+  // merges the late ticks waiting in the reorder window into the tick period and the candles they belong to
+  void flushReorderWindow();
+
+  // rebuilds the candles from a_from on with the current ticks, for a view whose source merged late ticks
+  void updateCandles(const Time a_from);
+
+  // limits the data kept in memory, older data is evicted as new ticks arrive
+  void setRetention(const retention_t& a_retention);
+
+  retention_t getRetention() const {
+    return m_retention;
+  }
+
   bool loadFromDatabase(Time start_time = Time(0),
                         Time end_time = Time::sNow());  // by default it will load all data from database
 
+  // loads several histories of the same time range together, symbols of a shared table are fetched in one pass
+  static bool sLoadFromDatabase(const std::vector<TradeHistoryT<T>*>& a_histories, Time start_time = Time(0),
+                                Time end_time = Time::sNow());
+
+  // shares the ticks of ap_full_history before a_end_time instead of loading or copying them, the ticks after are
+  // added one by one with appendTrade, which advances the candle periods and indicators of this history only
+  void setViewOf(TradeHistoryT<T>* ap_full_history, const Time a_end_time = Time::sMax());
+
+  // the candle snapshots are read without a lock, candle periods are only added before the history is shared
   void addCandlePeriod(Duration interval);
 
   void addCandlePeriod(const std::set<Duration>& a_intervals);
 
   bool addIndicator(Duration interval, DiscreteIndicatorA<Candlestick, T>* indicator);
 
+  // the indicator is constructed from the ticks so far
+  void addContinuousIndicator(ContinuousIndicatorA<T>* indicator);
+
   TickPeriodT<T>* getTickPeriod() const {
     return m_tick_period;
   }
 
+  // number of candles built so far, including the ones evicted by the retention limits, read without locking
   void populateNumCandles(std::map<Duration, int>& nunCandlesHash) const;
   int getNumCandles(Duration interval) const;
 
@@ -115,11 +216,23 @@ class TradeHistoryT {
 
   std::string getFullSymbolStr(bool lower = false) const;
 
+  size_t getNumCallBacks() const {
+    return m_num_callbacks;
+  }
+  size_t getNumCallBackTicks() const {
+    return m_num_callback_ticks;
+  }
+  size_t getNumCandleUpdates() const {
+    return m_num_candle_updates;
+  }
+
   void setOngoingTrading(const bool ongoing_trading) {
     m_ongoing_trading = ongoing_trading;
   }
 
   Candlestick getCandleFromBegin(Duration interval, const int candle_idx = 0) const;
+
+  // the last TRADE_SNAPSHOT_NUM_CANDLES candles are read from the snapshot without locking, older ones with the lock
   Candlestick getCandleFromEnd(Duration interval, const int candle_idx = 0) const;
   Candlestick getLastCandle(Duration interval, const Time a_cur_time, const int a_idx_from_back = 0) const;
 
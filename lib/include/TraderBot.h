@@ -105,6 +105,8 @@ class TraderBot {
   bool m_capture_gemini_update;
   bool m_update_coinapi;
   bool m_fix_database;
+  std::string m_migrated_table;
+  bucket_width_t m_migrated_bucket_width;
   bool m_enable_gemini;
   int m_user_id;
   std::string m_csv_database_dir;
@@ -148,6 +150,10 @@ class TraderBot {
   void fixDatabase() {
     m_fix_database = true;
   }
+  void migrateTable(const std::string& a_table_name, const bucket_width_t a_bucket_width) {
+    m_migrated_table = a_table_name;
+    m_migrated_bucket_width = a_bucket_width;
+  }
   void enableGeminiEx() {
     m_enable_gemini = true;
   }
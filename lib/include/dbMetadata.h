@@ -31,6 +31,10 @@ class dbMetadata {
 
   std::string m_table_type;
 
+  int32_t m_bucket_hours;  // partition width, 0 (not set) for tables created with day partitions only
+
+  int64_t m_generation;  // incremented when rows up to the consistent entry key change, versions cached partitions
+
   bool getMetadata() {
     CassFuture* future;
     CassStatement* cass_statement;
@@ -106,6 +110,8 @@ class dbMetadata {
 
         DbUtils::cass_value_get_type(cass_row, "num_entries", "bigint", &m_num_entries);
         DbUtils::cass_value_get_type(cass_row, "type", "ascii", &m_table_type);
+        DbUtils::cass_value_get_type(cass_row, "bucket_hours", "int", &m_bucket_hours);
+        DbUtils::cass_value_get_type(cass_row, "generation", "bigint", &m_generation);
 
         cass_iterator_free(oldest_entry_tuple_iterator);
         cass_iterator_free(min_entry_tuple_iterator);
@@ -125,6 +131,42 @@ class dbMetadata {
     return found;
   }
 
+  // creates the metadata table of a key space once per process, tables created before bucketing was configurable get
+  // the bucket_hours and generation columns added
+  static void sCreateMetadataTable(const std::string& key_space) {
+    std::lock_guard<std::mutex> lock(g_created_tables_mutex);
+    if (!g_created_tables.insert(key_space + ".metadata").second) return;
+
+    std::stringstream query;
+
+    query << "CREATE TABLE IF NOT EXISTS " << key_space << ".metadata (table_name ascii, "
+                                                           "oldest_entry tuple<int,bigint,bigint>, "
+                                                           "min_entry tuple<int,bigint,bigint>, "
+                                                           "max_entry tuple<int,bigint,bigint>, "
+                                                           "num_entries bigint, "
+                                                           "consistent_till tuple<int,bigint,bigint>, "
+                                                           "type ascii, "
+                                                           "bucket_hours int, "
+                                                           "generation bigint, "
+                                                           "PRIMARY KEY (table_name))";
+
+    // create table if it doesn't exists
+    CassServer::executeQuery(g_cass_session, query.str().c_str(), false);
+
+    // fail if the columns exist
+    const std::string alter_query = "ALTER TABLE " + key_space + ".metadata ADD bucket_hours int";
+    CassServer::executeQuery(g_cass_session, alter_query.c_str(), false);
+
+    const std::string alter_generation_query = "ALTER TABLE " + key_space + ".metadata ADD generation bigint";
+    CassServer::executeQuery(g_cass_session, alter_generation_query.c_str(), false);
+  }
+
+  // reads the row of an existing table only, see sGetType
+  dbMetadata(const std::string& key_space, const std::string& table_name)
+      : m_key_space(key_space), m_table_name(table_name), m_num_entries(0), m_bucket_hours(0), m_generation(0) {
+    getMetadata();
+  }
+
   bool setMetadata() {
     if (!g_update_cass) return false;
 
@@ -144,6 +186,8 @@ class dbMetadata {
 
     query << ", num_entries = " << m_num_entries;
     query << ", type = '" << m_table_type << "'";
+    query << ", bucket_hours = " << m_bucket_hours;
+    query << ", generation = " << m_generation;
 
     query << " WHERE table_name = '" << m_table_name << "'";
     statement = query.str();
@@ -158,23 +202,16 @@ class dbMetadata {
  public:
   static const int32_t kInitDate = 14600;
 
-  dbMetadata(std::string key_space, std::string table_name, std::string table_type)
-      : m_key_space(key_space), m_table_name(table_name), m_table_type(table_type) {
+  // a_bucket_width is used only if the table doesn't have metadata yet
+  dbMetadata(std::string key_space, std::string table_name, std::string table_type,
+             bucket_width_t a_bucket_width = bucket_width_t::DAY)
+      : m_key_space(key_space),
+        m_table_name(table_name),
+        m_table_type(table_type),
+        m_bucket_hours(0),
+        m_generation(0) {
     if (g_update_cass) {
-      std::stringstream query;
-
-      query << "CREATE TABLE IF NOT EXISTS " << key_space << ".metadata (table_name ascii, "
-                                                             "oldest_entry tuple<int,bigint,bigint>, "
-                                                             "min_entry tuple<int,bigint,bigint>, "
-                                                             "max_entry tuple<int,bigint,bigint>, "
-                                                             "num_entries bigint, "
-                                                             "consistent_till tuple<int,bigint,bigint>, "
-                                                             "type ascii, "
-                                                             "PRIMARY KEY (table_name))";
-
-      // create table if it doesn't exists
-      CassServer::executeQuery(g_cass_session, query.str().c_str(), false);
-
+      sCreateMetadataTable(key_space);
     } else {
       // WARNING<<"Cassandra Database will be not updated\n";
     }
@@ -185,10 +222,17 @@ class dbMetadata {
       m_max_entry_key = {0, 0, 0};
       m_cons_entry_key = {0, 0, 0};
       m_num_entries = 0;
+      m_bucket_hours = static_cast<int32_t>(a_bucket_width);
       setMetadata();
     }
   }
 
+  // type of an existing table, empty if the table has no metadata. Unlike the constructor it doesn't add a row for a
+  // missing table.
+  static std::string sGetType(const std::string& key_space, const std::string& table_name) {
+    return dbMetadata(key_space, table_name).getType();
+  }
+
   const std::string& getTableName() const {
     return m_table_name;
   }
@@ -297,6 +341,20 @@ class dbMetadata {
     setMetadata();
   }
 
+  int64_t getGeneration() const {
+    return m_generation;
+  }
+
+  // rows up to the consistent entry key were repaired, written or deleted
+  void incrementGeneration() {
+    m_generation++;
+    setMetadata();
+  }
+
+  bucket_width_t getBucketWidth() const {
+    return m_bucket_hours ? static_cast<bucket_width_t>(m_bucket_hours) : bucket_width_t::DAY;
+  }
+
   const std::string& getType() const {
     return m_table_type;
   }
@@ -310,7 +368,9 @@ class dbMetadata {
     os << "min_entry_key        = " << m.m_min_entry_key << std::endl;
     os << "max_entry_key        = " << m.m_max_entry_key << std::endl;
     os << "consistent_entry_key = " << m.m_cons_entry_key << std::endl;
-    os << "num_entries          = " << m.m_num_entries;
+    os << "num_entries          = " << m.m_num_entries << std::endl;
+    os << "bucket_hours         = " << static_cast<int32_t>(m.getBucketWidth()) << std::endl;
+    os << "generation           = " << m.m_generation;
 
     return os;
   }
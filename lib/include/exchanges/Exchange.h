@@ -159,6 +159,10 @@ class Exchange {
   exchange_t getExchangeID() const {
     return m_id;
   }
+
+  bool isConsecutive() const {
+    return m_consecutive;
+  }
   exchange_mode_t getMode() const {
     return m_mode;
   }
@@ -0,0 +1,45 @@
+//
+// Created by subhagato on 10/18/26.
+//
+
+#pragma once
+
+#include "DiscreteIndicator.h"
+#include "RollingWindow.h"
+#include <algorithm>
+#include <deque>
+
+typedef struct channel_t {
+  double channel_low;   // lowest low of the period
+  double channel_high;  // highest high of the period
+} channel_t;
+
+// price channel (Donchian) of the last period candles
+class CHANNEL {
+ public:
+  std::deque<channel_t> m_values;
+  RollingMin m_low;
+  RollingMax m_high;
+  int m_period;
+
+  CHANNEL(int period) : m_low(period), m_high(period), m_period(period) {}
+
+  void append(const Candlestick& candle) {
+    m_low.push(candle.getLow());
+    m_high.push(candle.getHigh());
+    m_values.push_back({m_low.value(), m_high.value()});
+  }
+
+  // once the window only holds the flat candle the channel stays at its range
+  void appendRun(const Candlestick& candle, const size_t a_count) {
+    const size_t num_appended = std::min(a_count, static_cast<size_t>(m_period));
+
+    for (size_t i = 0; i < num_appended; i++) append(candle);
+
+    if (num_appended < a_count) m_values.insert(m_values.end(), a_count - num_appended, m_values.back());
+  }
+
+  static field_t getFields() {
+    return {{"CHANNEL-low", "double"}, {"CHANNEL-high", "double"}};
+  };
+};
@@ -0,0 +1,55 @@
+//
+// Created by subhagato on 10/18/26.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Candlestick.h"
+#include "Enums.h"
+
+/*******
+ *
+ * Batch warm up of indicators over all the candles of a CandlePeriod in one go. The candles are converted once to
+ * columns, every indicator reads the column of its price in one pass, then continues from the final state candle by
+ * candle.
+ */
+
+// prices and volume of a sequence of candles, one contiguous column each
+typedef struct candle_columns_t {
+  std::vector<double> open;
+  std::vector<double> close;
+  std::vector<double> low;
+  std::vector<double> high;
+  std::vector<double> mean;
+  std::vector<double> volume;  // total volume
+
+  template <typename InputIt>
+  candle_columns_t(InputIt a_begin, InputIt a_end) {
+    const size_t num_candles = static_cast<size_t>(std::distance(a_begin, a_end));
+
+    for (auto p_column : {&open, &close, &low, &high, &mean, &volume}) p_column->reserve(num_candles);
+
+    for (auto itr = a_begin; itr != a_end; ++itr) {
+      open.push_back(itr->getOpen());
+      close.push_back(itr->getClose());
+      low.push_back(itr->getLow());
+      high.push_back(itr->getHigh());
+      mean.push_back(itr->getMean());
+      volume.push_back(itr->getTotalVolume());
+    }
+  }
+
+  size_t size() const {
+    return open.size();
+  }
+
+  // column of a price, same as Candlestick::get
+  const std::vector<double>& get(const candle_price_t a_price) const;
+
+  // volumes clamped to 1e-9 and their products with a price, computed as MA::append does so the results are identical
+  void getWeightedVolumes(const candle_price_t a_price, std::vector<double>& a_volumes,
+                          std::vector<double>& a_products) const;
+} candle_columns_t;
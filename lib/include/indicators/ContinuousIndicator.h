@@ -0,0 +1,121 @@
+//
+// Created by subhagato on 10/18/26.
+//
+
+#pragma once
+
+#include <tuple>
+#include <type_traits>
+
+#include "CurrencyPair.h"
+#include "Enums.h"
+#include "TickPeriod.h"
+#include "utils/SeqLock.h"
+#include "utils/TimeUtils.h"
+
+#include "TickIndicators.h"
+
+/*******
+ *
+ * Indicators updated with every tick added to the end of a trade history, before the controller is notified of it, so
+ * a TickTrigger sees values including the tick. Unlike DiscreteIndicatorT only the current value of an indicator is
+ * kept, an update doesn't allocate and costs O(1). Late ticks merged from the reorder window aren't added.
+ */
+
+template <typename T = Tick>
+class ContinuousIndicatorA {  // abstract class for pointers
+ protected:
+  const exchange_t m_exchange_id;
+  const CurrencyPair m_currency_pair;
+
+ public:
+  explicit ContinuousIndicatorA(const exchange_t exchange_id, const CurrencyPair& currency_pair)
+      : m_exchange_id(exchange_id), m_currency_pair(currency_pair) {}
+  virtual ~ContinuousIndicatorA() {}
+
+  exchange_t getExchangeId() const {
+    return m_exchange_id;
+  }
+  const CurrencyPair& getCurrencyPair() const {
+    return m_currency_pair;
+  }
+
+  virtual void append(const T& tick) = 0;
+  // adds all the ticks of the period, later ticks are added by the trade history
+  virtual void constructFrom(const TickPeriodT<T>& tick_period) = 0;
+  virtual Time getLastTimeStamp() const = 0;
+};
+
+template <typename T = Tick, typename... Is>
+class ContinuousIndicatorT : public ContinuousIndicatorA<T> {
+ private:
+  Time m_last_tick_timestamp;
+  size_t m_num_ticks;
+
+  std::tuple<Is...> m_indicator_list;
+
+  // value of every indicator, published after each tick for readers on other threads
+  std::tuple<SeqLock<typename std::decay<decltype(Is::m_value)>::type>...> m_last_values;
+
+  template <std::size_t I = 0>
+  inline typename std::enable_if<I == sizeof...(Is), void>::type individualAppend(const T& tick) {}
+
+  template <std::size_t I = 0>
+      inline typename std::enable_if < I<sizeof...(Is), void>::type individualAppend(const T& tick) {
+    std::get<I>(m_indicator_list).append(tick);
+    individualAppend<I + 1>(tick);
+  }
+
+  template <std::size_t I = 0>
+  inline typename std::enable_if<I == sizeof...(Is), void>::type individualPublish() {}
+
+  template <std::size_t I = 0>
+      inline typename std::enable_if < I<sizeof...(Is), void>::type individualPublish() {
+    std::get<I>(m_last_values).store(std::get<I>(m_indicator_list).m_value);
+    individualPublish<I + 1>();
+  }
+
+ public:
+  explicit ContinuousIndicatorT(const exchange_t exchange_id, const CurrencyPair& currency_pair, Is... args)
+      : ContinuousIndicatorA<T>(exchange_id, currency_pair), m_num_ticks(0), m_indicator_list{std::move(args)...} {}
+
+  void append(const T& tick) {
+    individualAppend(tick);
+    m_last_tick_timestamp = tick.getTimeStamp();
+    m_num_ticks++;
+
+    individualPublish();
+  }
+
+  void constructFrom(const TickPeriodT<T>& tick_period) {
+    for (auto& tick : tick_period) append(tick);
+  }
+
+  template <std::size_t I>
+  auto getIndicator() -> decltype(std::get<I>(m_indicator_list))& {
+    return std::get<I>(m_indicator_list);
+  }
+
+  // value of indicator I, on the thread appending the ticks (e.g. in a trade decision of a TickTrigger)
+  template <std::size_t I>
+  auto getValue() const -> typename std::decay<decltype(std::get<I>(m_indicator_list).m_value)>::type {
+    return std::get<I>(m_indicator_list).m_value;
+  }
+
+  // value of indicator I, safe to read while ticks are appended
+  template <std::size_t I>
+  auto getLastValue() const -> typename std::decay<decltype(std::get<I>(m_indicator_list).m_value)>::type {
+    return std::get<I>(m_last_values).load();
+  }
+
+  Time getLastTimeStamp() const {
+    return m_last_tick_timestamp;
+  }
+
+  size_t getNumTicks() const {
+    return m_num_ticks;
+  }
+};
+
+template <typename... Is>
+using ContinuousIndicator = ContinuousIndicatorT<Tick, Is...>;
@@ -0,0 +1,86 @@
+//
+// Created by subhagato on 10/18/26.
+//
+
+#pragma once
+
+#include "DiscreteIndicator.h"
+#include <Candlestick.h>
+#include <Enums.h>
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <ta-lib/ta_func.h>
+
+/*******
+ *
+ * MACD of two EMA indicators computed elsewhere, e.g. the shared nodes of an IndicatorRegistry, so the EMAs aren't
+ * computed again for it. Only the signal line has a state of its own.
+ *
+ * The EMAs of the same candle are read by time, the EMA indicators have to be fed the same candles first. Unlike
+ * MACD, whose fast EMA starts later than the slow one, both EMAs start at the first candle, so the values differ from
+ * MACD during the warm up.
+ */
+
+class DerivedMACD {
+ public:
+  std::deque<macd_t> m_values;
+  std::shared_ptr<ema_state_t> m_signal_state;
+
+  DerivedMACD(DiscreteIndicator<EMA>* ap_fast_ema, DiscreteIndicator<EMA>* ap_slow_ema, int fast_period,
+              int slow_period, int signal_period)
+      : mp_fast_ema(ap_fast_ema),
+        mp_slow_ema(ap_slow_ema),
+        m_num_warm_up(static_cast<size_t>(std::max(fast_period, slow_period))),
+        m_signal_period(static_cast<size_t>(signal_period)) {
+    ema_state_t* state_ptr;
+    TA_EMA_StateInit(&state_ptr, signal_period);
+    m_signal_state.reset(state_ptr, [](struct TA_EMA_State* ptr) { TA_EMA_StateFree(&ptr); });
+  }
+
+  void append(const Candlestick& candle) {
+    appendAt(candle.getTimeStamp());
+  }
+
+  // the EMAs of a run of flat candles aren't flat till they converge, they are read candle by candle
+  void appendRun(const Candlestick& candle, const size_t a_count) {
+    const Duration interval = mp_slow_ema->getInterval();
+
+    for (size_t i = 0; i < a_count; i++)
+      appendAt(candle.getTimeStamp() + Duration(interval.getDuration() * static_cast<int64_t>(i)));
+  }
+
+  static field_t getFields() {
+    return MACD::getFields();
+  };
+
+ private:
+  DiscreteIndicator<EMA>* mp_fast_ema;
+  DiscreteIndicator<EMA>* mp_slow_ema;
+
+  size_t m_num_appended = 0;
+  size_t m_num_warm_up;  // candles before both the EMAs are valid
+  size_t m_signal_period;
+
+  void appendAt(const Time a_timestamp) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    m_num_appended++;
+
+    if (m_num_appended < m_num_warm_up) {
+      m_values.push_back({nan, nan, nan});
+      return;
+    }
+
+    const double macd =
+        mp_fast_ema->getIndicatorAtTime<0>(a_timestamp).ema - mp_slow_ema->getIndicatorAtTime<0>(a_timestamp).ema;
+
+    double macd_signal;
+    TA_EMA_State(m_signal_state.get(), macd, &macd_signal);
+
+    if (m_num_appended < m_num_warm_up + m_signal_period - 1)
+      m_values.push_back({macd, nan, nan});
+    else
+      m_values.push_back({macd, macd_signal, macd - macd_signal});
+  }
+};
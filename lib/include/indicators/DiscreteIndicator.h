@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <queue>
 #include <tuple>
@@ -19,14 +20,20 @@
 #include <ta-lib/ta_func.h>
 #include <utils/dbUtils.h>
 
+#include "CHANNEL.h"
 #include "EMA.h"
 #include "MA.h"
 #include "MACD.h"
+#include "QUANTILE.h"
 #include "RSI.h"
 #include "SMA.h"
 #include "STDDEV.h"
 #include "TEMA.h"
+#include "VARIANCE.h"
+#include "VWAP.h"
 
+#include "CandleColumns.h"
+#include "utils/SeqLock.h"
 #include "utils/TimeUtils.h"
 
 template <typename C = Candlestick, typename T = Tick>
@@ -36,6 +43,11 @@ class DiscreteIndicatorA {  // abstract class for pointers
   const CurrencyPair m_currency_pair;
   Duration m_interval;
 
+  Time m_end_time;      // candles starting before it are mature, the values of a lazy indicator may lag behind
+  // catches up only when the values are read, which changes the indicator, so a lazy indicator is read only on the
+  // thread appending to its trade history
+  bool m_lazy = false;
+
  public:
   explicit DiscreteIndicatorA(const exchange_t exchange_id, const CurrencyPair& currency_pair, const Duration interval)
       : m_exchange_id(exchange_id), m_currency_pair(currency_pair), m_interval(interval) {}
@@ -51,8 +63,30 @@ class DiscreteIndicatorA {  // abstract class for pointers
     return m_interval;
   }
 
+  bool isLazy() const {
+    return m_lazy;
+  }
+
+  void setLazy(const bool a_lazy) {
+    m_lazy = a_lazy;
+    if (!m_lazy) catchUp();
+  }
+
+  // candles of the period the indicator was constructed from are mature till a_end_time
+  void advanceTo(const Time a_end_time) {
+    if (a_end_time > m_end_time) m_end_time = a_end_time;
+    if (!m_lazy) catchUp();
+  }
+
+  // adds the mature candles which aren't added yet, several of them in one batch
+  virtual void catchUp() = 0;
+
   virtual void append(const C& candle) = 0;
+  // a_count same candles, e.g. a run of flat candles of a sparse CandlePeriod
+  virtual void appendRun(const C& candle, const size_t a_count) = 0;
   virtual void constructFrom(const CandlePeriodT<C, T>& candle_period) = 0;
+  // keeps only the last a_max_values values of every indicator
+  virtual void trimValues(const size_t a_max_values) = 0;
   virtual void saveToCSV(FILE* filep, bool complete_line) = 0;
   virtual void saveHeaderToCSV(FILE* filep, bool complete_line) = 0;
   virtual Time getLastTimeStamp() = 0;
@@ -63,9 +97,15 @@ class DiscreteIndicatorT : public DiscreteIndicatorA<C> {
  private:
   Time m_last_candle_timestamp;
   size_t m_num_candles;
+  size_t m_num_evicted = 0;  // values removed from the front of every indicator by trimValues
+
+  const CandlePeriodT<C, T>* mp_candle_period = nullptr;  // set by constructFrom, the source of catchUp
 
   std::tuple<Is...> m_indicator_list;
 
+  // last value of every indicator, published after each append for readers on other threads
+  std::tuple<SeqLock<typename decltype(Is::m_values)::value_type>...> m_last_values;
+
   template <std::size_t I = 0>
   inline typename std::enable_if<I == sizeof...(Is), void>::type individualAppend(const C& candle) {}
 
@@ -75,6 +115,97 @@ class DiscreteIndicatorT : public DiscreteIndicatorA<C> {
     individualAppend<I + 1>(candle);
   }
 
+  // indicators having appendRun advance over a run in one go, the others take the candles one by one
+  template <typename I>
+  static auto appendRunTo(I& indicator, const C& candle, const size_t a_count, int)
+      -> decltype(indicator.appendRun(candle, a_count), void()) {
+    indicator.appendRun(candle, a_count);
+  }
+
+  template <typename I>
+  static void appendRunTo(I& indicator, const C& candle, const size_t a_count, long) {
+    for (size_t i = 0; i < a_count; i++) indicator.append(candle);
+  }
+
+  template <std::size_t I = 0>
+  inline typename std::enable_if<I == sizeof...(Is), void>::type individualAppendRun(const C& candle,
+                                                                                      const size_t a_count) {}
+
+  template <std::size_t I = 0>
+      inline typename std::enable_if < I<sizeof...(Is), void>::type individualAppendRun(const C& candle,
+                                                                                        const size_t a_count) {
+    appendRunTo(std::get<I>(m_indicator_list), candle, a_count, 0);
+    individualAppendRun<I + 1>(candle, a_count);
+  }
+
+  // indicators having appendBatch warm up from the columns, the others take the candles one by one
+  typedef typename CandlePeriodT<C, T>::const_iterator candle_itr_t;
+
+  template <typename I>
+  static auto appendBatchTo(I& indicator, candle_itr_t begin, candle_itr_t end, const candle_columns_t& columns, int)
+      -> decltype(indicator.appendBatch(columns), void()) {
+    indicator.appendBatch(columns);
+  }
+
+  template <typename I>
+  static void appendBatchTo(I& indicator, candle_itr_t begin, candle_itr_t end, const candle_columns_t& columns,
+                            long) {
+    for (auto itr = begin; itr != end; ++itr) indicator.append(*itr);
+  }
+
+  template <std::size_t I = 0>
+  inline typename std::enable_if<I == sizeof...(Is), void>::type individualAppendBatch(
+      candle_itr_t begin, candle_itr_t end, const candle_columns_t& columns) {}
+
+  template <std::size_t I = 0>
+      inline typename std::enable_if < I<sizeof...(Is), void>::type individualAppendBatch(
+                                           candle_itr_t begin, candle_itr_t end, const candle_columns_t& columns) {
+    appendBatchTo(std::get<I>(m_indicator_list), begin, end, columns, 0);
+    individualAppendBatch<I + 1>(begin, end, columns);
+  }
+
+  // candles from begin till end in one go, the price columns are shared by the indicators
+  void appendBatch(candle_itr_t begin, candle_itr_t end) {
+    if (begin == end) return;
+
+    const candle_columns_t columns(begin, end);
+
+    individualAppendBatch(begin, end, columns);
+    m_last_candle_timestamp = (end - 1)->getTimeStamp();
+    m_num_candles += static_cast<size_t>(end - begin);
+
+    individualPublish();
+  }
+
+  // start of the first candle which isn't added yet
+  Time getNextTimeStamp() const {
+    if (m_num_candles == 0) return mp_candle_period->getFirstTimestamp();
+
+    return std::max(m_last_candle_timestamp + this->m_interval, mp_candle_period->getFirstTimestamp());
+  }
+
+  template <std::size_t I = 0>
+  inline typename std::enable_if<I == sizeof...(Is), void>::type individualEvictFront(const size_t a_num_values) {}
+
+  template <std::size_t I = 0>
+      inline typename std::enable_if < I<sizeof...(Is), void>::type individualEvictFront(const size_t a_num_values) {
+    auto& values = std::get<I>(m_indicator_list).m_values;
+
+    values.erase(values.begin(), values.begin() + std::min(a_num_values, values.size()));
+    individualEvictFront<I + 1>(a_num_values);
+  }
+
+  template <std::size_t I = 0>
+  inline typename std::enable_if<I == sizeof...(Is), void>::type individualPublish() {}
+
+  template <std::size_t I = 0>
+      inline typename std::enable_if < I<sizeof...(Is), void>::type individualPublish() {
+    auto& values = std::get<I>(m_indicator_list).m_values;
+
+    if (!values.empty()) std::get<I>(m_last_values).store(values.back());
+    individualPublish<I + 1>();
+  }
+
   template <std::size_t I = 0>
   inline typename std::enable_if<I == sizeof...(Is), void>::type individualPrintValue(FILE* filep) {}
 
@@ -127,28 +258,47 @@ class DiscreteIndicatorT : public DiscreteIndicatorA<C> {
     individualAppend(candle);
     m_last_candle_timestamp = candle.getTimeStamp();
     m_num_candles++;
+
+    individualPublish();
+  }
+
+  void appendRun(const C& candle, const size_t a_count) {
+    if (a_count == 0) return;
+
+    individualAppendRun(candle, a_count);
+    m_last_candle_timestamp =
+        candle.getTimeStamp() + Duration(this->m_interval.getDuration() * static_cast<int64_t>(a_count - 1));
+    m_num_candles += a_count;
+
+    individualPublish();
   }
 
   template <std::size_t I>
   auto getIndicator() -> decltype(std::get<I>(m_indicator_list))& {
+    if (this->m_lazy) catchUp();
     return std::get<I>(m_indicator_list);
   }
 
   template <std::size_t I>
   auto getIndicatorValues() -> decltype(std::get<I>(m_indicator_list).m_values)& {
+    if (this->m_lazy) catchUp();
     return std::get<I>(m_indicator_list).m_values;
   }
 
   template <std::size_t I>
   auto getIndicatorAtIdx(size_t idx = UINT64_MAX) ->
       typename decltype(std::get<I>(m_indicator_list).m_values)::value_type {
+    if (this->m_lazy) catchUp();
+
     if (idx == UINT64_MAX) idx = m_num_candles - 1;
-    return std::get<I>(m_indicator_list).m_values[idx];
+    return std::get<I>(m_indicator_list).m_values[idx - m_num_evicted];
   }
 
   template <std::size_t I>
   auto getIndicatorAtTime(Time timestamp = Time(0)) ->
       typename decltype(std::get<I>(m_indicator_list).m_values)::value_type {
+    if (this->m_lazy) catchUp();
+
     size_t idx;
 
     if (timestamp == Time(0))
@@ -156,18 +306,80 @@ class DiscreteIndicatorT : public DiscreteIndicatorA<C> {
     else
       idx = m_num_candles - (m_last_candle_timestamp - timestamp.quantize(this->m_interval)) / this->m_interval - 1;
 
-    return std::get<I>(m_indicator_list).m_values[idx];
+    return std::get<I>(m_indicator_list).m_values[idx - m_num_evicted];
+  }
+
+  // last value of indicator I, unlike the others it's safe to read while the trade history appends candles. Not for
+  // lazy indicators, whose published value lags behind till they are read on the appending thread.
+  template <std::size_t I>
+  auto getLastValue() const -> typename decltype(std::get<I>(m_indicator_list).m_values)::value_type {
+    ASSERT(!this->m_lazy);
+    return std::get<I>(m_last_values).load();
   }
 
   Time getLastTimeStamp() {
+    if (this->m_lazy) catchUp();
     return m_last_candle_timestamp;
   }
 
+  // mature candles, the ones a lazy indicator hasn't added yet included
   size_t getNumCandles() const {
-    return m_num_candles;
+    if (!mp_candle_period || (this->m_end_time <= m_last_candle_timestamp + this->m_interval)) return m_num_candles;
+
+    const Time start_time = getNextTimeStamp();
+    if (this->m_end_time <= start_time) return m_num_candles;
+
+    return m_num_candles + static_cast<size_t>((this->m_end_time - start_time) / this->m_interval);
+  }
+
+  void catchUp() {
+    if (!mp_candle_period || (this->m_end_time <= m_last_candle_timestamp + this->m_interval)) return;
+
+    const Time start_time = getNextTimeStamp();
+    const Time end_time = this->m_end_time;
+
+    if (end_time <= start_time) return;
+
+    if (mp_candle_period->isSparse()) {
+      // a run of flat candles in one go
+      for (Time run_start_time = start_time; run_start_time < end_time;) {
+        C candle;
+        const size_t num_candles = mp_candle_period->getCandleRun(run_start_time, end_time, candle);
+
+        appendRun(candle, num_candles);
+        run_start_time += Duration(this->m_interval.getDuration() * static_cast<int64_t>(num_candles));
+      }
+      return;
+    }
+
+    // candles of a dense period are consecutive
+    const int64_t first_idx = (start_time - mp_candle_period->getFirstTimestamp()) / this->m_interval;
+    const int64_t end_idx = (end_time - mp_candle_period->getFirstTimestamp()) / this->m_interval;
+
+    if (end_idx == first_idx + 1)
+      append((*mp_candle_period)[first_idx]);
+    else
+      appendBatch(mp_candle_period->begin() + first_idx, mp_candle_period->begin() + end_idx);
+  }
+
+  // indices of getIndicatorAtIdx keep counting from the first candle, values before this one are evicted
+  size_t getFirstIdx() const {
+    return m_num_evicted;
+  }
+
+  void trimValues(const size_t a_max_values) {
+    catchUp();
+
+    const size_t num_values = m_num_candles - m_num_evicted;
+    if (num_values <= a_max_values) return;
+
+    individualEvictFront(num_values - a_max_values);
+    m_num_evicted += (num_values - a_max_values);
   }
 
   void saveToCSV(FILE* filep, const bool complete_line) {
+    catchUp();
+
     if (complete_line) {
       DbUtils::writeInCSV(filep, m_last_candle_timestamp, true);
     }
@@ -186,10 +398,14 @@ class DiscreteIndicatorT : public DiscreteIndicatorA<C> {
     if (complete_line) fprintf(filep, "\n");
   }
 
+  // adds all the candles of the period (a lazy indicator when it's read), later candles of the period are added with
+  // advanceTo
   void constructFrom(const CandlePeriodT<C, T>& candle_period) {
-    for (auto& candle : candle_period) {
-      append(candle);
-    }
+    mp_candle_period = &candle_period;
+
+    if (candle_period.empty()) return;
+
+    this->advanceTo(candle_period.getLastTimestamp() + this->m_interval);
   }
 
   ~DiscreteIndicatorT() {
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "CandleColumns.h"
 #include "DiscreteIndicator.h"
 #include <ta-lib/ta_func.h>
 #include <tuple>
@@ -17,8 +18,10 @@ class EMA {
   std::deque<ema_t> m_values;
   std::shared_ptr<ema_state_t> m_state;
   candle_price_t m_select_price;
+  int m_period;
+  size_t m_num_appended = 0;
 
-  EMA(int period, candle_price_t select_price = candle_price_t::OPEN) : m_select_price(select_price) {
+  EMA(int period, candle_price_t select_price = candle_price_t::OPEN) : m_select_price(select_price), m_period(period) {
     ema_state_t* state_ptr;
     TA_EMA_StateInit(&state_ptr, period);
     m_state.reset(state_ptr, [](struct TA_EMA_State* ptr) { TA_EMA_StateFree(&ptr); });
@@ -28,6 +31,35 @@ class EMA {
     double out_val;
     TA_EMA_State(m_state.get(), candle.get(m_select_price), &out_val);
     m_values.push_back({out_val});
+    m_num_appended++;
+  }
+
+  // same as appending the candles one by one, the state steps over the price column into a preallocated array
+  void appendBatch(const candle_columns_t& a_columns) {
+    const std::vector<double>& prices = a_columns.get(m_select_price);
+    std::vector<ema_t> values(prices.size());
+
+    for (size_t i = 0; i < prices.size(); i++) TA_EMA_State(m_state.get(), prices[i], &values[i].ema);
+
+    m_values.insert(m_values.end(), values.begin(), values.end());
+    m_num_appended += prices.size();
+  }
+
+  // after the first period the state of the EMA is its last value, so once a flat candle doesn't change the value the
+  // rest of the run won't either
+  void appendRun(const Candlestick& candle, const size_t a_count) {
+    size_t num_appended = 0;
+
+    while (num_appended < a_count) {
+      const double last_ema = m_values.empty() ? 0 : m_values.back().ema;
+
+      append(candle);
+      num_appended++;
+
+      if ((m_num_appended > static_cast<size_t>(m_period + 1)) && (m_values.back().ema == last_ema)) break;
+    }
+
+    if (num_appended < a_count) m_values.insert(m_values.end(), a_count - num_appended, m_values.back());
   }
 
   static field_t getFields() {
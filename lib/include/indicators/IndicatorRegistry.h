@@ -0,0 +1,120 @@
+//
+// Created by subhagato on 10/18/26.
+//
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "CurrencyPair.h"
+#include "Enums.h"
+#include "utils/TimeUtils.h"
+
+#include "DerivedMACD.h"
+#include "DiscreteIndicator.h"
+
+template <typename T>
+class TradeHistoryT;
+
+/*******
+ *
+ * Indicators shared by the trade algos of a Controller. Every indicator of a trading pair and interval with the same
+ * type and parameters is a single node, computed once per candle however many algos ask for it, and derived
+ * indicators are built from the shared nodes (MACD from the EMA nodes).
+ *
+ * The registry owns the nodes. Nodes are added to the trade histories in the order they are created, which is the
+ * order of the dependencies, so a node is fed after the ones it reads.
+ */
+
+// an indicator node, name is the type and the parameters e.g. "EMA(26,1)"
+typedef struct indicator_key_t {
+  exchange_t exchange_id;
+  CurrencyPair currency_pair;
+  Duration interval;
+  std::string name;
+
+  bool operator<(const indicator_key_t& rhs) const {
+    const currency_t base = currency_pair.getBaseCurrency(), quote = currency_pair.getQuoteCurrency();
+    const currency_t rhs_base = rhs.currency_pair.getBaseCurrency(), rhs_quote = rhs.currency_pair.getQuoteCurrency();
+
+    return (std::tie(exchange_id, base, quote, interval, name) <
+            std::tie(rhs.exchange_id, rhs_base, rhs_quote, rhs.interval, rhs.name));
+  }
+} indicator_key_t;
+
+class IndicatorRegistry {
+ private:
+  // in the order they are created, dependencies first
+  std::vector<std::pair<indicator_key_t, DiscreteIndicatorA<>*>> m_nodes;
+  std::map<indicator_key_t, DiscreteIndicatorA<>*> m_node_map;
+
+  size_t m_num_requests;
+
+  // the node of a_key, a_create_node makes it if there isn't one yet
+  template <typename I, typename F>
+  DiscreteIndicator<I>* getNode(const indicator_key_t& a_key, F a_create_node) {
+    m_num_requests++;
+
+    auto node_itr = m_node_map.find(a_key);
+    if (node_itr != m_node_map.end()) return static_cast<DiscreteIndicator<I>*>(node_itr->second);
+
+    DiscreteIndicator<I>* p_node = a_create_node();
+
+    m_nodes.push_back(std::make_pair(a_key, p_node));
+    m_node_map[a_key] = p_node;
+
+    return p_node;
+  }
+
+ public:
+  IndicatorRegistry() : m_num_requests(0) {}
+  ~IndicatorRegistry();
+
+  IndicatorRegistry(const IndicatorRegistry&) = delete;
+  IndicatorRegistry& operator=(const IndicatorRegistry&) = delete;
+
+  DiscreteIndicator<EMA>* getEMA(const exchange_t a_exchange_id, const CurrencyPair& a_currency_pair,
+                                 const Duration a_interval, const int a_period,
+                                 const candle_price_t a_price = candle_price_t::OPEN);
+  DiscreteIndicator<SMA>* getSMA(const exchange_t a_exchange_id, const CurrencyPair& a_currency_pair,
+                                 const Duration a_interval, const int a_period,
+                                 const candle_price_t a_price = candle_price_t::OPEN);
+  DiscreteIndicator<MA>* getMA(const exchange_t a_exchange_id, const CurrencyPair& a_currency_pair,
+                               const Duration a_interval, const int a_period, const bool a_volume_weighted,
+                               const candle_price_t a_price = candle_price_t::OPEN);
+  DiscreteIndicator<RSI>* getRSI(const exchange_t a_exchange_id, const CurrencyPair& a_currency_pair,
+                                 const Duration a_interval, const int a_period,
+                                 const candle_price_t a_price = candle_price_t::OPEN);
+  DiscreteIndicator<STDDEV>* getSTDDEV(const exchange_t a_exchange_id, const CurrencyPair& a_currency_pair,
+                                       const Duration a_interval, const int a_period,
+                                       const candle_price_t a_price = candle_price_t::OPEN);
+  DiscreteIndicator<TEMA>* getTEMA(const exchange_t a_exchange_id, const CurrencyPair& a_currency_pair,
+                                   const Duration a_interval, const int a_period,
+                                   const candle_price_t a_price = candle_price_t::OPEN);
+
+  // derived from the EMA nodes of the fast and the slow period, which are created if needed
+  DiscreteIndicator<DerivedMACD>* getMACD(const exchange_t a_exchange_id, const CurrencyPair& a_currency_pair,
+                                          const Duration a_interval, const int a_fast_period, const int a_slow_period,
+                                          const int a_signal_period,
+                                          const candle_price_t a_price = candle_price_t::OPEN);
+
+  // intervals of the nodes of a trading pair
+  std::set<Duration> getIntervals(const exchange_t a_exchange_id, const CurrencyPair& a_currency_pair) const;
+
+  // adds the candle periods and the nodes of its trading pair to a trade history
+  void addTo(TradeHistoryT<Tick>* ap_trade_history) const;
+
+  size_t getNumNodes() const {
+    return m_nodes.size();
+  }
+
+  // indicators asked for, the ones asked for by derived nodes included
+  size_t getNumRequests() const {
+    return m_num_requests;
+  }
+};
@@ -4,8 +4,10 @@
 
 #pragma once
 
+#include "CandleColumns.h"
 #include "DiscreteIndicator.h"
-#include <queue>
+#include "RollingWindow.h"
+#include <utility>
 
 typedef struct ma_t { double ma; } ma_t;
 
@@ -14,7 +16,7 @@ class MA {
   std::deque<ma_t> m_values;
 
   MA(int period, bool volume_weighted, candle_price_t select_price = candle_price_t::OPEN)
-      : m_select_price(select_price), m_time_period(period), m_volume_weighted(volume_weighted) {
+      : m_history(period), m_select_price(select_price), m_time_period(period), m_volume_weighted(volume_weighted) {
     m_total_volume = 0.0;
     m_moving_average = 0.0;
   }
@@ -25,6 +27,12 @@ class MA {
 
   void append(const Candlestick& candle);
 
+  // same as appending a_count times, in closed form once the window only holds the candle
+  void appendRun(const Candlestick& candle, const size_t a_count);
+
+  // same as appending the candles one by one, in one pass over the columns
+  void appendBatch(const candle_columns_t& a_columns);
+
   friend std::ostream& operator<<(std::ostream& os, const MA& ma) {
     for (auto& v : ma.m_values) {
       os << std::setprecision(8) << v.ma << "\n";
@@ -33,7 +41,7 @@ class MA {
   }
 
  private:
-  std::queue<std::tuple<double, double>> m_history;
+  RingBuffer<std::pair<double, double>> m_history;  // (price, volume) of the last period candles
   double m_total_volume;
   double m_moving_average;
   candle_price_t m_select_price;
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "CandleColumns.h"
 #include "DiscreteIndicator.h"
 #include <Candlestick.h>
 #include <Enums.h>
@@ -38,6 +39,17 @@ class MACD {
     m_values.push_back({macd, macd_signal, macd_hist});
   }
 
+  void appendBatch(const candle_columns_t& a_columns) {
+    const std::vector<double>& prices = a_columns.get(m_select_price);
+    std::vector<macd_t> values(prices.size());
+
+    for (size_t i = 0; i < prices.size(); i++) {
+      TA_MACD_State(m_state.get(), prices[i], &values[i].macd, &values[i].macd_signal, &values[i].macd_hist);
+    }
+
+    m_values.insert(m_values.end(), values.begin(), values.end());
+  }
+
   static field_t getFields() {
     return {{"MACD-value", "double"}, {"MACD-signal", "double"}, {"MACD-hist", "double"}};
   };
@@ -0,0 +1,43 @@
+//
+// Created by subhagato on 10/18/26.
+//
+
+#pragma once
+
+#include "DiscreteIndicator.h"
+#include "RollingWindow.h"
+#include <algorithm>
+#include <deque>
+
+typedef struct quantile_t { double quantile; } quantile_t;
+
+// quantile of a price over the last period candles, the median by default
+class QUANTILE {
+ public:
+  std::deque<quantile_t> m_values;
+  RollingQuantile m_window;
+  candle_price_t m_select_price;
+  int m_period;
+  double m_quantile;
+
+  QUANTILE(int period, double quantile = 0.5, candle_price_t select_price = candle_price_t::OPEN)
+      : m_window(period), m_select_price(select_price), m_period(period), m_quantile(quantile) {}
+
+  void append(const Candlestick& candle) {
+    m_window.push(candle.get(m_select_price));
+    m_values.push_back({m_window.quantile(m_quantile)});
+  }
+
+  // once the window only holds the flat candle the quantile stays at its price
+  void appendRun(const Candlestick& candle, const size_t a_count) {
+    const size_t num_appended = std::min(a_count, static_cast<size_t>(m_period));
+
+    for (size_t i = 0; i < num_appended; i++) append(candle);
+
+    if (num_appended < a_count) m_values.insert(m_values.end(), a_count - num_appended, m_values.back());
+  }
+
+  static field_t getFields() {
+    return {{"QUANTILE-value", "double"}};
+  };
+};
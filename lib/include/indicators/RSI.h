@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "CandleColumns.h"
 #include "DiscreteIndicator.h"
 #include <ta-lib/ta_func.h>
 #include <tuple>
@@ -30,6 +31,15 @@ class RSI {
     m_values.push_back({out_val});
   }
 
+  void appendBatch(const candle_columns_t& a_columns) {
+    const std::vector<double>& prices = a_columns.get(m_select_price);
+    std::vector<rsi_t> values(prices.size());
+
+    for (size_t i = 0; i < prices.size(); i++) TA_RSI_State(m_state.get(), prices[i], &values[i].rsi);
+
+    m_values.insert(m_values.end(), values.begin(), values.end());
+  }
+
   static field_t getFields() {
     return {{"RSI-value", "double"}};
   };
@@ -0,0 +1,338 @@
+//
+// Created by subhagato on 10/18/26.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+/*******
+ *
+ * Streaming statistics over the last values of a series, the building blocks of the rolling indicators. Storage is
+ * allocated once with the capacity of the window, an update doesn't allocate and costs O(1) (amortized for the sums,
+ * which are summed again once per window to drop the rounding error of the running sum), except RollingQuantile
+ * which finds its positions in O(log n) and shifts the values in between.
+ */
+
+// last a_capacity values, the oldest is dropped by a push into a full buffer
+template <typename T>
+class RingBuffer {
+ private:
+  std::vector<T> m_buffer;
+  size_t m_head;  // oldest value
+  size_t m_size;
+
+  size_t wrap(const size_t a_idx) const {
+    return (a_idx >= m_buffer.size()) ? (a_idx - m_buffer.size()) : a_idx;
+  }
+
+ public:
+  explicit RingBuffer(const size_t a_capacity) : m_buffer(std::max<size_t>(a_capacity, 1)), m_head(0), m_size(0) {}
+
+  size_t capacity() const {
+    return m_buffer.size();
+  }
+  size_t size() const {
+    return m_size;
+  }
+  bool empty() const {
+    return (m_size == 0);
+  }
+  bool full() const {
+    return (m_size == m_buffer.size());
+  }
+
+  // a_idx-th oldest value
+  const T& operator[](const size_t a_idx) const {
+    return m_buffer[wrap(m_head + a_idx)];
+  }
+  const T& front() const {
+    return m_buffer[m_head];
+  }
+  const T& back() const {
+    return (*this)[m_size - 1];
+  }
+
+  // returns true if the oldest value was dropped, it's copied to ap_evicted
+  bool push(const T& a_value, T* ap_evicted = nullptr) {
+    if (full()) {
+      if (ap_evicted) *ap_evicted = m_buffer[m_head];
+
+      m_buffer[m_head] = a_value;
+      m_head = wrap(m_head + 1);
+      return true;
+    }
+
+    m_buffer[wrap(m_head + m_size)] = a_value;
+    m_size++;
+    return false;
+  }
+
+  void popFront() {
+    m_head = wrap(m_head + 1);
+    m_size--;
+  }
+
+  void popBack() {
+    m_size--;
+  }
+
+  void clear() {
+    m_head = 0;
+    m_size = 0;
+  }
+};
+
+// sum and mean of the last a_period values
+class RollingSum {
+ private:
+  RingBuffer<double> m_window;
+  double m_sum;
+  size_t m_num_pushes;  // since the window was last summed
+
+ public:
+  explicit RollingSum(const size_t a_period) : m_window(a_period), m_sum(0), m_num_pushes(0) {}
+
+  void push(const double a_value) {
+    double evicted;
+    if (m_window.push(a_value, &evicted)) m_sum -= evicted;
+    m_sum += a_value;
+
+    if (++m_num_pushes == m_window.capacity()) {
+      m_sum = 0;
+      for (size_t i = 0; i < m_window.size(); i++) m_sum += m_window[i];
+      m_num_pushes = 0;
+    }
+  }
+
+  double sum() const {
+    return m_sum;
+  }
+  double mean() const {
+    return m_window.empty() ? std::numeric_limits<double>::quiet_NaN() : (m_sum / m_window.size());
+  }
+
+  size_t size() const {
+    return m_window.size();
+  }
+  bool full() const {
+    return m_window.full();
+  }
+
+  void clear() {
+    m_window.clear();
+    m_sum = 0;
+    m_num_pushes = 0;
+  }
+};
+
+// mean and variance of the last a_period values, Welford's update with the oldest value taken out of the window
+class RollingVariance {
+ private:
+  RingBuffer<double> m_window;
+  double m_mean;
+  double m_m2;          // sum of squared differences from the mean
+  size_t m_num_pushes;  // since the moments were last computed from the window
+
+ public:
+  explicit RollingVariance(const size_t a_period) : m_window(a_period), m_mean(0), m_m2(0), m_num_pushes(0) {}
+
+  void push(const double a_value) {
+    double evicted;
+
+    if (m_window.push(a_value, &evicted)) {
+      const double prev_mean = m_mean;
+
+      m_mean += (a_value - evicted) / m_window.size();
+      m_m2 += (a_value - evicted) * (a_value - m_mean + evicted - prev_mean);
+    } else {
+      const double delta = a_value - m_mean;
+
+      m_mean += delta / m_window.size();
+      m_m2 += delta * (a_value - m_mean);
+    }
+
+    if (++m_num_pushes == m_window.capacity()) {
+      double sum = 0;
+      for (size_t i = 0; i < m_window.size(); i++) sum += m_window[i];
+      m_mean = sum / m_window.size();
+
+      m_m2 = 0;
+      for (size_t i = 0; i < m_window.size(); i++) m_m2 += (m_window[i] - m_mean) * (m_window[i] - m_mean);
+      m_num_pushes = 0;
+    }
+
+    m_m2 = std::max(0.0, m_m2);
+  }
+
+  double mean() const {
+    return m_window.empty() ? std::numeric_limits<double>::quiet_NaN() : m_mean;
+  }
+  // population variance
+  double variance() const {
+    return m_window.empty() ? std::numeric_limits<double>::quiet_NaN() : (m_m2 / m_window.size());
+  }
+  double sampleVariance() const {
+    return (m_window.size() < 2) ? std::numeric_limits<double>::quiet_NaN() : (m_m2 / (m_window.size() - 1));
+  }
+
+  size_t size() const {
+    return m_window.size();
+  }
+
+  void clear() {
+    m_window.clear();
+    m_mean = 0;
+    m_m2 = 0;
+    m_num_pushes = 0;
+  }
+};
+
+// minimum (Compare = less) or maximum (Compare = greater) of the last a_period values, a monotonic deque keeps the
+// values which can still become the extremum, each value is pushed and popped once
+template <typename Compare>
+class RollingExtremum {
+ private:
+  RingBuffer<std::pair<size_t, double>> m_candidates;  // (push number, value), the front is the extremum
+  size_t m_period;
+  size_t m_num_pushes;
+  Compare m_compare;
+
+ public:
+  explicit RollingExtremum(const size_t a_period)
+      : m_candidates(a_period), m_period(std::max<size_t>(a_period, 1)), m_num_pushes(0) {}
+
+  void push(const double a_value) {
+    while (!m_candidates.empty() && !m_compare(m_candidates.back().second, a_value)) m_candidates.popBack();
+    while (!m_candidates.empty() && (m_candidates.front().first + m_period <= m_num_pushes)) m_candidates.popFront();
+
+    m_candidates.push(std::make_pair(m_num_pushes, a_value));
+    m_num_pushes++;
+  }
+
+  double value() const {
+    return m_candidates.empty() ? std::numeric_limits<double>::quiet_NaN() : m_candidates.front().second;
+  }
+
+  size_t size() const {
+    return std::min(m_num_pushes, m_period);
+  }
+
+  void clear() {
+    m_candidates.clear();
+    m_num_pushes = 0;
+  }
+};
+
+typedef RollingExtremum<std::less<double>> RollingMin;
+typedef RollingExtremum<std::greater<double>> RollingMax;
+
+// quantiles of the last a_period values, which are also kept sorted. The dropped value and the new one are located
+// by binary search and only the values between them are shifted.
+class RollingQuantile {
+ private:
+  RingBuffer<double> m_window;
+  std::vector<double> m_sorted;
+
+ public:
+  explicit RollingQuantile(const size_t a_period) : m_window(a_period) {
+    m_sorted.reserve(m_window.capacity());
+  }
+
+  void push(const double a_value) {
+    double evicted;
+
+    if (!m_window.push(a_value, &evicted)) {
+      m_sorted.insert(std::upper_bound(m_sorted.begin(), m_sorted.end(), a_value), a_value);
+      return;
+    }
+
+    double* p_sorted = m_sorted.data();
+    const size_t evicted_idx = std::lower_bound(m_sorted.begin(), m_sorted.end(), evicted) - m_sorted.begin();
+    size_t insert_idx = std::upper_bound(m_sorted.begin(), m_sorted.end(), a_value) - m_sorted.begin();
+
+    if (evicted_idx < insert_idx) {
+      insert_idx--;
+      memmove(p_sorted + evicted_idx, p_sorted + evicted_idx + 1, (insert_idx - evicted_idx) * sizeof(double));
+    } else {
+      memmove(p_sorted + insert_idx + 1, p_sorted + insert_idx, (evicted_idx - insert_idx) * sizeof(double));
+    }
+
+    p_sorted[insert_idx] = a_value;
+  }
+
+  // a_quantile in [0, 1], interpolated between the closest ranks
+  double quantile(const double a_quantile) const {
+    if (m_sorted.empty()) return std::numeric_limits<double>::quiet_NaN();
+
+    const double rank = std::min(std::max(a_quantile, 0.0), 1.0) * (m_sorted.size() - 1);
+    const size_t lower_idx = static_cast<size_t>(rank);
+
+    if (lower_idx + 1 >= m_sorted.size()) return m_sorted.back();
+
+    return m_sorted[lower_idx] + (rank - lower_idx) * (m_sorted[lower_idx + 1] - m_sorted[lower_idx]);
+  }
+
+  double median() const {
+    return quantile(0.5);
+  }
+
+  size_t size() const {
+    return m_window.size();
+  }
+
+  void clear() {
+    m_window.clear();
+    m_sorted.clear();
+  }
+};
+
+// volume weighted average price of the last a_period trades or candles
+class RollingVWAP {
+ private:
+  RollingSum m_traded_value;  // price * volume
+  RollingSum m_volume;
+  // trades or candles with volume in the window, the running sums keep a rounding residue once they leave it
+  RollingSum m_num_traded;
+  double m_last_price;
+
+ public:
+  explicit RollingVWAP(const size_t a_period)
+      : m_traded_value(a_period),
+        m_volume(a_period),
+        m_num_traded(a_period),
+        m_last_price(std::numeric_limits<double>::quiet_NaN()) {}
+
+  void push(const double a_price, const double a_volume) {
+    m_traded_value.push(a_price * a_volume);
+    m_volume.push(a_volume);
+    m_num_traded.push((a_volume > 0) ? 1 : 0);
+    m_last_price = a_price;
+  }
+
+  // the last price while there is no volume in the window
+  double value() const {
+    return (m_num_traded.sum() > 0) ? (m_traded_value.sum() / m_volume.sum()) : m_last_price;
+  }
+
+  double volume() const {
+    return (m_num_traded.sum() > 0) ? m_volume.sum() : 0;
+  }
+
+  size_t size() const {
+    return m_volume.size();
+  }
+
+  void clear() {
+    m_traded_value.clear();
+    m_volume.clear();
+    m_num_traded.clear();
+    m_last_price = std::numeric_limits<double>::quiet_NaN();
+  }
+};
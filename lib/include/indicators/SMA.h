@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include "CandleColumns.h"
 #include "DiscreteIndicator.h"
+#include <algorithm>
 #include <deque>
 #include <ta-lib/ta_func.h>
 
@@ -17,8 +19,9 @@ class SMA {
   std::deque<sma_t> m_values;
   std::shared_ptr<sma_state_t> m_state;
   candle_price_t m_select_price;
+  int m_period;
 
-  SMA(int period, candle_price_t select_price = candle_price_t::OPEN) : m_select_price(select_price) {
+  SMA(int period, candle_price_t select_price = candle_price_t::OPEN) : m_select_price(select_price), m_period(period) {
     sma_state_t* state_ptr;
     TA_SMA_StateInit(&state_ptr, period);
     m_state.reset(state_ptr, [](struct TA_SMA_State* ptr) { TA_SMA_StateFree(&ptr); });
@@ -30,6 +33,24 @@ class SMA {
     m_values.push_back({out_val});
   }
 
+  void appendBatch(const candle_columns_t& a_columns) {
+    const std::vector<double>& prices = a_columns.get(m_select_price);
+    std::vector<sma_t> values(prices.size());
+
+    for (size_t i = 0; i < prices.size(); i++) TA_SMA_State(m_state.get(), prices[i], &values[i].sma);
+
+    m_values.insert(m_values.end(), values.begin(), values.end());
+  }
+
+  // once the window only holds the flat candle the average stays at its price
+  void appendRun(const Candlestick& candle, const size_t a_count) {
+    const size_t num_appended = std::min(a_count, static_cast<size_t>(m_period));
+
+    for (size_t i = 0; i < num_appended; i++) append(candle);
+
+    if (num_appended < a_count) m_values.insert(m_values.end(), a_count - num_appended, m_values.back());
+  }
+
   static field_t getFields() {
     return {{"SMA-value", "double"}};
   };
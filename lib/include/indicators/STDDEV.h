@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "CandleColumns.h"
 #include "DiscreteIndicator.h"
 #include <deque>
 #include <ta-lib/ta_func.h>
@@ -32,6 +33,15 @@ class STDDEV {
     m_values.push_back({out_val});
   }
 
+  void appendBatch(const candle_columns_t& a_columns) {
+    const std::vector<double>& prices = a_columns.get(m_select_price);
+    std::vector<stddev_t> values(prices.size());
+
+    for (size_t i = 0; i < prices.size(); i++) TA_STDDEV_State(m_state.get(), prices[i], &values[i].stddev);
+
+    m_values.insert(m_values.end(), values.begin(), values.end());
+  }
+
   static field_t getFields() {
     return {{"STDDEV-value", "double"}};
   };
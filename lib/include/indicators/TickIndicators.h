@@ -0,0 +1,125 @@
+//
+// Created by subhagato on 10/18/26.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "RollingWindow.h"
+#include "utils/TimeUtils.h"
+
+/*******
+ *
+ * Indicators of a ContinuousIndicatorT, updated with every tick. The size of a tick is positive for a buy and
+ * negative for a sell. Windows are counted in ticks so their storage is allocated once.
+ */
+
+typedef struct tick_ewma_t { double ewma; } tick_ewma_t;
+
+// exponentially weighted moving average of the price decaying with time, a tick weighs half as much after a_half_life
+class TickEWMA {
+ public:
+  tick_ewma_t m_value;
+
+  TickEWMA(const Duration a_half_life)
+      : m_value{std::numeric_limits<double>::quiet_NaN()}, m_decay_time(a_half_life.getDuration() / std::log(2.0)) {}
+
+  template <typename T>
+  void append(const T& tick) {
+    if (std::isnan(m_value.ewma)) {
+      m_value.ewma = tick.getPrice();
+    } else {
+      // a tick at the time of the previous one counts as one microsecond later
+      const double elapsed = std::max<int64_t>(1, (tick.getTimeStamp() - m_last_timestamp).getDuration());
+
+      m_value.ewma += (1 - std::exp(-elapsed / m_decay_time)) * (tick.getPrice() - m_value.ewma);
+    }
+
+    m_last_timestamp = tick.getTimeStamp();
+  }
+
+ private:
+  double m_decay_time;  // in microseconds
+  Time m_last_timestamp;
+};
+
+typedef struct tick_vwap_t { double vwap; } tick_vwap_t;
+
+// volume weighted average price of the last a_num_ticks ticks
+class TickVWAP {
+ public:
+  tick_vwap_t m_value;
+
+  TickVWAP(const size_t a_num_ticks) : m_value{std::numeric_limits<double>::quiet_NaN()}, m_window(a_num_ticks) {}
+
+  template <typename T>
+  void append(const T& tick) {
+    m_window.push(tick.getPrice(), std::fabs(tick.getSize()));
+    m_value.vwap = m_window.value();
+  }
+
+ private:
+  RollingVWAP m_window;
+};
+
+typedef struct order_flow_t {
+  double imbalance;   // (bought - sold) / traded volume, in [-1, 1]
+  double net_volume;  // bought - sold
+} order_flow_t;
+
+// signed order flow of the last a_num_ticks ticks
+class OrderFlowImbalance {
+ public:
+  order_flow_t m_value;
+
+  OrderFlowImbalance(const size_t a_num_ticks)
+      : m_value{0, 0}, m_net_volume(a_num_ticks), m_volume(a_num_ticks), m_num_traded(a_num_ticks) {}
+
+  template <typename T>
+  void append(const T& tick) {
+    m_net_volume.push(tick.getSize());
+    m_volume.push(std::fabs(tick.getSize()));
+    m_num_traded.push((tick.getSize() != 0) ? 1 : 0);
+
+    if (m_num_traded.sum() > 0) {
+      m_value.net_volume = m_net_volume.sum();
+      m_value.imbalance = m_value.net_volume / m_volume.sum();
+    } else {
+      m_value = {0, 0};
+    }
+  }
+
+ private:
+  RollingSum m_net_volume;
+  RollingSum m_volume;
+  RollingSum m_num_traded;  // ticks with a size in the window, see RollingVWAP
+};
+
+typedef struct realized_volatility_t { double volatility; } realized_volatility_t;
+
+// square root of the sum of the squared log returns of the last a_num_ticks ticks
+class RealizedVolatility {
+ public:
+  realized_volatility_t m_value;
+
+  RealizedVolatility(const size_t a_num_ticks) : m_value{0}, m_squared_returns(a_num_ticks), m_last_price(0) {}
+
+  template <typename T>
+  void append(const T& tick) {
+    if ((m_last_price > 0) && (tick.getPrice() > 0)) {
+      const double log_return = std::log(tick.getPrice() / m_last_price);
+
+      m_squared_returns.push(log_return * log_return);
+      m_value.volatility = std::sqrt(std::max(0.0, m_squared_returns.sum()));
+    }
+
+    m_last_price = tick.getPrice();
+  }
+
+ private:
+  RollingSum m_squared_returns;
+  double m_last_price;
+};
@@ -0,0 +1,45 @@
+//
+// Created by subhagato on 10/18/26.
+//
+
+#pragma once
+
+#include "DiscreteIndicator.h"
+#include "RollingWindow.h"
+#include <algorithm>
+#include <deque>
+
+typedef struct variance_t {
+  double mean;
+  double variance;
+} variance_t;
+
+// mean and (population) variance of a price over the last period candles
+class VARIANCE {
+ public:
+  std::deque<variance_t> m_values;
+  RollingVariance m_window;
+  candle_price_t m_select_price;
+  int m_period;
+
+  VARIANCE(int period, candle_price_t select_price = candle_price_t::OPEN)
+      : m_window(period), m_select_price(select_price), m_period(period) {}
+
+  void append(const Candlestick& candle) {
+    m_window.push(candle.get(m_select_price));
+    m_values.push_back({m_window.mean(), m_window.variance()});
+  }
+
+  // once the window only holds the flat candle the mean stays at its price and the variance at 0
+  void appendRun(const Candlestick& candle, const size_t a_count) {
+    const size_t num_appended = std::min(a_count, static_cast<size_t>(m_period));
+
+    for (size_t i = 0; i < num_appended; i++) append(candle);
+
+    if (num_appended < a_count) m_values.insert(m_values.end(), a_count - num_appended, m_values.back());
+  }
+
+  static field_t getFields() {
+    return {{"VARIANCE-mean", "double"}, {"VARIANCE-value", "double"}};
+  };
+};
@@ -0,0 +1,40 @@
+//
+// Created by subhagato on 10/18/26.
+//
+
+#pragma once
+
+#include "DiscreteIndicator.h"
+#include "RollingWindow.h"
+#include <algorithm>
+#include <deque>
+
+typedef struct vwap_t { double vwap; } vwap_t;
+
+// volume weighted average of the mean prices of the last period candles
+class VWAP {
+ public:
+  std::deque<vwap_t> m_values;
+  RollingVWAP m_window;
+  int m_period;
+
+  VWAP(int period) : m_window(period), m_period(period) {}
+
+  void append(const Candlestick& candle) {
+    m_window.push(candle.getMean(), candle.getTotalVolume());
+    m_values.push_back({m_window.value()});
+  }
+
+  // once the window only holds the flat candle the average stays at its price
+  void appendRun(const Candlestick& candle, const size_t a_count) {
+    const size_t num_appended = std::min(a_count, static_cast<size_t>(m_period));
+
+    for (size_t i = 0; i < num_appended; i++) append(candle);
+
+    if (num_appended < a_count) m_values.insert(m_values.end(), a_count - num_appended, m_values.back());
+  }
+
+  static field_t getFields() {
+    return {{"VWAP-value", "double"}};
+  };
+};
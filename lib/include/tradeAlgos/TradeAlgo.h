@@ -13,7 +13,9 @@
 #define TRADEALGO_H
 
 #include "exchanges/Exchange.h"
+#include "indicators/ContinuousIndicator.h"
 #include "indicators/DiscreteIndicator.h"
+#include "indicators/IndicatorRegistry.h"
 #include <iostream>
 #include <unordered_set>
 #include <vector>
@@ -51,6 +53,12 @@ class TradeAlgo {
   std::unordered_map<exchange_t, std::unordered_map<Duration, std::unordered_map<CurrencyPair, DiscreteIndicatorA<>*>>>
       m_indicator_map;
 
+  // updated with every tick, before the TickTriggers check for it
+  std::vector<ContinuousIndicatorA<>*> m_continuous_indicators;
+
+  // indicators shared with the other algos, owned by the Controller
+  IndicatorRegistry* mp_indicator_registry;
+
   // past orders
   std::vector<order_id_t> m_past_orders;
 
@@ -60,6 +68,7 @@ class TradeAlgo {
   void initTrigger(const std::vector<AlgoFnPtr>& a_foos, Trigger* ap_trigger, Time a_cur_time);
 
   void registerIndicator(DiscreteIndicatorA<>* ap_indicator);
+  void registerContinuousIndicator(ContinuousIndicatorA<>* ap_indicator);
 
  public:
   explicit TradeAlgo(tradeAlgo_t a_tradeAlgo_idx);
@@ -67,6 +76,10 @@ class TradeAlgo {
 
   void checkForEvent(Time a_cur_time, bool a_interval_event = false);
 
+  void setIndicatorRegistry(IndicatorRegistry* ap_indicator_registry) {
+    mp_indicator_registry = ap_indicator_registry;
+  }
+
   inline const std::set<Duration>& getCandleStickDuration() const {
     return m_intervals;
   }
@@ -76,6 +89,10 @@ class TradeAlgo {
     return m_indicator_map[exchange_id][interval][currency_pair];
   }
 
+  const std::vector<ContinuousIndicatorA<>*>& getContinuousIndicators() const {
+    return m_continuous_indicators;
+  }
+
   void populateOrder(const order_id_t a_order_id) {
     m_past_orders.push_back(a_order_id);
   }
@@ -13,6 +13,7 @@
 
 #include "triggers/Trigger.h"
 
+// fires on a new tick of any of the trade histories, their continuous indicators already include it
 class TickTrigger : public Trigger {
  private:
   std::unordered_map<trading_pair_t, uint32_t> m_prev_num_trades;
@@ -0,0 +1,78 @@
+//
+// Created by subhagato on 10/18/26.
+//
+
+#ifndef CRYPTOTRADER_SEQLOCK_H
+#define CRYPTOTRADER_SEQLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/*******
+ *
+ * Sequence lock publishing a small trivially copyable value from one writer (writers are serialized by the caller) to
+ * any number of readers, which never block the writer nor each other.
+ *
+ * The sequence is odd while the value is being written, a reader retries till it copies the value between two reads
+ * of the same even sequence. The value is held in atomic words, so a torn copy which is thrown away isn't a data race.
+ */
+
+template <typename S>
+class SeqLock {
+  static_assert(std::is_trivially_copyable<S>::value, "a published value is copied word by word");
+
+ private:
+  static const size_t s_num_words = (sizeof(S) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+  std::atomic<uint64_t> m_seq;
+  std::atomic<uint64_t> m_words[s_num_words];
+
+ public:
+  SeqLock() : m_seq(0) {
+    store(S());
+  }
+
+  SeqLock(const SeqLock&) = delete;
+  SeqLock& operator=(const SeqLock&) = delete;
+
+  void store(const S& a_value) {
+    uint64_t words[s_num_words] = {};
+    memcpy(words, &a_value, sizeof(S));
+
+    const uint64_t seq = m_seq.load(std::memory_order_relaxed);
+
+    m_seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (size_t i = 0; i < s_num_words; i++) m_words[i].store(words[i], std::memory_order_relaxed);
+
+    m_seq.store(seq + 2, std::memory_order_release);
+  }
+
+  S load() const {
+    uint64_t words[s_num_words];
+    uint64_t seq_before, seq_after;
+
+    do {
+      seq_before = m_seq.load(std::memory_order_acquire);
+
+      for (size_t i = 0; i < s_num_words; i++) words[i] = m_words[i].load(std::memory_order_relaxed);
+
+      std::atomic_thread_fence(std::memory_order_acquire);
+      seq_after = m_seq.load(std::memory_order_relaxed);
+    } while ((seq_before & 1) || (seq_before != seq_after));
+
+    S value;
+    memcpy(&value, words, sizeof(S));
+    return value;
+  }
+
+  // number of values stored so far (including the initial one)
+  uint64_t getVersion() const {
+    return m_seq.load(std::memory_order_acquire) / 2;
+  }
+};
+
+#endif  // CRYPTOTRADER_SEQLOCK_H
@@ -54,11 +54,10 @@ class Duration {
     m_duration = offset_micros;
   }
 
-  inline Duration(const Duration& d) {
-    this->m_duration = d.m_duration;
-  }
+  // trivially copyable, candles holding a Duration or a Time are published to readers bytewise
+  inline Duration(const Duration& d) = default;
 
-  inline ~Duration() {}
+  inline ~Duration() = default;
 
   inline int64_t getDuration() const {
     return m_duration;
@@ -201,9 +200,7 @@ class Time {
     m_timestamp = 0;
   }
 
-  inline Time(const Time& t) {
-    m_timestamp = t.m_timestamp;
-  }
+  inline Time(const Time& t) = default;
 
   explicit inline Time(const int32_t date, const int64_t time) {
     m_timestamp = Duration(date, 0, 0, 0, 0, time).getDuration();
@@ -309,7 +306,7 @@ class Time {
     m_timestamp = micros_since_epoch;
   }
 
-  inline ~Time() {}
+  inline ~Time() = default;
 
   inline struct tm* utctime() const {
     time_t utc_timestamp = static_cast<time_t>(m_timestamp / 1000000LL);
@@ -362,10 +359,7 @@ class Time {
     return *this;
   }
 
-  Time& operator=(const Time& rhs) {
-    this->m_timestamp = rhs.m_timestamp;
-    return *this;
-  }
+  Time& operator=(const Time& rhs) = default;
 
   explicit operator int64_t() const {
     return this->m_timestamp;
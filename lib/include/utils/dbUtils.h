@@ -5,8 +5,12 @@
 #ifndef CRYPTOTRADER_DBUTILS_H
 #define CRYPTOTRADER_DBUTILS_H
 
+#include "DataTypes.h"
+#include "Globals.h"
 #include "TimeUtils.h"
 #include <cassandra.h>
+#include <cstring>
+#include <string>
 
 namespace DbUtils {
 
@@ -40,8 +44,171 @@ void writeInCSV(FILE* ap_file, std::string type, const void* value);
 
 void printData(std::string type, const void* value);
 
+// =====================================================================
+// row codec: row types expose the columns of m_fields through
+// visitFields(), so column types are resolved at compile time and
+// columns are accessed by index.
+// column order : date, time, [unique id], m_fields...
+// date and time are the bucket and offset of the timestamp, see TimeBucket
+// =====================================================================
+
+struct CassFieldBinder {
+  CassStatement* statement;
+  size_t index;
+
+  template <typename M>
+  inline void operator()(const M& value) {
+    cass_statement_bind_type(statement, index++, value);
+  }
+};
+
+struct CassFieldReader {
+  const CassRow* row;
+  size_t index;
+
+  inline void operator()(int32_t& value) {
+    cass_value_get_int32(cass_row_get_column(row, index++), &value);
+  }
+  inline void operator()(int64_t& value) {
+    cass_value_get_int64(cass_row_get_column(row, index++), &value);
+  }
+  inline void operator()(float& value) {
+    cass_value_get_float(cass_row_get_column(row, index++), &value);
+  }
+  inline void operator()(double& value) {
+    cass_value_get_double(cass_row_get_column(row, index++), &value);
+  }
+};
+
+struct CassFieldSizer {
+  size_t bytes;
+
+  template <typename M>
+  inline void operator()(const M& value) {
+    bytes += sizeof(value);
+  }
+};
+
+struct BinaryFieldWriter {
+  std::string* bytes;
+
+  template <typename M>
+  inline void operator()(const M& value) {
+    bytes->append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+};
+
+struct BinaryFieldReader {
+  const char* bytes;
+
+  template <typename M>
+  inline void operator()(M& value) {
+    memcpy(&value, bytes, sizeof(value));
+    bytes += sizeof(value);
+  }
+};
+
+struct CSVFieldWriter {
+  FILE* file;
+
+  template <typename M>
+  inline void operator()(const M& value) {
+    fprintf(file, ",");
+    writeInCSV(file, value);
+  }
+};
+
 template <typename T>
-void writeToCSVLine(FILE* ap_file, T& a_data, const bool complete_line = true) {
+inline size_t getNumKeyColumns() {
+  return (T::m_unique_id.first != "") ? 3 : 2;
+}
+
+template <typename T>
+void bindRow(CassStatement* ap_statement, const T& a_row, const TimeBucket& a_bucket = TimeBucket()) {
+  ASSERT(a_row.getDate() >= 0);
+  ASSERT(a_row.getTime() >= 0);
+
+  cass_statement_bind_type(ap_statement, 0, a_bucket.getBucket(a_row.getTimeStamp()));
+  cass_statement_bind_type(ap_statement, 1, a_bucket.getOffset(a_row.getTimeStamp()));
+
+  if (T::m_unique_id.first != "") cass_statement_bind_type(ap_statement, 2, a_row.getUniqueID());
+
+  CassFieldBinder binder = {ap_statement, getNumKeyColumns<T>()};
+  a_row.visitFields(binder);
+}
+
+// bytes bound to an insert of the row, used to size batches
+template <typename T>
+size_t getRowBytes(const T& a_row) {
+  CassFieldSizer sizer = {sizeof(int32_t) + sizeof(int64_t)};
+
+  if (T::m_unique_id.first != "") sizer.bytes += sizeof(int64_t);
+
+  a_row.visitFields(sizer);
+
+  return sizer.bytes;
+}
+
+template <typename T>
+T readRow(const CassRow* ap_cass_row, const TimeBucket& a_bucket = TimeBucket()) {
+  T row;
+  int32_t date;  // bucket since 1970-1-1 (days for day buckets)
+  int64_t time;  // microseconds since the start of the bucket
+
+  cass_value_get_int32(cass_row_get_column(ap_cass_row, 0), &date);
+  cass_value_get_int64(cass_row_get_column(ap_cass_row, 1), &time);
+
+  // unique id is empty if time stamp is the unique it
+  if (T::m_unique_id.first != "")
+    cass_value_get_int64(cass_row_get_column(ap_cass_row, 2), static_cast<cass_int64_t*>(row.getUniqueIdPtr()));
+
+  row.setTimeStamp(a_bucket.getTime(date, time));
+
+  CassFieldReader reader = {ap_cass_row, getNumKeyColumns<T>()};
+  row.visitFields(reader);
+
+  return row;
+}
+
+// binary form of a row (used by the local partition cache) : micros since epoch, [unique id], m_fields...
+template <typename T>
+void writeRowBinary(std::string& a_bytes, const T& a_row) {
+  const int64_t timestamp = static_cast<int64_t>(a_row.getTimeStamp());
+  a_bytes.append(reinterpret_cast<const char*>(&timestamp), sizeof(timestamp));
+
+  if (T::m_unique_id.first != "") {
+    const int64_t unique_id = a_row.getUniqueID();
+    a_bytes.append(reinterpret_cast<const char*>(&unique_id), sizeof(unique_id));
+  }
+
+  BinaryFieldWriter writer = {&a_bytes};
+  a_row.visitFields(writer);
+}
+
+// reads a row written by writeRowBinary, ap_bytes is moved to the next row
+template <typename T>
+T readRowBinary(const char*& ap_bytes) {
+  T row;
+  int64_t timestamp;
+
+  memcpy(&timestamp, ap_bytes, sizeof(timestamp));
+  ap_bytes += sizeof(timestamp);
+  row.setTimeStamp(Time(timestamp));
+
+  if (T::m_unique_id.first != "") {
+    memcpy(row.getUniqueIdPtr(), ap_bytes, sizeof(int64_t));
+    ap_bytes += sizeof(int64_t);
+  }
+
+  BinaryFieldReader reader = {ap_bytes};
+  row.visitFields(reader);
+  ap_bytes = reader.bytes;
+
+  return row;
+}
+
+template <typename T>
+void writeToCSVLine(FILE* ap_file, const T& a_data, const bool complete_line = true) {
   if (complete_line) writeInCSV(ap_file, a_data.getTimeStamp(), true);
 
   if (T::m_unique_id.first != "") {
@@ -49,11 +216,8 @@ void writeToCSVLine(FILE* ap_file, T& a_data, const bool complete_line = true) {
     writeInCSV(ap_file, a_data.getUniqueID());
   }
 
-  int i = 0;
-  for (auto& field : T::m_fields) {
-    fprintf(ap_file, ",");
-    writeInCSV(ap_file, field.second, a_data.getMemberPtr(i++));
-  }
+  CSVFieldWriter writer = {ap_file};
+  a_data.visitFields(writer);
 
   if (complete_line) fprintf(ap_file, "\n");
 }
@@ -9,6 +9,7 @@
 //
 
 #include "Globals.h"
+#include "PartitionCache.h"
 #include "TraderBot.h"
 #include "utils/TraderUtils.h"
 #include <fstream>
@@ -43,6 +44,32 @@ void setFixDatabase(string a_val) {
   COUT << "Repairing database by filling missing data\n";
 }
 
+// takes <table name>:<partition width in hours>
+void setMigrateTable(string a_val) {
+  const size_t sep = a_val.find(':');
+
+  if (sep == string::npos) {
+    CT_CRIT_WARN << "Table to migrate should be given as <table name>:<hours>\n";
+    return;
+  }
+
+  const int bucket_hours = atoi(a_val.substr(sep + 1).c_str());
+
+  switch (static_cast<bucket_width_t>(bucket_hours)) {
+    case bucket_width_t::HOUR:
+    case bucket_width_t::SIX_HOURS:
+    case bucket_width_t::DAY:
+    case bucket_width_t::WEEK:
+      break;
+    default:
+      CT_CRIT_WARN << "Partition width should be 1, 6, 24 or 168 hours\n";
+      return;
+  }
+
+  TraderBot::getInstance()->migrateTable(a_val.substr(0, sep), static_cast<bucket_width_t>(bucket_hours));
+  COUT << "Migrating " << a_val.substr(0, sep) << " to " << bucket_hours << " hour partitions\n";
+}
+
 void setCoinMarketCapCapture(string a_val) {
   TraderBot::getInstance()->captureCoinmarketcapUpdate();
 }
@@ -69,6 +96,15 @@ void setCSVDatabaseDirectory(string dir) {
   COUT << "Database directory = " << dir << endl;
 }
 
+void setTickStoreDirectory(string a_dir) {
+  if (!TradeUtils::isValidPath(a_dir) && !TradeUtils::createDir(a_dir)) {
+    INVALID_DIR_ERROR(a_dir);
+  }
+
+  g_tick_store_dir = a_dir;
+  COUT << "Tick store directory = " << a_dir << endl;
+}
+
 // file format:
 // line 1: currency (e.g., "BTC")
 // line 2: starting date in CSV format (e.g., 2017,8,1,0,0,0)
@@ -178,6 +214,76 @@ void setControllerConfig(string a_filename) {
 // TraderBot class arguments processing functions
 // ==============================================
 
+// false if a_val isn't a non negative number
+static bool parseSize(const string& a_val, size_t& a_size) {
+  if (a_val.empty() || (a_val.find_first_not_of("0123456789") != string::npos)) return false;
+
+  try {
+    a_size = stoul(a_val);
+  } catch (...) {
+    return false;
+  }
+
+  return true;
+}
+
+// takes <dir>[:<max size in MB>]
+void setPartitionCache(string a_val) {
+  const size_t sep = a_val.find(':');
+  const string dir = a_val.substr(0, sep);
+  size_t max_mb = PARTITION_CACHE_MAX_MB;
+
+  if ((sep != string::npos) && !parseSize(a_val.substr(sep + 1), max_mb)) {
+    CT_CRIT_WARN << "Partition cache should be given as <dir>[:<max MB>]\n";
+    return;
+  }
+
+  DELETE(g_partition_cache);
+  g_partition_cache = new PartitionCache(dir, max_mb * 1024 * 1024);
+
+  COUT << "Partition cache directory = " << dir << " (" << max_mb << " MB)" << endl;
+}
+
+void enableSharedTables(string a_val) {
+  g_shared_tables = true;
+  COUT << "Symbols are stored in shared tables\n";
+}
+
+void setSparseCandles(string a_val) {
+  size_t sparse_candle_sec;
+
+  if (!parseSize(a_val, sparse_candle_sec)) {
+    CT_CRIT_WARN << "Sparse candles should be given as the largest interval in seconds\n";
+    return;
+  }
+
+  g_sparse_candle_sec = static_cast<int64_t>(sparse_candle_sec);
+  COUT << "Candles up to " << g_sparse_candle_sec << " seconds are stored only if they have ticks\n";
+}
+
+// takes <ticks>:<candles>
+void setRetention(string a_val) {
+  const size_t sep = a_val.find(':');
+
+  size_t retention_ticks, retention_candles;
+
+  if ((sep == string::npos) || !parseSize(a_val.substr(0, sep), retention_ticks) ||
+      !parseSize(a_val.substr(sep + 1), retention_candles)) {
+    CT_CRIT_WARN << "Retention should be given as <ticks>:<candles>\n";
+    return;
+  }
+
+  g_retention_ticks = retention_ticks;
+  g_retention_candles = retention_candles;
+  COUT << "Keeping the last " << g_retention_ticks << " ticks and " << g_retention_candles
+       << " candles per interval in memory\n";
+}
+
+void enableLazyIndicators(string a_val) {
+  g_lazy_indicators = true;
+  COUT << "Indicators are computed when they are read\n";
+}
+
 void TraderBot::populateArgumentsList() {
   // m_arg_parser.addArguments("--fullArg", "-shortArg", "argument description", <switch>, <function pointer>);
   // m_arg_parser.addArguments("--fullArg", "-shortArg", "argument description", true, <function pointer>,
@@ -192,6 +298,11 @@ void TraderBot::populateArgumentsList() {
 
   m_arg_parser.addArguments("--fixDatabase", "-f", "fills missing data", true, setFixDatabase);
 
+  m_arg_parser.addArguments("--migrateTable", "-mt",
+                            "rewrites a table with a new partition width, takes <table name>:<hours> as input. Writers "
+                            "of the table have to be stopped, it's recreated",
+                            false, setMigrateTable);
+
   m_arg_parser.addArguments("--captureCoinMarketCap", "-cm", "captures CoinMarketCap data to update Cassandra database",
                             true, setCoinMarketCapCapture);
 
@@ -207,6 +318,35 @@ void TraderBot::populateArgumentsList() {
   m_arg_parser.addArguments("--legacyDatabaseDir", "-db", "takes legacy CoinMarketCap database directory as input",
                             false, setCSVDatabaseDirectory);
 
+  m_arg_parser.addArguments("--tickStore", "-ts",
+                            "takes local tick store directory as input, ticks are loaded from there instead of "
+                            "Cassandra",
+                            false, setTickStoreDirectory);
+
+  m_arg_parser.addArguments("--partitionCache", "-pc",
+                            "takes <dir>[:<max MB>] as input, past partitions are cached there instead of being loaded "
+                            "from Cassandra every run",
+                            false, setPartitionCache);
+
+  m_arg_parser.addArguments("--sharedTables", "-st",
+                            "stores all symbols of a type in one table, with the symbol in the partition key", true,
+                            enableSharedTables);
+
+  m_arg_parser.addArguments("--sparseCandles", "-sc",
+                            "takes an interval in seconds as input, candles up to it are stored only if they have "
+                            "ticks, flat candles in between are implied",
+                            false, setSparseCandles);
+
+  m_arg_parser.addArguments("--retention", "-rn",
+                            "takes <ticks>:<candles> as input, older data is evicted from memory while trading in "
+                            "real time",
+                            false, setRetention);
+
+  m_arg_parser.addArguments("--lazyIndicators", "-li",
+                            "computes indicator values only when an algo reads them, indicators logged to CSV are "
+                            "still computed with every candle",
+                            true, enableLazyIndicators);
+
   m_arg_parser.addArguments("--getDataInCSV", "-g", "takes a file containing timestamps, dump directory path as input",
                             false, getData);
 
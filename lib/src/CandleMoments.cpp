@@ -0,0 +1,116 @@
+//
+// Created by subhagato on 10/18/26.
+//
+
+#include "CandleMoments.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+candle_moments_t::candle_moments_t(const Candlestick& a_candle) : start_time(a_candle.getTimeStamp()) {
+  if ((a_candle.getTotalVolume() == 0) && (a_candle.getOpen() == 0) && (a_candle.getClose() == 0)) return;  // empty
+
+  num_ticks = 1;
+
+  open = a_candle.getOpen();
+  close = a_candle.getClose();
+  low = a_candle.getLow();
+  high = a_candle.getHigh();
+
+  volume = a_candle.getVolume();
+  weight = a_candle.getTotalVolume();
+
+  const double variance = a_candle.getStdDev() * a_candle.getStdDev();
+
+  if (weight > 0) {
+    mean = a_candle.getMean();
+    m2 = weight * variance;
+  } else {
+    count_mean = a_candle.getMean();
+    count_m2 = variance;
+  }
+}
+
+void candle_moments_t::add(const double a_price, const double a_size) {
+  const double price = abs(a_price);
+  const double size = abs(a_size);
+
+  if (num_ticks == 0) {
+    open = low = high = price;
+  } else {
+    low = min(low, price);
+    high = max(high, price);
+  }
+
+  close = price;
+  num_ticks++;
+  volume = volume + Volume(a_size);
+
+  double delta = price - count_mean;
+  count_mean += delta / static_cast<double>(num_ticks);
+  count_m2 += delta * (price - count_mean);
+
+  if (size == 0) return;
+
+  weight += size;
+  delta = price - mean;
+  mean += delta * size / weight;
+  m2 += size * delta * (price - mean);
+}
+
+void candle_moments_t::merge(const candle_moments_t& a_later) {
+  if (a_later.num_ticks == 0) return;
+
+  if (num_ticks == 0) {
+    const Time start = start_time;
+    *this = a_later;
+    start_time = start;
+    return;
+  }
+
+  low = min(low, a_later.low);
+  high = max(high, a_later.high);
+  close = a_later.close;
+  volume = volume + a_later.volume;
+
+  const double num_total = static_cast<double>(num_ticks + a_later.num_ticks);
+  double delta = a_later.count_mean - count_mean;
+
+  count_m2 += a_later.count_m2 + delta * delta * static_cast<double>(num_ticks) *
+                                     static_cast<double>(a_later.num_ticks) / num_total;
+  count_mean += delta * static_cast<double>(a_later.num_ticks) / num_total;
+  num_ticks += a_later.num_ticks;
+
+  if (a_later.weight == 0) return;
+
+  if (weight == 0) {
+    weight = a_later.weight;
+    mean = a_later.mean;
+    m2 = a_later.m2;
+    return;
+  }
+
+  const double weight_total = weight + a_later.weight;
+  delta = a_later.mean - mean;
+
+  m2 += a_later.m2 + delta * delta * weight * a_later.weight / weight_total;
+  mean += delta * a_later.weight / weight_total;
+  weight = weight_total;
+}
+
+Candlestick candle_moments_t::toCandlestick() const {
+  if (num_ticks == 0) {
+    Candlestick cs;
+    cs.setTimeStamp(start_time);
+    return cs;
+  }
+
+  const bool weighted = (weight > 0);
+
+  const double candle_mean = (weighted ? mean : count_mean);
+  const double variance = (weighted ? (m2 / weight) : (count_m2 / static_cast<double>(num_ticks)));
+
+  return Candlestick(start_time, open, close, low, high, candle_mean, sqrt(max(variance, 0.0)), volume);
+}
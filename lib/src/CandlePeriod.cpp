@@ -8,132 +8,306 @@
 #include "CoinAPITick.h"
 #include "Database.h"
 #include "Tick.h"
+#include "TickColumns.h"
 #include "TickPeriod.h"
 #include "utils/ErrorHandling.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <stdexcept>
+#include <thread>
 
 using namespace std;
 
-// only for adding to the end
-template <typename C, typename T>
-void addTickToExistingCandle(C& cs, const T& t) {
-  double price = t.getPrice();
-  double size = t.getSize();
+#define CANDLE_CONVERSION_MIN_TICKS_PER_JOB 65536  // below it, candles are built in a single pass without threads
 
-  Volume volume = cs.getVolume();
-  double mean = cs.getMean();
-  double high = cs.getHigh();
-  double low = cs.getLow();
-  double stddev = cs.getStdDev();
+template <typename C>
+void addCandleToExistingCandle(C& existing_cs, Duration existing_interval, C new_cs, Duration new_interval) {
+  Volume volume = existing_cs.getVolume();
+  double mean = existing_cs.getMean();
+  double high = existing_cs.getHigh();
+  double low = existing_cs.getLow();
+  double stddev = existing_cs.getStdDev();
 
-  // printf("volume = %lf, mean = %lf, high = %lf, low = %lf, stddev = %lf\n", volume, mean, high, low, stddev);
+  const double weight = static_cast<double>(volume);
+  const double new_weight = static_cast<double>(new_cs.getVolume());
+  const double weight_total = weight + new_weight;
+
+  // exact merge of the volume weighted moments (Chan et al.), same as candle_moments_t::merge
+  if (weight == 0) {
+    existing_cs.setMean(new_cs.getMean());
+    existing_cs.setStdDev(new_cs.getStdDev());
+  } else if (new_weight > 0) {
+    const double delta = new_cs.getMean() - mean;
+    const double m2 = weight * stddev * stddev + new_weight * new_cs.getStdDev() * new_cs.getStdDev() +
+                      delta * delta * weight * new_weight / weight_total;
+
+    existing_cs.setMean(mean + delta * new_weight / weight_total);
+    existing_cs.setStdDev(sqrt(max(m2, 0.0) / weight_total));
+  }
 
-  Volume volume_new;
-  double mean_new;
-  double stddev_new;
+  // smaller candles are added in time order
+  if (existing_cs.getTimeStamp() == new_cs.getTimeStamp())
+    existing_cs.setOpen(new_cs.getOpen());
+  else if (new_cs.getTimeStamp() < (existing_cs.getTimeStamp() + existing_interval))
+    existing_cs.setClose(new_cs.getClose());
+
+  existing_cs.setHigh(max(high, new_cs.getHigh()));
+  existing_cs.setLow(min(low, new_cs.getLow()));
+  existing_cs.setVolume(volume + new_cs.getVolume());
+}
 
-  // math taken from http://people.ds.cam.ac.uk/fanf2/hermes/doc/antiforgery/stats.pdf
+// moments of the candles covering ticks [a_start_idx, a_end_idx) in order, candles without ticks included
+template <typename T>
+void addTicksToCandleMoments(const TickPeriodT<T>& trade_period, const size_t a_start_idx, const size_t a_end_idx,
+                             const Duration a_interval, vector<candle_moments_t>& a_moments) {
+  int64_t cs_end = INT64_MIN;
 
-  double Sn;
-  double Sn_new;
+  for (size_t idx = a_start_idx; idx < a_end_idx; ++idx) {
+    const T& t = trade_period[idx];
 
-  volume_new = volume + Volume(size);
-  mean_new = (mean * static_cast<double>(volume) + price * abs(size)) / static_cast<double>(volume_new);
+    if (static_cast<int64_t>(t.getTimeStamp()) >= cs_end) {
+      const Time cs_start = t.getTimeStamp().quantize(a_interval);
 
-  Sn = static_cast<double>(volume) * pow(stddev, 2);
-  Sn_new = Sn + abs(size) * (price - mean) * (price - mean_new);
-  stddev_new = sqrt(std::abs(Sn_new) / static_cast<double>(volume_new));
+      if (!a_moments.empty()) {
+        for (Time empty_start = a_moments.back().start_time + a_interval; empty_start < cs_start;
+             empty_start += a_interval)
+          a_moments.emplace_back(empty_start);
+      }
 
-  // printf("volumeNew = %lf, meanNew = %lf, highNew = %lf, lowNew = %lf, stddevNew = %lf\n", volume_new, mean_new,
-  // max(high, price), min(low, price), stddev_new);
+      a_moments.emplace_back(cs_start);
+      cs_end = static_cast<int64_t>(cs_start + a_interval);
+    }
 
-  cs.setMean(mean_new);
-  cs.setStdDev(stddev_new);
-  cs.setClose(price);
-  cs.setHigh(max(high, price));
-  cs.setLow(min(low, price));
-  cs.setVolume(volume_new);
+    a_moments.back().add(t.getPrice(), t.getSize());
+  }
 }
 
-template <typename C>
-void addCandleToExistingCandle(C& existing_cs, Duration existing_interval, C new_cs, Duration new_interval) {
-  Volume volume = existing_cs.getVolume();
-  double mean = existing_cs.getMean();
-  double high = existing_cs.getHigh();
-  double low = existing_cs.getLow();
-  double stddev = existing_cs.getStdDev();
+// appends the moments of the next chunk of ticks, the candle split by the chunk boundary is merged
+static void appendCandleMoments(vector<candle_moments_t>& a_moments, const vector<candle_moments_t>& a_chunk,
+                                const Duration a_interval) {
+  if (a_chunk.empty()) return;
+
+  auto it = a_chunk.begin();
+
+  if (!a_moments.empty()) {
+    if (it->start_time <= a_moments.back().start_time) {
+      a_moments.back().merge(*it);
+      ++it;
+    } else {
+      for (Time empty_start = a_moments.back().start_time + a_interval; empty_start < it->start_time;
+           empty_start += a_interval)
+        a_moments.emplace_back(empty_start);
+    }
+  }
 
-  // PRINTF("volume = %lf, mean = %lf, high = %lf, low = %lf, stddev = %lf\n", volume, mean, high, low, stddev);
+  a_moments.insert(a_moments.end(), it, a_chunk.end());
+}
 
-  Volume volume_new;
-  double mean_new;
-  double stddev_new;
+// moments of coarser candles, a_interval is a multiple of the interval of a_moments
+static void deriveCandleMoments(const vector<candle_moments_t>& a_moments, const Duration a_interval,
+                                vector<candle_moments_t>& a_derived) {
+  for (auto& moments : a_moments) {
+    Time cs_start = moments.start_time;
+    cs_start.quantize(a_interval);
 
-  volume_new = volume + new_cs.getVolume();
-  mean_new = (mean * static_cast<double>(volume) + new_cs.getMean() * static_cast<double>(new_cs.getVolume())) /
-             static_cast<double>(volume_new);
+    if (a_derived.empty() || (a_derived.back().start_time != cs_start)) a_derived.emplace_back(cs_start);
 
-  // not accurate, just a placeholder
-  stddev_new = (stddev * static_cast<double>(volume) + new_cs.getStdDev() * static_cast<double>(new_cs.getVolume())) /
-               static_cast<double>(volume_new);
+    a_derived.back().merge(moments);
+  }
+}
 
-  // PRINTF("volumeNew = %lf, meanNew = %lf, highNew = %lf, lowNew = %lf, stddevNew = %lf\n", volume_new, mean_new,
-  // max(high, price), min(low, price), stddev_new);
+// replaces the candles of the period with the ones of a_moments
+template <typename T>
+void setCandlesFromMoments(const vector<candle_moments_t>& a_moments, CandlePeriodT<Candlestick, T>* ap_candle_period) {
+  ap_candle_period->clear();  // clear all existing candles
 
-  existing_cs.setMean(mean_new);
-  existing_cs.setStdDev(stddev_new);
+  if (a_moments.empty()) return;
 
-  if (existing_cs.getTimeStamp() == new_cs.getTimeStamp())
-    existing_cs.setOpen(new_cs.getMean());
-  else if ((existing_cs.getTimeStamp() + existing_interval - new_interval) == new_cs.getTimeStamp())
-    existing_cs.setClose(new_cs.getMean());
+  double last_price = ap_candle_period->getLastPrice();
 
-  existing_cs.setHigh(max(high, new_cs.getHigh()));
-  existing_cs.setLow(min(low, new_cs.getLow()));
-  existing_cs.setVolume(volume_new);
+  for (size_t idx = 0; idx < a_moments.size(); ++idx) {
+    const candle_moments_t& moments = a_moments[idx];
+    Candlestick new_cs = moments.toCandlestick();
+
+    if (moments.num_ticks > 0)
+      last_price = moments.close;
+    else if (ap_candle_period->isSparse())
+      continue;  // flat candles aren't stored
+
+    // candles without volume in between carry the last price, the last candle is kept as it is
+    if ((idx > 0) && ((idx + 1) < a_moments.size()) && (new_cs.getTotalVolume() == 0)) new_cs.setPrice(last_price);
+
+    ap_candle_period->append(new_cs);
+  }
+
+  ap_candle_period->setLastPrice(last_price);
+  ap_candle_period->setLastMoments(a_moments.back());
 }
 
 template <typename T>
 bool convertFromToCandlePeriodT(TickPeriodT<T>& trade_period, CandlePeriodT<Candlestick, T>* ap_candle_period) {
   if (trade_period.size() == 0) return false;
 
-  Time cs_start = trade_period.getFirstTimestamp().quantize(ap_candle_period->getInterval());
+  vector<candle_moments_t> moments;
+  addTicksToCandleMoments(trade_period, 0, trade_period.size(), ap_candle_period->getInterval(), moments);
+  setCandlesFromMoments(moments, ap_candle_period);
 
-  vector<double> price_arr;
-  vector<Volume> volume_arr;
+  return true;
+}
 
-  ap_candle_period->clear();  // clear all existing candles
+template <typename T>
+bool convertFromToCandlePeriodsT(TickPeriodT<T>& trade_period,
+                                 const vector<CandlePeriodT<Candlestick, T>*>& a_candle_periods) {
+  if ((trade_period.size() == 0) || a_candle_periods.empty()) return false;
+
+  // finer intervals first, a period is derived from the coarsest period whose interval divides its own
+  vector<CandlePeriodT<Candlestick, T>*> candle_periods = a_candle_periods;
+  sort(candle_periods.begin(), candle_periods.end(),
+       [](const CandlePeriodT<Candlestick, T>* a, const CandlePeriodT<Candlestick, T>* b) {
+         return a->getInterval() < b->getInterval();
+       });
+
+  const size_t num_periods = candle_periods.size();
+  vector<int> base_idx(num_periods, -1);
+  vector<size_t> root_idx;
+
+  for (size_t idx = 0; idx < num_periods; ++idx) {
+    const int64_t interval = candle_periods[idx]->getInterval().getDuration();
+
+    for (int base = static_cast<int>(idx) - 1; base >= 0; --base) {
+      if ((interval % candle_periods[base]->getInterval().getDuration()) == 0) {
+        base_idx[idx] = base;
+        break;
+      }
+    }
+
+    if (base_idx[idx] < 0) root_idx.push_back(idx);
+  }
+
+  // day chunks of the ticks, a chunk holds at least CANDLE_CONVERSION_MIN_TICKS_PER_JOB ticks
+  vector<size_t> chunk_starts = {0};
+
+  if (trade_period.size() >= (2 * CANDLE_CONVERSION_MIN_TICKS_PER_JOB)) {
+    const int32_t first_day = trade_period.front().getTimeStamp().days_since_epoch();
+    const int32_t last_day = trade_period.back().getTimeStamp().days_since_epoch();
 
-  bool beginning = true;
+    for (int32_t day = first_day + 1; day <= last_day; ++day) {
+      const Time day_start(day, 0);
+      const size_t day_idx = static_cast<size_t>(
+          lower_bound(trade_period.begin(), trade_period.end(), day_start,
+                      [](const T& t, const Time& a_time) { return t.getTimeStamp() < a_time; }) -
+          trade_period.begin());
 
-  for (auto it = trade_period.begin();;) {
-    if (beginning) {
-      price_arr.clear();
-      volume_arr.clear();
-      beginning = false;
+      if (((day_idx - chunk_starts.back()) >= CANDLE_CONVERSION_MIN_TICKS_PER_JOB) &&
+          ((trade_period.size() - day_idx) >= CANDLE_CONVERSION_MIN_TICKS_PER_JOB))
+        chunk_starts.push_back(day_idx);
     }
-    Duration current_interval = (it->getTimeStamp() - cs_start);
+  }
 
-    if (current_interval >= ap_candle_period->getInterval()) {
-      beginning = true;
-      Candlestick new_cs = Candlestick(cs_start, price_arr, volume_arr);
-      if (!ap_candle_period->empty() && new_cs.getTotalVolume() == 0) {
-        new_cs.setPrice(ap_candle_period->getLastPrice());
-      }
-      ap_candle_period->append(new_cs);
-      cs_start += ap_candle_period->getInterval();
-      continue;
+  chunk_starts.push_back(trade_period.size());
+
+  const size_t num_chunks = chunk_starts.size() - 1;
+  const size_t num_jobs = root_idx.size() * num_chunks;
+
+  vector<vector<candle_moments_t>> chunk_moments(num_jobs);
+  atomic<size_t> next_job(0);
+
+  // every worker takes the next (root interval, day chunk) which isn't built yet
+  auto build_chunks = [&]() {
+    for (size_t job = next_job++; job < num_jobs; job = next_job++) {
+      const size_t chunk = job % num_chunks;
+      const Duration interval = candle_periods[root_idx[job / num_chunks]]->getInterval();
+
+      addTicksToCandleMoments(trade_period, chunk_starts[chunk], chunk_starts[chunk + 1], interval,
+                              chunk_moments[job]);
     }
+  };
+
+#ifdef DISABLE_THREAD
+  build_chunks();
+#else
+  if (num_jobs == 1) {
+    build_chunks();
+  } else {
+    uint32_t concurentThreadsSupported = thread::hardware_concurrency();
+
+    // if possible decrease the cpu load.
+    if (concurentThreadsSupported > 1) concurentThreadsSupported--;
+
+    vector<thread> threads;
 
-    price_arr.push_back(abs(it->getPrice()));
-    volume_arr.push_back(Volume(it->getSize()));
-    ap_candle_period->setLastPrice(it->getPrice());
+    for (size_t i = 0; (i < num_jobs) && (i < concurentThreadsSupported); i++) threads.push_back(thread(build_chunks));
 
-    if ((++it) == trade_period.end()) {
-      ap_candle_period->append(Candlestick(cs_start, price_arr, volume_arr));
-      break;
+    for (auto&& t : threads) t.join();
+  }
+#endif
+
+  vector<vector<candle_moments_t>> moments(num_periods);
+
+  for (size_t root = 0; root < root_idx.size(); ++root) {
+    const size_t idx = root_idx[root];
+
+    for (size_t chunk = 0; chunk < num_chunks; ++chunk)
+      appendCandleMoments(moments[idx], chunk_moments[root * num_chunks + chunk], candle_periods[idx]->getInterval());
+  }
+
+  // bases come before the periods derived from them
+  for (size_t idx = 0; idx < num_periods; ++idx) {
+    if (base_idx[idx] >= 0)
+      deriveCandleMoments(moments[base_idx[idx]], candle_periods[idx]->getInterval(), moments[idx]);
+
+    setCandlesFromMoments(moments[idx], candle_periods[idx]);
+  }
+
+  return true;
+}
+
+template <typename T>
+bool updateCandleInCandlePeriodT(TickPeriodT<T>& trade_period, const Time a_start_time,
+                                 CandlePeriodT<Candlestick, T>* ap_candle_period) {
+  if (ap_candle_period->empty() || (a_start_time < ap_candle_period->front().getTimeStamp()) ||
+      (a_start_time > ap_candle_period->back().getTimeStamp()))
+    return false;  // candle isn't built yet
+
+  // candles are contiguous (one per interval), binary search if they aren't
+  const Duration interval = ap_candle_period->getInterval();
+  size_t candle_idx = static_cast<size_t>((a_start_time - ap_candle_period->front().getTimeStamp()) / interval);
+
+  if ((candle_idx >= ap_candle_period->size()) || ((*ap_candle_period)[candle_idx].getTimeStamp() != a_start_time)) {
+    auto cs_itr = lower_bound(ap_candle_period->begin(), ap_candle_period->end(), a_start_time,
+                              [](const Candlestick& cs, const Time& a_time) { return cs.getTimeStamp() < a_time; });
+
+    if ((cs_itr == ap_candle_period->end()) || (cs_itr->getTimeStamp() != a_start_time)) {
+      if (!ap_candle_period->isSparse()) return false;
+
+      // first tick of a flat candle, which isn't stored yet
+      Candlestick cs;
+      cs.setTimeStamp(a_start_time);
+      cs_itr = ap_candle_period->insert(cs_itr, cs);
     }
+
+    candle_idx = cs_itr - ap_candle_period->begin();
   }
 
+  Candlestick& cs = (*ap_candle_period)[candle_idx];
+
+  const Time end_time = a_start_time + interval;
+
+  auto start_itr = lower_bound(trade_period.begin(), trade_period.end(), a_start_time,
+                               [](const T& t, const Time& a_time) { return t.getTimeStamp() < a_time; });
+
+  candle_moments_t moments(a_start_time);
+
+  for (auto it = start_itr; (it != trade_period.end()) && (it->getTimeStamp() < end_time); it++)
+    moments.add(it->getPrice(), it->getSize());
+
+  if (moments.num_ticks == 0) return false;
+
+  cs = moments.toCandlestick();
+
+  if ((candle_idx + 1) == ap_candle_period->size()) ap_candle_period->setLastMoments(moments);
+
   return true;
 }
 
@@ -152,14 +326,27 @@ int appendTickInCandlePeriodT(const T& t, CandlePeriodT<Candlestick, T>* ap_cand
 
   if (ap_candle_period->empty())  // empty period
   {
-    Candlestick cs(t.getTimeStamp().quantize(candle_interval), price, price, price, price, price, 0, size);
+    candle_moments_t moments(t.getTimeStamp().quantize(candle_interval));
+    moments.add(price, size);
 
-    ap_candle_period->append(cs);
+    ap_candle_period->append(moments.toCandlestick());
+    ap_candle_period->setLastMoments(moments);
     ap_candle_period->setNonZeroSampleCount(1);
     return 2;
   }
 
-  while ((last_timestamp = ap_candle_period->getLastTimestamp()) <= (t.getTimeStamp() - candle_interval)) {
+  // flat candles aren't filled in a sparse period
+  if (ap_candle_period->isSparse() && (ap_candle_period->getLastTimestamp() <= (t.getTimeStamp() - candle_interval))) {
+    candle_moments_t moments(t.getTimeStamp().quantize(candle_interval));
+    moments.add(price, size);
+
+    ap_candle_period->append(moments.toCandlestick());
+    ap_candle_period->setLastMoments(moments);
+    new_cs_created = true;
+  }
+
+  while (!ap_candle_period->isSparse() &&
+         (last_timestamp = ap_candle_period->getLastTimestamp()) <= (t.getTimeStamp() - candle_interval)) {
     Candlestick cs;
     Duration time_difference = (t.getTimeStamp() - last_timestamp);
 
@@ -168,8 +355,11 @@ int appendTickInCandlePeriodT(const T& t, CandlePeriodT<Candlestick, T>* ap_cand
     if (time_difference >= candle_interval * 2)
       cs.setPrice(ap_candle_period->getLastPrice());
     else {
-      cs.setPrice(price);
-      cs.setVolume(size);
+      candle_moments_t moments(cs.getTimeStamp());
+      moments.add(price, size);
+
+      cs = moments.toCandlestick();
+      ap_candle_period->setLastMoments(moments);
     }
 
     ap_candle_period->append(cs);  // keep on filling candlesticks till the point
@@ -179,7 +369,16 @@ int appendTickInCandlePeriodT(const T& t, CandlePeriodT<Candlestick, T>* ap_cand
   if (!new_cs_created)  // add to existing candlestick
   {
     Candlestick& cs = ap_candle_period->back();  // get the latest candlestick
-    addTickToExistingCandle(cs, t);
+
+    // the last candle was built without its moments (loaded or converted from candles)
+    if (ap_candle_period->getLastMoments().start_time != cs.getTimeStamp())
+      ap_candle_period->setLastMoments(candle_moments_t(cs));
+
+    candle_moments_t moments = ap_candle_period->getLastMoments();
+    moments.add(price, size);
+
+    cs = moments.toCandlestick();
+    ap_candle_period->setLastMoments(moments);
   } else {
     // COUT << CRED << "Candlestick added for Tick-" << t.getUniqueID() << endl;
   }
@@ -199,6 +398,70 @@ bool CandlePeriod::convertFrom(TickPeriod& trade_period) {
   return convertFromToCandlePeriodT(trade_period, this);
 }
 
+template <>
+bool CandlePeriod::sConvertFrom(TickPeriod& trade_period, const vector<CandlePeriod*>& a_candle_periods) {
+  return convertFromToCandlePeriodsT(trade_period, a_candle_periods);
+}
+
+template <>
+bool CapiCandlePeriod::sConvertFrom(CapiTickPeriod& trade_period, const vector<CapiCandlePeriod*>& a_candle_periods) {
+  return convertFromToCandlePeriodsT(trade_period, a_candle_periods);
+}
+
+template <>
+bool CandlePeriod::convertFrom(const TickColumns& a_ticks) {
+  if (a_ticks.size() == 0) return false;
+
+  const Duration interval = getInterval();
+
+  vector<candle_moments_t> moments;
+  int64_t cs_end = INT64_MIN;
+
+  vector<tick_columns_t> spans;
+  a_ticks.getSpans(0, a_ticks.size(), spans);
+
+  for (auto& span : spans) {
+    for (size_t idx = 0; idx < span.num_ticks;) {
+      if (span.timestamp[idx] >= cs_end) {
+        const Time cs_start = Time(span.timestamp[idx]).quantize(interval);
+
+        if (!moments.empty()) {
+          for (Time empty_start = moments.back().start_time + interval; empty_start < cs_start;
+               empty_start += interval)
+            moments.emplace_back(empty_start);
+        }
+
+        moments.emplace_back(cs_start);
+        cs_end = static_cast<int64_t>(cs_start + interval);
+      }
+
+      // ticks of the current candle are contiguous in the span
+      size_t end_idx = idx + 1;
+      while ((end_idx < span.num_ticks) && (span.timestamp[end_idx] < cs_end)) end_idx++;
+
+      candle_moments_t& cs_moments = moments.back();
+      for (size_t tick_idx = idx; tick_idx < end_idx; ++tick_idx)
+        cs_moments.add(span.price[tick_idx], span.size[tick_idx]);
+
+      idx = end_idx;
+    }
+  }
+
+  setCandlesFromMoments(moments, this);
+
+  return true;
+}
+
+template <>
+bool CandlePeriod::updateCandle(TickPeriod& trade_period, const Time a_start_time) {
+  return updateCandleInCandlePeriodT(trade_period, a_start_time, this);
+}
+
+template <>
+bool CapiCandlePeriod::updateCandle(CapiTickPeriod& trade_period, const Time a_start_time) {
+  return updateCandleInCandlePeriodT(trade_period, a_start_time, this);
+}
+
 template <>
 bool CapiCandlePeriod::convertFrom(CapiTickPeriod& trade_period) {
   return convertFromToCandlePeriodT(trade_period, this);
@@ -293,11 +556,11 @@ int CandlePeriodT<C, T>::append(const C& cs) {
     return 1;  // added in the beginning
   }
 
-  if (getFirstTimestamp() == (timestamp + m_interval)) {
+  if ((getFirstTimestamp() == (timestamp + m_interval)) || (m_sparse && (timestamp < getFirstTimestamp()))) {
     m_first_ts = cs.getTimeStamp();
     this->push_front(cs);
     return 2;  // added in the beginning
-  } else if (getLastTimestamp() == (timestamp - m_interval)) {
+  } else if ((getLastTimestamp() == (timestamp - m_interval)) || (m_sparse && (timestamp > getLastTimestamp()))) {
     m_last_ts = cs.getTimeStamp();
     this->push_back(cs);
     return 1;  // added in the end
@@ -309,6 +572,22 @@ int CandlePeriodT<C, T>::append(const C& cs) {
   }
 }
 
+template <typename C, typename T>
+size_t CandlePeriodT<C, T>::evictFront(const size_t a_num_candles) {
+  if (this->size() < 2) return 0;
+
+  const size_t num_evicted = min(a_num_candles, this->size() - 1);
+  const size_t num_candles = getNumCandles();
+
+  this->erase(this->begin(), this->begin() + num_evicted);
+  m_first_ts = this->front().getTimeStamp();
+
+  // flat candles in between the evicted ones of a sparse period are gone too
+  m_num_evicted += (num_candles - getNumCandles());
+
+  return num_evicted;
+}
+
 template <typename C, typename T>
 int CandlePeriodT<C, T>::appendSmallerCandle(const C& cs, Duration interval) {
   if (m_interval.getDuration() % interval.getDuration() != 0) {
@@ -339,7 +618,8 @@ int CandlePeriodT<C, T>::appendSmallerCandle(const C& cs, Duration interval) {
     return 1;  // added to existing candlestick
   }
 
-  if (timestamp >= (getLastTimestamp() + m_interval) && timestamp < getLastTimestamp() + m_interval * 2) {
+  if (timestamp >= (getLastTimestamp() + m_interval) &&
+      (m_sparse || (timestamp < getLastTimestamp() + m_interval * 2))) {
     C new_cs = cs;
     new_cs.setTimeStamp(cs.getTimeStamp().quantize(m_interval));  // quantize timestamp to the bigger candlestick period
     m_last_ts = new_cs.getTimeStamp();
@@ -348,7 +628,7 @@ int CandlePeriodT<C, T>::appendSmallerCandle(const C& cs, Duration interval) {
     return 2;  // created candlestick at the end
   }
 
-  if (timestamp < getFirstTimestamp() && (timestamp >= getFirstTimestamp() - m_interval)) {
+  if (timestamp < getFirstTimestamp() && (m_sparse || (timestamp >= getFirstTimestamp() - m_interval))) {
     C new_cs = cs;
     new_cs.setTimeStamp(cs.getTimeStamp().quantize(m_interval));
     m_first_ts = new_cs.getTimeStamp();
@@ -360,6 +640,77 @@ int CandlePeriodT<C, T>::appendSmallerCandle(const C& cs, Duration interval) {
   return 0;
 }
 
+template <typename C, typename T>
+bool CandlePeriodT<C, T>::setSparse(const bool a_sparse) {
+  if (!this->empty() && (a_sparse != m_sparse)) {
+    CT_WARN << "Can't change the mode of a CandlePeriod which has candles.\n";
+    return false;
+  }
+
+  m_sparse = a_sparse;
+  return true;
+}
+
+template <typename C, typename T>
+size_t CandlePeriodT<C, T>::getNumCandles() const {
+  if (!m_sparse || this->empty()) return this->size();
+
+  return static_cast<size_t>((m_last_ts - m_first_ts) / m_interval) + 1;
+}
+
+template <typename C, typename T>
+C CandlePeriodT<C, T>::getCandle(const size_t a_idx) const {
+  if (!m_sparse) return this->at(a_idx);
+
+  return getCandleAt(m_first_ts + Duration(m_interval.getDuration() * static_cast<int64_t>(a_idx)));
+}
+
+template <typename C, typename T>
+C CandlePeriodT<C, T>::getCandleFromEnd(const size_t a_idx_from_back) const {
+  if (!m_sparse) return this->at(this->size() - a_idx_from_back - 1);
+
+  return getCandleAt(m_last_ts - Duration(m_interval.getDuration() * static_cast<int64_t>(a_idx_from_back)));
+}
+
+template <typename C, typename T>
+C CandlePeriodT<C, T>::getCandleAt(const Time a_start_time) const {
+  C candle;
+  getCandleRun(a_start_time, a_start_time + m_interval, candle);
+
+  return candle;
+}
+
+template <typename C, typename T>
+size_t CandlePeriodT<C, T>::getCandleRun(const Time a_start_time, const Time a_end_time, C& a_candle) const {
+  if (!m_sparse) {
+    a_candle = this->at(static_cast<size_t>((a_start_time - m_first_ts) / m_interval));
+    return 1;
+  }
+
+  // last stored candle starting at or before a_start_time
+  auto cs_itr = upper_bound(this->begin(), this->end(), a_start_time,
+                            [](const Time& a_time, const C& cs) { return a_time < cs.getTimeStamp(); });
+
+  if (cs_itr == this->begin()) throw out_of_range("candle is before the beginning of the CandlePeriod");
+
+  --cs_itr;
+
+  if (cs_itr->getTimeStamp() == a_start_time) {
+    a_candle = *cs_itr;
+    return 1;
+  }
+
+  a_candle = C();
+  a_candle.setTimeStamp(a_start_time);
+  a_candle.setPrice(cs_itr->getClose());
+
+  // the run ends at the next stored candle
+  Time run_end = a_end_time;
+  if (((++cs_itr) != this->end()) && (cs_itr->getTimeStamp() < run_end)) run_end = cs_itr->getTimeStamp();
+
+  return static_cast<size_t>(max<int64_t>((run_end - a_start_time) / m_interval, 1));
+}
+
 template <typename C, typename T>
 int CandlePeriodT<C, T>::storeToDatabase(Database<C>* db) {
   deque<C>& data = *this;
@@ -416,6 +767,8 @@ void CandlePeriodT<C, T>::clear() {
   m_last_ts = 0;
   m_non_zero_sample_count = 0;
   m_stored = false;
+  m_last_moments = candle_moments_t();
+  m_num_evicted = 0;
 }
 
 template class CandlePeriodT<Candlestick, Tick>;
@@ -14,50 +14,6 @@ const field_t Candlestick::m_fields = {{"open", "double"},       {"close", "doub
                                        {"buy_volume", "double"}, {"sell_volume", "double"}};
 const string Candlestick::m_type = "Candlestick";
 
-void* Candlestick::getMemberPtr(size_t i) {
-  switch (i) {
-    case 0:
-      return &(m_open);
-    case 1:
-      return &(m_close);
-    case 2:
-      return &(m_low);
-    case 3:
-      return &(m_high);
-    case 4:
-      return &(m_mean);
-    case 5:
-      return &(m_stddev);
-    case 6:
-      return &(m_volume.getBuyVolume());
-    case 7:
-      return &(m_volume.getSellVolume());
-    default:
-      return nullptr;
-  }
-}
-
-void Candlestick::setMemberPtr(void* value, size_t i) {
-  switch (i) {
-    case 0:
-      m_open = *(double*)value;
-    case 1:
-      m_close = *(double*)value;
-    case 2:
-      m_low = *(double*)value;
-    case 3:
-      m_high = *(double*)value;
-    case 4:
-      m_mean = *(double*)value;
-    case 5:
-      m_stddev = *(double*)value;
-    case 6:
-      m_volume = *(double*)value;
-    default:
-      assert(0);
-  }
-}
-
 Candlestick::Candlestick(const Time start_time, const vector<double>& price_arr, vector<Volume>& volume_arr)
     : Candlestick() {
   assert(price_arr.size() == volume_arr.size());
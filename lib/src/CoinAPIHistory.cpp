@@ -115,11 +115,10 @@ bool CoinAPIHistory::loadFromDatabase(Time start_time, Time end_time) {
   // clear previous data first
   clearData();
 
-  for (auto iter : m_trade_histories) {
-    iter.second->loadFromDatabase(start_time, end_time);
-  }
+  vector<CapiTradeHistory*> trade_histories;
+  for (auto iter : m_trade_histories) trade_histories.push_back(iter.second);
 
-  return true;
+  return CapiTradeHistory::sLoadFromDatabase(trade_histories, start_time, end_time);
 }
 
 void CoinAPIHistory::addEntry(const CurrencyPair a_currency_pair) {
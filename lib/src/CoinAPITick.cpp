@@ -23,29 +23,6 @@ CoinAPITick::CoinAPITick(const Time a_coinapi_time, const double a_price, const
   computeUniqueID(a_coinapi_time, a_exchange_id, TradeUtils::getUUIDHash(a_uuid, 16));
 }
 
-void* CoinAPITick::getMemberPtr(const size_t i) {
-  switch (i) {
-    case 0:
-      return &m_price;
-    case 1:
-      return &m_size;
-    default:
-      assert(0);
-  }
-  return NULL;
-}
-
-void CoinAPITick::setMemberPtr(const void* value, const size_t i) {
-  switch (i) {
-    case 0:
-      m_price = *(double*)value;
-    case 1:
-      m_size = *(double*)value;
-    default:
-      assert(0);
-  }
-}
-
 Time CoinAPITick::getTimeStamp() const {
   const Duration time_diff = Duration((m_flags >> 24) * 1000L);
   Time timestamp = (Time(2013, 0, 0, 0, 0, 0) + time_diff);
@@ -151,6 +151,8 @@ void Controller::init(const json& a_json) {
   // warm up trade algo
   mp_TradeAlgo->init(m_start_time, getConstPastTradeHistories());
 
+  if (m_mode == exchange_mode_t::SIMULATION) initSimulationCursors();
+
   initLogs();
 }
 
@@ -473,60 +475,64 @@ void Controller::cancelOrders(const exchange_t a_exchange_id) {
   }
 }
 
-bool Controller::getNextTradeForSimulation() {
-  if (m_mode != exchange_mode_t::SIMULATION) return false;
-
-  assert(m_end_time < (Time::sNow()));
-
-  exchange_t exchange_id = exchange_t::NOEXCHANGE;
+void Controller::initSimulationCursors() {
+  m_sim_cursors = decltype(m_sim_cursors)();
 
-  Tick new_tick;
-  CurrencyPair new_tick_currency_pair;
+  size_t pair_idx = 0;
 
   for (auto exchange_iter : m_exchanges) {
-    Exchange* p_exchange = exchange_iter.second;
-    VirtualExchange* p_vir_exchange = p_exchange->castVirtualExchange();
+    VirtualExchange* p_vir_exchange = exchange_iter.second->castVirtualExchange();
 
-    const vector<CurrencyPair>& trading_pairs = p_exchange->getTradingPairs();
+    const vector<CurrencyPair>& trading_pairs = exchange_iter.second->getTradingPairs();
 
     for (auto& currency_pair : trading_pairs) {
-      // get full trades and delayed trades
-      const TradeHistory* p_full_trade_history = p_vir_exchange->getFullTradeHistory(currency_pair);
-      const TradeHistory* p_past_trade_history = p_vir_exchange->getCurrentTradeHistory(currency_pair);
-
-      const TickPeriod* p_full_trade_period = p_full_trade_history->getTickPeriod();
-      const TickPeriod* p_past_trade_period = p_past_trade_history->getTickPeriod();
-
-      if (p_full_trade_period->size() > p_past_trade_period->size()) {
-        const Tick& next_tick = *(p_full_trade_period->begin() + p_past_trade_period->size());
-        if (((new_tick == Tick()) || (next_tick < new_tick)) && (next_tick.getTimeStamp() < m_end_time)) {
-          new_tick = next_tick;
-          new_tick_currency_pair = currency_pair;
-          exchange_id = p_exchange->getExchangeID();
-        }
-      }
+      sim_cursor_t cursor;
+      cursor.pair_idx = pair_idx++;
+      cursor.p_full_trade_history = p_vir_exchange->getFullTradeHistory(currency_pair);
+      cursor.p_past_trade_history = p_vir_exchange->getCurrentTradeHistory(currency_pair);
+
+      pushSimulationCursor(cursor);
     }
   }
+}
 
-  // step forward
-  if (exchange_id != exchange_t::NOEXCHANGE) {
-    adjustTimeAndCheckForIntervalEvents(new_tick.getTimeStamp());
+void Controller::pushSimulationCursor(sim_cursor_t& a_cursor) {
+  const TickPeriod* p_full_trade_period = a_cursor.p_full_trade_history->getTickPeriod();
+  const TickPeriod* p_past_trade_period = a_cursor.p_past_trade_history->getTickPeriod();
 
-    VirtualExchange* p_vir_exchange = getVirtualExchange(exchange_id);
+  // the pair is done when all its ticks before end time are added to the past trade history
+  if (p_full_trade_period->size() <= p_past_trade_period->size()) return;
 
-    // get full trades and delayed trades
-    const TradeHistory* p_full_trade_history = p_vir_exchange->getFullTradeHistory(new_tick_currency_pair);
-    TradeHistory* p_past_trade_history = p_vir_exchange->getCurrentTradeHistory(new_tick_currency_pair);
+  const Tick& next_tick = (*p_full_trade_period)[p_past_trade_period->size()];
+  if (next_tick.getTimeStamp() >= m_end_time) return;
 
-    updateTick(p_full_trade_history, p_past_trade_history);
+  a_cursor.timestamp = next_tick.getTimeStamp();
+  a_cursor.trade_id = next_tick.getUniqueID();
 
-    return true;
-  }
+  m_sim_cursors.push(a_cursor);
+}
+
+bool Controller::getNextTradeForSimulation() {
+  if (m_mode != exchange_mode_t::SIMULATION) return false;
+
+  assert(m_end_time < (Time::sNow()));
+
+  if (m_sim_cursors.empty()) return false;
+
+  sim_cursor_t cursor = m_sim_cursors.top();
+  m_sim_cursors.pop();
+
+  // step forward
+  adjustTimeAndCheckForIntervalEvents(cursor.timestamp);
+
+  updateTick(cursor.p_full_trade_history, cursor.p_past_trade_history);
+
+  pushSimulationCursor(cursor);
 
-  return false;
+  return true;
 }
 
-void Controller::doRealTimeTrading(const TradeHistory* ap_trade_history) {
+void Controller::doRealTimeTrading(const TradeHistory* ap_trade_history, const size_t a_num_new_ticks) {
   m_algo_event_mutex.lock();
 
   Exchange* p_exchange = m_exchanges[ap_trade_history->getExchangeId()];
@@ -540,12 +546,31 @@ void Controller::doRealTimeTrading(const TradeHistory* ap_trade_history) {
   p_past_trade_history = (m_mode != exchange_mode_t::REAL) ? p_vir_exchange->getCurrentTradeHistory(currency_pair)
                                                            : p_exchange->getDelayedTradeHistory(currency_pair);
 
-  updateTick(ap_trade_history, p_past_trade_history);
+  updateTick(ap_trade_history, p_past_trade_history, a_num_new_ticks);
 
   m_algo_event_mutex.unlock();
 }
 
-void Controller::updateTick(const TradeHistory* ap_full_trade_history, TradeHistory* ap_delayed_trade_history) {
+void Controller::doCandleUpdate(const TradeHistory* ap_trade_history, const Time a_from) {
+  m_algo_event_mutex.lock();
+
+  Exchange* p_exchange = m_exchanges[ap_trade_history->getExchangeId()];
+  VirtualExchange* p_vir_exchange = p_exchange->castVirtualExchange();
+
+  const CurrencyPair& currency_pair = ap_trade_history->getCurrencyPair();
+
+  TradeHistory* p_past_trade_history =
+      (m_mode != exchange_mode_t::REAL) ? p_vir_exchange->getCurrentTradeHistory(currency_pair)
+                                        : p_exchange->getDelayedTradeHistory(currency_pair);
+
+  // the delayed history is a view of the ticks, which now holds the late ones, but builds its own candles
+  p_past_trade_history->updateCandles(a_from);
+
+  m_algo_event_mutex.unlock();
+}
+
+void Controller::updateTick(const TradeHistory* ap_full_trade_history, TradeHistory* ap_delayed_trade_history,
+                            const size_t a_num_ticks) {
   const exchange_t exchange_id = ap_full_trade_history->getExchangeId();
   const CurrencyPair& currency_pair = ap_full_trade_history->getCurrencyPair();
 
@@ -560,7 +585,22 @@ void Controller::updateTick(const TradeHistory* ap_full_trade_history, TradeHist
   Tick new_tick = *(p_full_trade_period->begin() + p_delayed_trade_period->size());
   assert(new_tick != Tick());
 
-  ap_delayed_trade_history->appendTrade(new_tick);
+  if (a_num_ticks == 1) {
+    ap_delayed_trade_history->appendTrade(new_tick);
+  } else {
+    // ticks of a batch move the delayed history together, the algo only sees the last one
+    const size_t end_idx = min(p_delayed_trade_period->size() + a_num_ticks, p_full_trade_period->size());
+
+    TickPeriod new_ticks(p_full_trade_period->isConsecutive());
+    for (auto it = p_full_trade_period->begin() + p_delayed_trade_period->size();
+         it != p_full_trade_period->begin() + end_idx; ++it) {
+      Tick tick = *it;
+      new_ticks.append(tick);
+    }
+
+    ap_delayed_trade_history->appendTrades(new_ticks);
+    new_tick = new_ticks.back();
+  }
 
   Exchange* p_exchange = m_exchanges[exchange_id];
   VirtualExchange* p_vir_exchange = p_exchange->castVirtualExchange();
@@ -640,6 +680,14 @@ void Controller::addIndicators() {
             mp_TradeAlgo->getIndicators(p_exchange->getExchangeID(), interval, currency_pair);
         if (indicator) p_past_trade_history->addIndicator(interval, indicator);
       }
+
+      m_indicator_registry.addTo(p_past_trade_history);
+
+      for (auto p_indicator : mp_TradeAlgo->getContinuousIndicators()) {
+        if ((p_indicator->getExchangeId() == p_exchange->getExchangeID()) &&
+            (p_indicator->getCurrencyPair() == currency_pair))
+          p_past_trade_history->addContinuousIndicator(p_indicator);
+      }
     }
   }
 }
@@ -6,9 +6,15 @@
 #include "CMCandleStick.h"
 #include "Candlestick.h"
 #include "CoinAPITick.h"
+#include "PartitionCache.h"
 #include "Tick.h"
 #include "exchanges/Exchange.h"
+#include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <set>
+#include <thread>
+#include <tuple>
 
 using namespace std;
 
@@ -28,28 +34,57 @@ using namespace std;
 // table name : Database<Tick>::getTableName(exchange_t::GDAX, {currency_t::BTC, currency_t::USD}, true);
 
 template <typename T>
-Database<T>::Database(const string& key_space, const string& name, const bool a_consecutive, const bool a_check_insert)
-    : m_key_space(key_space), m_name(name), m_consecutive(a_consecutive), m_check_insert(a_check_insert) {
+Database<T>::Database(const string& key_space, const string& name, const bool a_consecutive, const bool a_check_insert,
+                      const bucket_width_t a_bucket_width, const string& a_symbol)
+    : m_key_space(key_space),
+      m_name(a_symbol.empty() ? name : name + ":" + a_symbol),
+      m_symbol(a_symbol),
+      m_consecutive(a_consecutive),
+      m_check_insert(a_check_insert) {
   m_table_name = key_space + "." + name;
   m_start_key = primary_key_t{0, 0, 0};
   m_end_key = primary_key_t{0, 0, 0};
 
+  m_use_prepared_statements = true;
+  m_max_writes_in_flight = CASS_MAX_WRITES_IN_FLIGHT;
+  m_use_existence_index = true;
+
+  // columns are selected in the order expected by DbUtils::readRow
+  m_select_columns = "date, time";
+  if (T::m_unique_id.first != "") m_select_columns += ", " + T::m_unique_id.first;
+  for (const auto& field : T::m_fields) m_select_columns += ", " + field.first;
+
   generateCreateTableQuery();
-  generateInsertQuery();
+  generateInsertQuery(false);
+  generateInsertQuery(true);
   generateSelectQuery();
   generateDeleteQuery();
 
+  m_newest_row_cql = generateSingleRowQuery(true);
+  m_oldest_row_cql = generateSingleRowQuery(false);
+
   if (T::m_unique_id.first != "")
     m_primary_key_fields = 5;
   else
     m_primary_key_fields = 3;
 
+  m_insert_fields = DbUtils::getNumKeyColumns<T>() + T::m_fields.size();
+
+  // symbol is bound after all other parameters
+  if (!m_symbol.empty()) {
+    m_primary_key_fields++;
+    m_insert_fields++;
+  }
+
   // COUT<<m_create_table_cql<<endl;
   // COUT<<m_insert_cql<<endl;
   // COUT<<m_select_cql<<endl;
   // COUT<<m_delete_cql<<endl;
 
-  m_db_metadata = new dbMetadata(key_space, name, T::m_type);
+  // partitions of a shared table have their own metadata row
+  m_db_metadata = new dbMetadata(key_space, m_name, T::m_type, a_bucket_width);
+
+  m_bucket = TimeBucket(m_db_metadata->getBucketWidth());
 }
 
 template <typename T>
@@ -57,6 +92,39 @@ Database<T>::~Database() {
   // COUT<<"Database " + m_name + " destructed\n" << endl;
 
   DELETE(m_db_metadata)
+
+  for (auto& prepared : m_prepared_statements) {
+    if (prepared.second) cass_prepared_free(prepared.second);
+  }
+}
+
+// creates a statement from the prepared form of the query, the query is prepared on its first use
+template <typename T>
+CassStatement* Database<T>::newCassStatement(const string& a_cql, size_t a_num_params) const {
+  if (m_use_prepared_statements && g_cass_session) {
+    lock_guard<mutex> lock(m_prepared_mutex);
+
+    auto prepared_itr = m_prepared_statements.find(a_cql);
+
+    if (prepared_itr == m_prepared_statements.end()) {
+      CassFuture* future = cass_session_prepare(g_cass_session, a_cql.c_str());
+      const CassPrepared* prepared = NULL;
+
+      if (cass_future_error_code(future) == CASS_OK)
+        prepared = cass_future_get_prepared(future);
+      else
+        CassServer::printError(future);
+
+      cass_future_free(future);
+
+      // failed ones are cached as NULL and executed as simple statements
+      prepared_itr = m_prepared_statements.insert(make_pair(a_cql, prepared)).first;
+    }
+
+    if (prepared_itr->second) return cass_prepared_bind(prepared_itr->second);
+  }
+
+  return cass_statement_new(a_cql.c_str(), a_num_params);
 }
 
 template <typename T>
@@ -65,6 +133,14 @@ string Database<T>::getTableName(exchange_t exchange_id, CurrencyPair currency_p
   return symbol;
 }
 
+template <typename T>
+string Database<T>::getSharedTableName() {
+  string name = T::m_type;
+  transform(name.begin(), name.end(), name.begin(), ::tolower);
+
+  return "shared_" + name;
+}
+
 template <typename T>
 bool Database<T>::generateCreateTableQuery() {
   stringstream query;
@@ -73,14 +149,15 @@ bool Database<T>::generateCreateTableQuery() {
   field_t row_fields;
 
   query << "CREATE TABLE IF NOT EXISTS " + m_table_name;
-  query << " (date int, time bigint";
+  query << " (" << (m_symbol.empty() ? "" : "symbol ascii, ") << "date int, time bigint";
 
   // unique id is empty if time stamp is the unique it
   if (T::m_unique_id.first != "") query << ", " << T::m_unique_id.first << " " << T::m_unique_id.second << " ";
 
   for (const auto& field : T::m_fields) query << ", " << field.first << " " << field.second;
 
-  query << ", PRIMARY KEY (date, time ";
+  // symbol is part of the partition key of a shared table
+  query << ", PRIMARY KEY (" << (m_symbol.empty() ? "date" : "(symbol, date)") << ", time ";
 
   // unique id is empty if time stamp is the unique it
   if (T::m_unique_id.first != "") query << ", " << T::m_unique_id.first;
@@ -115,6 +192,11 @@ bool Database<T>::generateInsertQuery(bool check_for_existance) {
     num_fields++;
   }
 
+  if (!m_symbol.empty()) {
+    query << ", symbol";
+    num_fields++;
+  }
+
   query << ") VALUES (";
 
   for (int i = 0; i < num_fields; i++) {
@@ -123,12 +205,13 @@ bool Database<T>::generateInsertQuery(bool check_for_existance) {
 
   query.seekp(-1, query.cur);
 
-  if (check_for_existance)
+  if (check_for_existance) {
     query << ") IF NOT EXISTS;";
-  else
+    m_insert_check_cql = query.str();
+  } else {
     query << ");";
-
-  m_insert_cql = query.str();
+    m_insert_cql = query.str();
+  }
 
   return true;
 }
@@ -141,12 +224,15 @@ bool Database<T>::generateSelectQuery(bool greater_equal, bool less_equal) {
 
   // unique id is empty if time stamp is the unique it
   if (T::m_unique_id.first != "") {
-    query << "SELECT * FROM " + m_table_name + " WHERE date = ? AND (time," << T::m_unique_id.first << ") >"
-          << left_equal << " (?,?) AND (time," << T::m_unique_id.first << ") <" << right_equal << " (?,?)";
+    query << "SELECT " + m_select_columns + " FROM " + m_table_name + " WHERE date = ? AND (time,"
+          << T::m_unique_id.first << ") >" << left_equal << " (?,?) AND (time," << T::m_unique_id.first << ") <"
+          << right_equal << " (?,?)";
   } else {
-    query << "SELECT * FROM " + m_table_name + " WHERE date = ? AND time >= ? AND time < ?";
+    query << "SELECT " + m_select_columns + " FROM " + m_table_name + " WHERE date = ? AND time >= ? AND time < ?";
   }
 
+  if (!m_symbol.empty()) query << " AND symbol = ?";
+
   m_select_cql = query.str();
 
   // COUT<<m_select_cql<<endl;
@@ -170,6 +256,8 @@ bool Database<T>::generateDeleteQuery(bool greater_equal, bool less_equal, bool
     } else {
       query << "DELETE FROM " + m_table_name + " WHERE date = ? AND time >= ? AND time < ?";
     }
+
+    if (!m_symbol.empty()) query << " AND symbol = ?";
   }
 
   m_delete_cql = query.str();
@@ -179,91 +267,57 @@ bool Database<T>::generateDeleteQuery(bool greater_equal, bool less_equal, bool
   return true;
 }
 
+// waits for the oldest write in flight, rows count as written if the query succeeded and (for IF NOT EXISTS) was
+// applied
 template <typename T>
-void Database<T>::executeCassStatements(vector<CassStatement*>& cass_statements, vector<bool>& result, size_t start,
-                                        size_t end) {
-  CassFuture* cass_future;
-  bool applied_result = true;
+void Database<T>::waitForOldestWrite(deque<pending_write_t>& pending_writes, vector<bool>& result) const {
+  const pending_write_t write = pending_writes.front();
 
-  for (size_t i = start; i < cass_statements.size(); i++) {
-    if (i == end) break;
+  pending_writes.pop_front();
 
-    cass_future = cass_session_execute(g_cass_session, cass_statements[i]);
+  bool applied_result = false;
 
-    cass_statement_free(cass_statements[i]);
+  const CassError rc = cass_future_error_code(write.future);
 
-    const CassError rc = cass_future_error_code(cass_future);
+  if (rc == CASS_OK) {
+    const CassResult* cass_result = cass_future_get_result(write.future);
 
-    if (rc == CASS_OK) {
-      const CassResult* cass_result = cass_future_get_result(cass_future);
+    const CassRow* cass_row = cass_result_first_row(cass_result);
 
-      const CassRow* cass_row = cass_result_first_row(cass_result);
+    cass_bool_t applied = cass_true;
 
-      if (cass_row) {
-        const CassValue* applied = cass_row_get_column(cass_row, 0);
+    if (cass_row) cass_value_get_bool(cass_row_get_column(cass_row, 0), &applied);
 
-        cass_value_get_bool(applied, (cass_bool_t*)&applied_result);
+    applied_result = (applied == cass_true);
 
-        result[i] = applied_result;
-      }
-
-      cass_result_free(cass_result);
+    cass_result_free(cass_result);
 
-    } else {
-      CassServer::printError(cass_future);
-      result[i] = false;
-    }
-
-    cass_future_free(cass_future);
+  } else {
+    CassServer::printError(write.future);
   }
 
-  return;
+  for (size_t row_idx = write.first_row; row_idx < (write.first_row + write.num_rows); row_idx++)
+    result[row_idx] = applied_result;
+
+  cass_future_free(write.future);
 }
 
 template <typename T>
-bool Database<T>::addStatementToCassBatch(T& row) {
-  if (!g_cass_session) return false;
-
-  int num_fields = (T::m_fields.size() + 2);
-
-  if (T::m_unique_id.first != "") num_fields++;
-
-  CassStatement* cass_statement = cass_statement_new(m_insert_cql.c_str(), num_fields);
+size_t Database<T>::addStatementToCassBatch(CassBatch* cass_batch, const T& row) const {
+  CassStatement* cass_statement = newCassStatement(m_insert_cql, m_insert_fields);
   bindRowToCassStatement(cass_statement, row);
 
-  cass_batch_add_statement(m_cass_batch, cass_statement);
+  cass_batch_add_statement(cass_batch, cass_statement);
   cass_statement_free(cass_statement);
 
-  return true;
+  return DbUtils::getRowBytes(row);
 }
 
 template <typename T>
 bool Database<T>::insertSingleRowToDatabase(T& row) {
-  if (!g_cass_session) return false;
-
-  g_critcal_task.lock();
-
-  vector<bool> result(1);
-
-  int num_fields = (T::m_fields.size() + 2);
-
-  if (T::m_unique_id.first != "") num_fields++;
-
-  generateInsertQuery(true);
-
-  vector<CassStatement*> cass_statement = {cass_statement_new(m_insert_cql.c_str(), num_fields)};
-
-  bindRowToCassStatement(cass_statement[0], row);
-
-  executeCassStatements(cass_statement, result);
-
   deque<T> v_row = {row};
 
-  updateMetadata(v_row.begin(), v_row.end(), result);
-
-  g_critcal_task.unlock();
-
-  return result[0];
+  return (insertMultipleRowsToDatabase(v_row.begin(), v_row.end()) == 1);
 }
 
 template <typename T>
@@ -271,107 +325,147 @@ size_t Database<T>::insertMultipleRowsToDatabase(typename deque<T>::iterator sta
                                                  typename deque<T>::iterator end_itr, bool check_if_exists) {
   if (!g_cass_session) return 0;
 
-  g_critcal_task.lock();
+  const size_t num_rows = distance(start_itr, end_itr);
 
-  int num_fields = (T::m_fields.size() + 2);
+  // one result per row in [start_itr, end_itr), skipped rows stay false
+  vector<bool> result(num_rows, false);
 
-  if (T::m_unique_id.first != "") num_fields++;
+  // without the index every checked row is ambiguous and goes through IF NOT EXISTS
+  const bool use_index = check_if_exists && m_use_existence_index;
+  vector<ExistenceIndex::existence_t> existence(num_rows, check_if_exists ? ExistenceIndex::cUnknown
+                                                                          : ExistenceIndex::cNew);
 
-#ifndef DISABLE_THREAD
-  uint32_t concurentThreadsSupported = thread::hardware_concurrency();
+  primary_key_t min_entry_key, max_entry_key;
+  bool empty_table = false;
 
-  // if possible decrease the cpu load.
-  if (concurentThreadsSupported > 1) concurentThreadsSupported--;
-#endif
+  if (use_index) {
+    lock_guard<mutex> lock(g_critcal_task);
 
-  size_t num_entries_inserted = 0;
+    // rows written by another process since the metadata was read aren't new, the gaps may have been filled by it
+    const size_t known_num_entries = m_db_metadata->getNumEntries();
+    const primary_key_t known_max_entry_key = m_db_metadata->getMaxEntryKey();
 
-#ifndef DISABLE_THREAD
-  vector<thread> threads;
-#endif
+    if (g_update_cass) m_db_metadata->getMetadata();
 
-  size_t num_rows = 0;
+    if ((m_db_metadata->getNumEntries() != known_num_entries) ||
+        (m_db_metadata->getMaxEntryKey() != known_max_entry_key))
+      m_existence_index.setGaps({});
 
-  vector<CassStatement*> cass_statements;
+    min_entry_key = m_db_metadata->getMinEntryKey();
+    max_entry_key = m_db_metadata->getMaxEntryKey();
+    empty_table = (m_db_metadata->getNumEntries() == 0);
+  }
 
-  generateInsertQuery(check_if_exists);
+  // counted from the first write till the rows are in the metadata, so a signal doesn't stop the process in between
+  beginWrite();
 
-  for (auto row_itr = start_itr; row_itr != end_itr; row_itr++) {
+  // writes executing on the driver's IO threads, oldest first
+  deque<pending_write_t> pending_writes;
+
+  size_t row_idx = 0;
+  size_t num_lwt = 0;
+
+  for (auto row_itr = start_itr; row_itr != end_itr; row_itr++, row_idx++) {
     if (row_itr->getTimeStamp() == Time(0)) continue;  // skip if time is 0
-    cass_statements.emplace_back(cass_statement_new(m_insert_cql.c_str(), num_fields));
-    bindRowToCassStatement(cass_statements.back(), *row_itr);
-    num_rows++;
-  }
 
-  vector<bool> result(num_rows, false);
+    if (use_index) {
+      existence[row_idx] = m_existence_index.claim(row_itr->getPrimaryKey(), row_itr->getUniqueID(), min_entry_key,
+                                                   max_entry_key, empty_table);
 
-#ifdef DISABLE_THREAD
-  executeCassStatements(cass_statements, result, 0, num_rows);
-#else
-  size_t step = ceil((float)num_rows / concurentThreadsSupported);
+      if (existence[row_idx] == ExistenceIndex::cExists) continue;
+    }
+
+    // backpressure: don't issue more writes till the oldest one is done
+    if (pending_writes.size() >= m_max_writes_in_flight) waitForOldestWrite(pending_writes, result);
+
+    const bool lwt = (existence[row_idx] == ExistenceIndex::cUnknown);
+    num_lwt += lwt;
 
-  for (size_t i = 0; i < num_rows; i += step) {
-    size_t start = i;
-    size_t end = i + step;
+    CassStatement* cass_statement = newCassStatement(lwt ? m_insert_check_cql : m_insert_cql, m_insert_fields);
+    bindRowToCassStatement(cass_statement, *row_itr);
 
-    if (end > num_rows) end = num_rows;
+    pending_writes.push_back({row_idx, 1, cass_session_execute(g_cass_session, cass_statement)});
 
-    threads.push_back(thread(&Database<T>::executeCassStatements, this, ref(cass_statements), ref(result), start, end));
+    cass_statement_free(cass_statement);
   }
 
-  for (auto&& t : threads) t.join();
-#endif
+  while (!pending_writes.empty()) waitForOldestWrite(pending_writes, result);
 
-  num_entries_inserted = updateMetadata(start_itr, end_itr, result, check_if_exists);
+  if (use_index) {
+    row_idx = 0;
 
-  g_critcal_task.unlock();
+    // rows claimed as new but not written have to be checked again next time
+    for (auto row_itr = start_itr; row_itr != end_itr; row_itr++, row_idx++)
+      if ((existence[row_idx] == ExistenceIndex::cNew) && !result[row_idx])
+        m_existence_index.erase(row_itr->getPrimaryKey(), row_itr->getUniqueID());
+
+    if (num_lwt) COUT << m_name << ": " << num_lwt << " of " << num_rows << " rows inserted with IF NOT EXISTS\n";
+  }
 
-  return num_entries_inserted;
+  return endWrite(start_itr, end_itr, result, check_if_exists);
 }
 
 template <typename T>
-bool Database<T>::createBatchSession() {
-  m_cass_batch = cass_batch_new(CASS_BATCH_TYPE_LOGGED);  // Unlogged for performance, atomicity is not guaranteed
-  return true;
+void Database<T>::beginWrite() const {
+  // a signal being handled holds the lock, so no write starts after the in flight ones drained
+  lock_guard<mutex> lock(g_critcal_task);
+  g_db_writes_in_flight++;
 }
 
 template <typename T>
-bool Database<T>::executeBatchSession() const {
-  CassFuture* batch_future = cass_session_execute_batch(g_cass_session, m_cass_batch);
+size_t Database<T>::endWrite(typename deque<T>::iterator start_itr, typename deque<T>::iterator end_itr,
+                             vector<bool>& results, bool check_if_exists, bool blind_write) {
+  size_t num_entries_added = 0;
 
-  /* Batch objects can be freed immediately after being executed */
-  cass_batch_free(m_cass_batch);
+  {
+    lock_guard<mutex> lock(g_critcal_task);
+    num_entries_added = updateMetadata(start_itr, end_itr, results, check_if_exists, blind_write);
+    g_db_writes_in_flight--;
+  }
 
-  /* This will block until the query has finished */
-  CassError rc = cass_future_error_code(batch_future);
+  g_db_writes_drained.notify_all();
 
-  if (rc != CASS_OK) {
-    CassServer::printError(batch_future);
-    // COUT<<"cass_future_custom_payload_item_count = "<<cass_future_custom_payload_item_count(batch_future)<<endl;
-    cass_future_free(batch_future);
-    return false;
-  } else {
-    cass_future_free(batch_future);
-    return true;
-  }
+  return num_entries_added;
 }
 
 template <typename T>
 size_t Database<T>::updateMetadata(typename deque<T>::iterator start_itr, typename deque<T>::iterator end_itr,
-                                   vector<bool>& results, bool check_if_exists) {
+                                   vector<bool>& results, bool check_if_exists, bool blind_write) {
   primary_key_t min_entry_key = m_db_metadata->getMinEntryKey();
   primary_key_t max_entry_key = m_db_metadata->getMaxEntryKey();
 
+  const primary_key_t last_stored_key = max_entry_key;
+  const primary_key_t consistent_key = m_db_metadata->getConsistentEntryKey();
+  const bool empty_table = (m_db_metadata->getNumEntries() == 0);
+
+  bool consistent_rows_written = false;  // rows of partitions which may be cached
+
   primary_key_t current_entry_key;
 
   int i = 0;
   size_t num_entries_added = 0;
+  size_t num_new_entries = 0;  // rows which didn't exist before
+  int32_t invalidated_bucket = -1;
 
   for (auto row_itr = start_itr; row_itr != end_itr; row_itr++) {
     if (results[i] == true) {
       num_entries_added++;
 
       current_entry_key = row_itr->getPrimaryKey();
+
+      // a blind write may have overwritten the row, only a row after the last stored one is surely new
+      if (!blind_write || empty_table || (current_entry_key > last_stored_key)) num_new_entries++;
+
+      if ((consistent_key.date > 0) && (current_entry_key <= consistent_key)) consistent_rows_written = true;
+
+      if (m_use_existence_index) m_existence_index.insert(current_entry_key, row_itr->getUniqueID());
+
+      // a cached partition doesn't have the new row
+      if (g_partition_cache && (m_bucket.getBucket(current_entry_key) != invalidated_bucket)) {
+        invalidated_bucket = m_bucket.getBucket(current_entry_key);
+        g_partition_cache->erase(getCacheKey(invalidated_bucket));
+      }
+
       if (current_entry_key > max_entry_key) max_entry_key = current_entry_key;
 
       if (current_entry_key < min_entry_key) min_entry_key = current_entry_key;
@@ -383,6 +477,8 @@ size_t Database<T>::updateMetadata(typename deque<T>::iterator start_itr, typena
     i++;
   }
 
+  if (consistent_rows_written) m_db_metadata->incrementGeneration();
+
   if (check_if_exists) {
     int num_entries_exists = m_db_metadata->getNumEntries();
 
@@ -392,7 +488,11 @@ size_t Database<T>::updateMetadata(typename deque<T>::iterator start_itr, typena
     if (num_entries_exists == 0 || max_entry_key != m_db_metadata->getMaxEntryKey())
       m_db_metadata->setMaxEntryKey(max_entry_key);
 
-    if (num_entries_added > 0) m_db_metadata->setNumEntries(num_entries_exists + num_entries_added);
+    if (num_new_entries > 0) m_db_metadata->setNumEntries(num_entries_exists + num_new_entries);
+
+    if (num_new_entries < num_entries_added)
+      COUT << m_name << ": " << (num_entries_added - num_new_entries)
+           << " rows written at or before the last entry aren't counted till the database is fixed\n";
 
     if (m_check_insert && results.size() > num_entries_added)
       CT_CRIT_WARN << "Number of entries attempted = " << results.size() << " but inserted = " << num_entries_added
@@ -448,52 +548,71 @@ size_t Database<T>::storeData(deque<T>& data, Time start_time, Time end_time, bo
 }
 
 template <typename T>
-bool Database<T>::storeDataInBatch(deque<T>& a_data) {
-  bool in_session = false;
-  int num_statements = 0;
-  bool rc = false;
-
+size_t Database<T>::storeDataInBatch(typename deque<T>::iterator start_itr, typename deque<T>::iterator end_itr) {
   if (!g_update_cass) {
     CT_CRIT_WARN << m_name << "Database update disabled\n";
-    return false;
+    return 0;
   }
 
-  if (a_data.size() == 0) return false;
+  if (!g_cass_session || (start_itr == end_itr)) return 0;
 
-  generateInsertQuery(false);
+  // one result per row in [start_itr, end_itr), skipped rows stay false
+  vector<bool> result(distance(start_itr, end_itr), false);
+
+  // counted till the rows are in the metadata, see insertMultipleRowsToDatabase
+  beginWrite();
 
-  for (auto& row : a_data) {
-    if (!in_session) {
-      createBatchSession();
-      in_session = true;
+  // batches executing on the driver's IO threads, oldest first
+  deque<pending_write_t> pending_batches;
+
+  auto row_itr = start_itr;
+  size_t row_idx = 0;
+
+  while (row_itr != end_itr) {
+    if (row_itr->getTimeStamp() == Time(0)) {  // skip if time is 0
+      row_itr++;
+      row_idx++;
+      continue;
     }
 
-    addStatementToCassBatch(row);
-    num_statements++;
+    // all statements of an unlogged batch go to the same partition, so the coordinator applies them at once
+    const int32_t bucket = m_bucket.getBucket(row_itr->getTimeStamp());
 
-    // inserting 25 elements at a time
-    if (num_statements >= CASS_MAX_BATCH_STATEMENTS) {
-      rc = executeBatchSession();
-      in_session = false;
+    CassBatch* cass_batch = cass_batch_new(CASS_BATCH_TYPE_UNLOGGED);
 
-      if (!rc) {
-        return false;
-      }
+    pending_write_t batch = {row_idx, 0, NULL};
+    size_t batch_bytes = 0;
 
-      // COUT << "Last Inserted data:" << row << endl;
-      num_statements = 0;
+    for (; (row_itr != end_itr) && (m_bucket.getBucket(row_itr->getTimeStamp()) == bucket) &&
+           (batch_bytes < CASS_MAX_BATCH_BYTES);
+         row_itr++, row_idx++) {
+      batch_bytes += addStatementToCassBatch(cass_batch, *row_itr);
+      batch.num_rows++;
     }
-  }
 
-  if (num_statements > 0) {
-    rc = executeBatchSession();
+    // backpressure: don't issue more batches till the oldest one is done
+    if (pending_batches.size() >= CASS_MAX_BATCHES_IN_FLIGHT) waitForOldestWrite(pending_batches, result);
 
-    if (!rc) {
-      return false;
-    }
+    batch.future = cass_session_execute_batch(g_cass_session, cass_batch);
+    pending_batches.push_back(batch);
+
+    /* Batch objects can be freed immediately after being executed */
+    cass_batch_free(cass_batch);
   }
 
-  return true;
+  while (!pending_batches.empty()) waitForOldestWrite(pending_batches, result);
+
+  // without IF NOT EXISTS the result doesn't tell whether a row already existed
+  return endWrite(start_itr, end_itr, result, true, true);
+}
+
+template <typename T>
+size_t Database<T>::storeDataInBatch(deque<T>& a_data) {
+  if (a_data.empty()) return 0;
+
+  TickPeriodT<T>::sFixTimestamps(a_data);
+
+  return storeDataInBatch(a_data.begin(), a_data.end());
 }
 
 template <typename T>
@@ -518,6 +637,12 @@ bool Database<T>::createTable() const {
     return false;
   }
 
+  // a shared table is created by its first symbol only, thousands of symbols shouldn't wait for schema queries
+  if (!m_symbol.empty()) {
+    lock_guard<mutex> lock(g_created_tables_mutex);
+    if (!g_created_tables.insert(m_table_name).second) return true;
+  }
+
   // create table if it doesn't exists
   CassServer::executeQuery(g_cass_session, m_create_table_cql.c_str(), false);
 
@@ -525,84 +650,223 @@ bool Database<T>::createTable() const {
 }
 
 template <typename T>
-int Database<T>::loadData(deque<T>& data, Time start_time, Time end_time) {
-  COUT << "loading data from database (" << m_name << "): start_time = " << start_time << " end_time = " << end_time
-       << endl;
+void Database<T>::addLoadQueries(deque<T>& data, Time start_time, Time end_time, vector<load_query_t>& queries) const {
+  if (start_time.days_since_epoch() == 0)
+    start_time = m_bucket.getTime(m_bucket.getBucket(getMetadata()->getMinEntryKey()), 0);
 
-  int32_t start_date = start_time.days_since_epoch();
-  int32_t end_date = end_time.days_since_epoch();
+  // end of last partition
+  if (end_time.days_since_epoch() == 0)
+    end_time = m_bucket.getTime(m_bucket.getBucket(getMetadata()->getMaxEntryKey()) + 1, 0);
 
-  Time start_time_of_day, end_time_of_day;
+  const int32_t start_bucket = m_bucket.getBucket(start_time);
+  const int32_t end_bucket = m_bucket.getBucket(end_time);
+  const int64_t end_of_bucket = static_cast<int64_t>(m_bucket.getTime(1, 0)) - 1;
 
-  int count = 0;
+  const primary_key_t consistent_key = getMetadata()->getConsistentEntryKey();
+  const Time consistent_time(consistent_key.date, consistent_key.time);
 
-  CassFuture* future;
+  for (int32_t bucket = start_bucket; bucket <= end_bucket; bucket++) {
+    const int64_t start_offset = (bucket == start_bucket) ? m_bucket.getOffset(start_time) : 0;
+    const int64_t end_offset = (bucket == end_bucket) ? m_bucket.getOffset(end_time) : end_of_bucket;
 
-  if (start_date == 0) {
-    start_date = m_db_metadata->getMinDate();
-    start_time_of_day = 0;
-  }
+    if (end_offset == 0) break;
 
-  if (end_date == 0) {
-    end_date = m_db_metadata->getMaxDate();
-    end_time_of_day = Time() + Duration(1, 0, 0, 0, 0, -1);  // end of day
+    // partitions before the consistent entry key don't change anymore
+    const bool cacheable =
+        g_partition_cache && (consistent_key.date > 0) && (m_bucket.getTime(bucket + 1, 0) <= consistent_time);
+
+    queries.push_back({this, &data, bucket, start_offset, end_offset, cacheable});
   }
+}
 
-  for (int32_t d = start_date; d <= end_date; d++) {
-    m_cass_statement = cass_statement_new(m_select_cql.c_str(), m_primary_key_fields);
+template <typename T>
+string Database<T>::getCacheKey(const int32_t a_bucket) const {
+  // the generation changes only when cached partitions may have changed, e.g. by a repair of another process
+  const string version = to_string(getMetadata()->getGeneration());
 
-    if (d == start_date)
-      start_time_of_day = start_time.micros_since_midnight();
-    else
-      start_time_of_day = 0;  // start of day
+  return PartitionCache::sMakeKey(m_key_space + "." + m_name, version, static_cast<int32_t>(m_bucket.getWidth()),
+                                  a_bucket);
+}
 
-    if (d == end_date) {
-      end_time_of_day = end_time.micros_since_midnight();
-      if (end_time_of_day == Time(0)) break;
-    } else {
-      end_time_of_day = Time() + Duration(1, 0, 0, 0, 0, -1);  // end of day
+template <typename T>
+void Database<T>::invalidateCache(const primary_key_t& a_start_key, const primary_key_t& a_end_key) const {
+  if (!g_partition_cache) return;
+
+  for (int32_t bucket = m_bucket.getBucket(a_start_key); bucket <= m_bucket.getBucket(a_end_key); bucket++)
+    g_partition_cache->erase(getCacheKey(bucket));
+}
+
+// a cached partition has all of its rows, only the ones selected by the query are loaded
+template <typename T>
+bool Database<T>::isInLoadQuery(const load_query_t& query, const T& row) const {
+  const int64_t offset = m_bucket.getOffset(row.getTimeStamp());
+
+  if (offset < query.start_offset) return false;
+
+  // same bounds as the select query, (time, unique id) < (end offset, INT64_MAX) includes the end offset
+  return (T::m_unique_id.first != "") ? (offset <= query.end_offset) : (offset < query.end_offset);
+}
+
+// executes partition queries in the given order, rows of a partition are appended to its data as they arrive.
+// Cacheable partitions are served from the local partition cache, or fetched completely and stored in it.
+template <typename T>
+int Database<T>::sRunLoadQueries(const vector<load_query_t>& queries) {
+  typedef struct running_query_t {
+    const load_query_t* query;
+    CassStatement* statement;  // NULL if served from the cache
+    CassFuture* future;
+    std::string cached_rows;  // encoded rows of the whole partition, from or to the cache
+  } running_query_t;
+
+  size_t next_query = 0;
+
+  int count = 0;
+
+  // partition queries in flight (in the given order), each one has the future of its next page
+  deque<running_query_t> day_queries;
+
+  for (;;) {
+    // keep CASS_LOAD_DAYS_IN_FLIGHT partitions queried while the oldest one is being decoded
+    while ((next_query < queries.size()) && (day_queries.size() < CASS_LOAD_DAYS_IN_FLIGHT)) {
+      const load_query_t& query = queries[next_query++];
+      const Database<T>* db = query.db;
+
+      day_queries.push_back({&query, NULL, NULL, ""});
+
+      if (query.cacheable && g_partition_cache->get(db->getCacheKey(query.bucket), day_queries.back().cached_rows))
+        continue;
+
+      // the whole partition is needed for the cache
+      const int64_t end_of_bucket = static_cast<int64_t>(db->m_bucket.getTime(1, 0)) - 1;
+      const int64_t start_offset = query.cacheable ? 0 : query.start_offset;
+      const int64_t end_offset = query.cacheable ? end_of_bucket : query.end_offset;
+
+      CassStatement* cass_statement = db->newCassStatement(db->m_select_cql, db->m_primary_key_fields);
+      db->bindQueryParamsToCassStatement(cass_statement, query.bucket, start_offset, end_offset);
+      cass_statement_set_paging_size(cass_statement, CASS_LOAD_PAGE_SIZE);
+
+      day_queries.back().statement = cass_statement;
+      day_queries.back().future = cass_session_execute(g_cass_session, cass_statement);
     }
 
-    bindQueryParamsToCassStatement(m_cass_statement, d, start_time_of_day, end_time_of_day);
+    if (day_queries.empty()) break;
 
-    future = cass_session_execute(g_cass_session, m_cass_statement);
+    running_query_t& running = day_queries.front();
+    const load_query_t* query = running.query;
+    const Database<T>* db = query->db;
 
-    cass_future_wait(future);
+    if (!running.statement) {
+      const char* p_bytes = running.cached_rows.data();
+      const char* p_end = p_bytes + running.cached_rows.size();
+
+      while (p_bytes < p_end) {
+        T row = DbUtils::readRowBinary<T>(p_bytes);
+
+        if (db->isInLoadQuery(*query, row)) {
+          query->data->push_back(row);
+          count++;
+        }
+      }
+
+      day_queries.pop_front();
+      continue;
+    }
+
+    bool has_more_pages = false;
+    bool failed = false;
+
+    CassError rc = cass_future_error_code(running.future);  // waits for the page
+    if (rc != CASS_OK) {
+      CassServer::printError(running.future);
+      cass_future_free(running.future);
+      failed = true;
+    } else {
+      const CassResult* result = cass_future_get_result(running.future);
+      cass_future_free(running.future);
+
+      // prefetch next page of the same partition before decoding the current one
+      has_more_pages = cass_result_has_more_pages(result);
+      if (has_more_pages) {
+        cass_statement_set_paging_state(running.statement, result);
+        running.future = cass_session_execute(g_cass_session, running.statement);
+      }
 
-    CassError rc = cass_future_error_code(future);
-    if (rc != CASS_OK)
-      CassServer::printError(future);
-    else {
-      const CassResult* result = cass_future_get_result(future);
       CassIterator* iterator = cass_iterator_from_result(result);
 
       while (cass_iterator_next(iterator)) {
-        const CassRow* row = cass_iterator_get_row(iterator);
-        data.push_back(getRowFromCassIterator(row));
+        const CassRow* cass_row = cass_iterator_get_row(iterator);
+        T row = db->getRowFromCassIterator(cass_row);
+
+        if (query->cacheable) {
+          DbUtils::writeRowBinary(running.cached_rows, row);
+          if (!db->isInLoadQuery(*query, row)) continue;
+        }
+
+        query->data->push_back(row);
         count++;
       }
 
-      cass_result_free(result);
       cass_iterator_free(iterator);
+      cass_result_free(result);
     }
 
-    cass_statement_free(m_cass_statement);
+    if (!has_more_pages) {
+      if (query->cacheable && !failed) g_partition_cache->put(db->getCacheKey(query->bucket), running.cached_rows);
+
+      cass_statement_free(running.statement);
+      day_queries.pop_front();
+    }
   }
 
   return count;
 }
 
 template <typename T>
-bool Database<T>::getSingleRow(string statement, T& row) {
+int Database<T>::loadData(deque<T>& data, Time start_time, Time end_time) {
+  COUT << "loading data from database (" << m_name << "): start_time = " << start_time << " end_time = " << end_time
+       << endl;
+
+  vector<load_query_t> queries;
+  addLoadQueries(data, start_time, end_time, queries);
+
+  return sRunLoadQueries(queries);
+}
+
+template <typename T>
+int Database<T>::sLoadData(const vector<Database<T>*>& a_dbs, const vector<deque<T>*>& a_data, Time start_time,
+                           Time end_time) {
+  ASSERT(a_dbs.size() == a_data.size());
+
+  COUT << "loading data of " << a_dbs.size() << " symbols from database: start_time = " << start_time
+       << " end_time = " << end_time << endl;
+
+  vector<load_query_t> queries;
+  for (size_t idx = 0; idx < a_dbs.size(); idx++)
+    a_dbs[idx]->addLoadQueries(*a_data[idx], start_time, end_time, queries);
+
+  // interleave the symbols by time, so all of them are fetched in one sweep over the time range. Partitions of the
+  // same symbol keep their order, rows of every symbol are appended in time order.
+  stable_sort(queries.begin(), queries.end(), [](const load_query_t& lhs, const load_query_t& rhs) {
+    return lhs.db->m_bucket.getTime(lhs.bucket, 0) < rhs.db->m_bucket.getTime(rhs.bucket, 0);
+  });
+
+  return sRunLoadQueries(queries);
+}
+
+template <typename T>
+bool Database<T>::getSingleRow(const string& cql, int32_t bucket, T& row) {
   CassFuture* future;
 
   bool found = false;
 
-  // COUT<<"statement = "<<statement<<endl;
+  // COUT<<"statement = "<<cql<<endl;
 
-  m_cass_statement = cass_statement_new(statement.c_str(), 0);
+  m_cass_statement = newCassStatement(cql, m_symbol.empty() ? 1 : 2);
+  DbUtils::cass_statement_bind_type(m_cass_statement, 0, bucket);
+  if (!m_symbol.empty()) DbUtils::cass_statement_bind_type(m_cass_statement, 1, m_symbol.c_str());
 
   future = cass_session_execute(g_cass_session, m_cass_statement);
+  cass_statement_free(m_cass_statement);
 
   cass_future_wait(future);
 
@@ -624,90 +888,57 @@ bool Database<T>::getSingleRow(string statement, T& row) {
     cass_iterator_free(iterator);
   }
 
+  cass_future_free(future);
+
   return found;
 }
 
 template <typename T>
-void Database<T>::bindRowToCassStatement(CassStatement* cass_statement, T& row) const {
-  int32_t date = row.getDate();
-  int64_t time = row.getTime();
-  int64_t unique_id = row.getUniqueID();
-
-  ASSERT(date >= 0);
-  ASSERT(time >= 0);
-
-  int num_keys = 2;
-
-  DbUtils::cass_statement_bind_type(cass_statement, 0, date);
-  DbUtils::cass_statement_bind_type(cass_statement, 1, time);
-
-  if (T::m_unique_id.first != "") {
-    DbUtils::cass_statement_bind_type(cass_statement, 2, unique_id);
-    num_keys++;
-  }
-
-  size_t i = 0;
+void Database<T>::bindRowToCassStatement(CassStatement* cass_statement, const T& row) const {
+  DbUtils::bindRow(cass_statement, row, m_bucket);
 
-  for (auto& row_field : T::m_fields) {
-    DbUtils::cass_statement_bind_type(cass_statement, (i + num_keys), row_field.second, row.getMemberPtr(i));
-    i++;
-  }
+  if (!m_symbol.empty()) DbUtils::cass_statement_bind_type(cass_statement, m_insert_fields - 1, m_symbol.c_str());
 }
 
 template <typename T>
 T Database<T>::getRowFromCassIterator(const CassRow* cass_row) const {
-  T row;
-  int32_t date;  // days since 1970-1-1
-  int64_t time;  // microseconds since midnight
-
-  DbUtils::cass_value_get_type(cass_row, "date", "int", &date);
-  DbUtils::cass_value_get_type(cass_row, "time", "bigint", &time);
-
-  // unique id is empty if time stamp is the unique it
-  if (T::m_unique_id.first != "")
-    DbUtils::cass_value_get_type(cass_row, T::m_unique_id.first, T::m_unique_id.second, row.getUniqueIdPtr());
-
-  // COUT<<"date = "<<date<<" time = "<<time<<endl;
-
-  row.setTimeStamp(Time(date, time));
-
-  size_t i = 0;
-  for (auto& row_field : T::m_fields)
-    DbUtils::cass_value_get_type(cass_row, row_field.first, row_field.second, row.getMemberPtr(i++));
-
-  return row;
+  return DbUtils::readRow<T>(cass_row, m_bucket);
 }
 
 template <typename T>
-void Database<T>::bindQueryParamsToCassStatement(CassStatement* cass_statement, int32_t date, Time time_start,
-                                                 Time time_end) const {
-  assert(date >= 0);
-  assert(time_start < time_end);
-  assert(time_start >= Time());
-  assert(time_end >= Time());
+void Database<T>::bindQueryParamsToCassStatement(CassStatement* cass_statement, int32_t bucket, int64_t offset_start,
+                                                 int64_t offset_end) const {
+  assert(bucket >= 0);
+  assert(offset_start < offset_end);
+  assert(offset_start >= 0);
 
   size_t count = 0;
 
-  DbUtils::cass_statement_bind_type(cass_statement, count++, date);
-  DbUtils::cass_statement_bind_type(cass_statement, count++, time_start.micros_since_midnight());
+  DbUtils::cass_statement_bind_type(cass_statement, count++, bucket);
+  DbUtils::cass_statement_bind_type(cass_statement, count++, offset_start);
   if (T::m_unique_id.first != "") DbUtils::cass_statement_bind_type(cass_statement, count++, static_cast<int64_t>(0));
-  DbUtils::cass_statement_bind_type(cass_statement, count++, time_end.micros_since_midnight());
-  if (T::m_unique_id.first != "") DbUtils::cass_statement_bind_type(cass_statement, count, INT64_MAX);
+  DbUtils::cass_statement_bind_type(cass_statement, count++, offset_end);
+  if (T::m_unique_id.first != "") DbUtils::cass_statement_bind_type(cass_statement, count++, INT64_MAX);
+  if (!m_symbol.empty()) DbUtils::cass_statement_bind_type(cass_statement, count++, m_symbol.c_str());
 }
 
 template <typename T>
 void Database<T>::bindQueryParamsToCassStatement(CassStatement* cass_statement, primary_key_t start_key,
                                                  primary_key_t end_key) const {
-  ASSERT(end_key.date == start_key.date);
+  const Time start_time(start_key.date, start_key.time);
+  const Time end_time(end_key.date, end_key.time);
+
+  ASSERT(m_bucket.getBucket(start_time) == m_bucket.getBucket(end_time));
   ASSERT(end_key >= start_key);
 
   size_t count = 0;
 
-  DbUtils::cass_statement_bind_type(cass_statement, count++, start_key.date);
-  DbUtils::cass_statement_bind_type(cass_statement, count++, start_key.time);
+  DbUtils::cass_statement_bind_type(cass_statement, count++, m_bucket.getBucket(start_time));
+  DbUtils::cass_statement_bind_type(cass_statement, count++, m_bucket.getOffset(start_time));
   if (T::m_unique_id.first != "") DbUtils::cass_statement_bind_type(cass_statement, count++, start_key.unique_id);
-  DbUtils::cass_statement_bind_type(cass_statement, count++, end_key.time);
-  if (T::m_unique_id.first != "") DbUtils::cass_statement_bind_type(cass_statement, count, end_key.unique_id);
+  DbUtils::cass_statement_bind_type(cass_statement, count++, m_bucket.getOffset(end_time));
+  if (T::m_unique_id.first != "") DbUtils::cass_statement_bind_type(cass_statement, count++, end_key.unique_id);
+  if (!m_symbol.empty()) DbUtils::cass_statement_bind_type(cass_statement, count++, m_symbol.c_str());
 }
 
 template <typename T>
@@ -718,10 +949,13 @@ void Database<T>::restoreDataFromCSVFile(const string& a_filename, std::vector<i
   }
 
   deque<T> data_arr;
+  size_t num_rows = 0;
 
   ifstream file(a_filename.c_str());
   string line;
 
+  const Time restore_start = Time::sNow();
+
   getline(file, line);  // read header
 
   while (getline(file, line)) {
@@ -734,7 +968,8 @@ void Database<T>::restoreDataFromCSVFile(const string& a_filename, std::vector<i
 
     // inserting 25000 elements at a time
     if (data_arr.size() == (CASS_MAX_BATCH_STATEMENTS * 1000)) {
-      storeData(data_arr, Time(), Time(), false);
+      storeDataInBatch(data_arr);
+      num_rows += data_arr.size();
 
       COUT << "Last Inserted data in " << m_name << ":" << data_arr.back() << endl;
 
@@ -742,7 +977,12 @@ void Database<T>::restoreDataFromCSVFile(const string& a_filename, std::vector<i
     }
   }
 
-  storeData(data_arr);
+  storeDataInBatch(data_arr);
+  num_rows += data_arr.size();
+
+  const double restore_secs = (Time::sNow() - restore_start).getDuration() / 1e6;
+  COUT << "Inserted " << num_rows << " rows in " << m_name << " (" << (num_rows / max(restore_secs, 1e-6))
+       << " rows/sec)\n";
 
   COUT << CYELLOW << "Repairing " << m_name << " database after loading CSV file" << endl;
   primary_key_t last_examined;
@@ -776,38 +1016,35 @@ void Database<T>::saveDataToCSVFile(const string& a_filename, const Time a_start
 }
 
 template <typename T>
-string Database<T>::generateSingleRowQuery(int32_t date, bool latest) const {
+string Database<T>::generateSingleRowQuery(bool latest) const {
   stringstream query;
 
   if (latest) {
     // unique id is empty if time stamp is the unique it
     if (T::m_unique_id.first != "")
-      query << "SELECT * FROM " + m_table_name + " WHERE date = " << date << " ORDER BY time DESC, "
+      query << "SELECT " + m_select_columns + " FROM " + m_table_name + " WHERE date = ? ORDER BY time DESC, "
             << T::m_unique_id.first << " DESC LIMIT 1";
     else
-      query << "SELECT * FROM " + m_table_name + " WHERE date = " << date << " ORDER BY time DESC LIMIT 1";
+      query << "SELECT " + m_select_columns + " FROM " + m_table_name + " WHERE date = ? ORDER BY time DESC LIMIT 1";
   } else
-    query << "SELECT * FROM " + m_table_name + " WHERE date = " << date << " LIMIT 1";
+    query << "SELECT " + m_select_columns + " FROM " + m_table_name + " WHERE date = ? LIMIT 1";
+
+  string cql = query.str();
 
-  return query.str();
+  // rows of a symbol in a shared table, the symbol is bound after the date
+  if (!m_symbol.empty()) cql.insert(cql.find("date = ?") + 8, " AND symbol = ?");
+
+  return cql;
 }
 
 template <typename T>
 bool Database<T>::getNewestRow(T& row) {
-  string statement;
-
-  statement = generateSingleRowQuery(m_db_metadata->getMaxDate(), true);
-
-  return getSingleRow(statement, row);
+  return getSingleRow(m_newest_row_cql, m_bucket.getBucket(m_db_metadata->getMaxEntryKey()), row);
 }
 
 template <typename T>
 bool Database<T>::getOldestRow(T& row) {
-  string statement;
-
-  statement = generateSingleRowQuery(m_db_metadata->getMinDate(), false);
-
-  return getSingleRow(statement, row);
+  return getSingleRow(m_oldest_row_cql, m_bucket.getBucket(m_db_metadata->getMinEntryKey()), row);
 }
 
 template <typename T>
@@ -823,6 +1060,69 @@ bool Database<T>::updateOldestEntryMetadata() {
   return true;
 }
 
+// scans the rows of a single partition in [a_start_key, a_end_key] bounds of a_cql, checks discontinuities within it
+template <typename T>
+void Database<T>::scanBucket(const string& a_cql, const primary_key_t a_start_key, const primary_key_t a_end_key,
+                             bucket_scan_t& a_bucket_scan) const {
+  a_bucket_scan.valid = false;
+  a_bucket_scan.num_entries = 0;
+  a_bucket_scan.discontinuities.clear();
+
+  CassStatement* cass_statement = newCassStatement(a_cql, m_primary_key_fields);
+  bindQueryParamsToCassStatement(cass_statement, a_start_key, a_end_key);
+  cass_statement_set_paging_size(cass_statement, CASS_LOAD_PAGE_SIZE);
+
+  bool has_more_pages = true;
+
+  while (has_more_pages) {
+    CassFuture* cass_future = cass_session_execute(g_cass_session, cass_statement);
+
+    if (cass_future_error_code(cass_future) != CASS_OK) {
+      CassServer::printError(cass_future);
+      cass_future_free(cass_future);
+      cass_statement_free(cass_statement);
+      return;
+    }
+
+    const CassResult* cass_result = cass_future_get_result(cass_future);
+    cass_future_free(cass_future);
+
+    CassIterator* cass_iterator = cass_iterator_from_result(cass_result);
+
+    while (cass_iterator_next(cass_iterator)) {
+      const T row = getRowFromCassIterator(cass_iterator_get_row(cass_iterator));
+      const primary_key_t curr_key = row.getPrimaryKey();
+      const int64_t current_unique_id = row.getUniqueID();
+
+      if (a_bucket_scan.num_entries == 0) {
+        a_bucket_scan.first_key = curr_key;
+        a_bucket_scan.first_unique_id = current_unique_id;
+        a_bucket_scan.max_key = curr_key;
+      } else {
+        if (m_consecutive && (a_bucket_scan.last_unique_id > 0) &&
+            (current_unique_id != (a_bucket_scan.last_unique_id + 1)))
+          a_bucket_scan.discontinuities.emplace_back(make_pair(a_bucket_scan.last_key, curr_key));
+
+        if (curr_key > a_bucket_scan.max_key) a_bucket_scan.max_key = curr_key;
+      }
+
+      a_bucket_scan.last_key = curr_key;
+      a_bucket_scan.last_unique_id = current_unique_id;
+      a_bucket_scan.num_entries++;
+    }
+
+    has_more_pages = cass_result_has_more_pages(cass_result);
+    if (has_more_pages) cass_statement_set_paging_state(cass_statement, cass_result);
+
+    cass_iterator_free(cass_iterator);
+    cass_result_free(cass_result);
+  }
+
+  cass_statement_free(cass_statement);
+
+  a_bucket_scan.valid = true;
+}
+
 template <typename T>
 bool Database<T>::fixDatabase(bool full_scan, bool fix_metadata, primary_key_t& min_key, primary_key_t& max_key,
                               primary_key_t& last_key, int64_t& num_entries,
@@ -836,7 +1136,6 @@ bool Database<T>::fixDatabase(bool full_scan, bool fix_metadata, primary_key_t&
 
   int64_t entries_skipped = 0;
   int64_t last_unique_id = -1;
-  int64_t current_unique_id;
   int64_t entries_examined = 0;
   uint64_t total_entries;
 
@@ -861,32 +1160,91 @@ bool Database<T>::fixDatabase(bool full_scan, bool fix_metadata, primary_key_t&
 
   end_key = {time_now.days_since_epoch(), time_now.micros_since_midnight(), INT64_MAX};
 
+  // the scan covers the same keys as iterating over setScope(start_key, end_key, false, false)
   setScope(start_key, end_key, false, false);
+  const string scan_cql = m_select_cql;
+  generateSelectQuery();  // restore back default search query
 
-  for (auto tick : *this) {
-    current_unique_id = tick.getUniqueID();
-    curr_key = tick.getPrimaryKey();
-
-    if (last_unique_id < 0) min_key = tick.getPrimaryKey();
+  const int32_t start_bucket = m_bucket.getBucket(start_key);
+  const int32_t end_bucket = m_bucket.getBucket(end_key);
+  const int32_t num_buckets = max(end_bucket - start_bucket + 1, 0);
+  vector<bucket_scan_t> bucket_scans(num_buckets);
+  atomic<int32_t> next_bucket(0);
+
+  // every worker takes the next partition which isn't scanned yet
+  auto scan_buckets = [&]() {
+    for (int32_t bucket_idx = next_bucket++; bucket_idx < num_buckets; bucket_idx = next_bucket++) {
+      const int32_t bucket = start_bucket + bucket_idx;
+      bucket_scan_t& bucket_scan = bucket_scans[bucket_idx];
+
+      const primary_key_t start_bucket_key = (bucket == start_bucket) ? start_key : m_bucket.getStartKey(bucket);
+      const primary_key_t end_bucket_key = (bucket == end_bucket) ? end_key : m_bucket.getEndKey(bucket);
+
+      // nothing to scan in the last partition
+      if (Time(end_bucket_key.date, end_bucket_key.time) == m_bucket.getTime(bucket, 0)) {
+        bucket_scan.valid = true;
+        bucket_scan.num_entries = 0;
+        continue;
+      }
 
-    if (m_consecutive && last_unique_id > 0 && current_unique_id != (last_unique_id + 1)) {
-      discontinuity_id_pairs.emplace_back(make_pair(prev_key, curr_key));
-      COUT << discontinuity_id_pairs.size() << ". Discontinuity from [" << prev_key.date << "," << last_unique_id
-           << "] to [" << curr_key.date << "," << current_unique_id << "] " << (current_unique_id - last_unique_id - 1)
-           << " entries." << endl;
-      repair_needed = true;
+      scanBucket(scan_cql, start_bucket_key, end_bucket_key, bucket_scan);
     }
+  };
+
+#ifdef DISABLE_THREAD
+  scan_buckets();
+#else
+  uint32_t concurentThreadsSupported = thread::hardware_concurrency();
 
-    last_unique_id = current_unique_id;
+  // if possible decrease the cpu load.
+  if (concurentThreadsSupported > 1) concurentThreadsSupported--;
+
+  vector<thread> threads;
+
+  for (int32_t i = 0; (i < num_buckets) && (i < static_cast<int32_t>(concurentThreadsSupported)); i++)
+    threads.push_back(thread(scan_buckets));
+
+  for (auto&& t : threads) t.join();
+#endif
+
+  auto add_discontinuity = [&](const primary_key_t& from_key, const primary_key_t& to_key) {
+    discontinuity_id_pairs.emplace_back(make_pair(from_key, to_key));
+    COUT << discontinuity_id_pairs.size() << ". Discontinuity from [" << from_key.date << "," << from_key.unique_id
+         << "] to [" << to_key.date << "," << to_key.unique_id << "] " << (to_key.unique_id - from_key.unique_id - 1)
+         << " entries." << endl;
+    repair_needed = true;
+  };
+
+  // merge the partitions in order, gaps between two partitions are found here
+  for (auto& bucket_scan : bucket_scans) {
+    if (!bucket_scan.valid) break;  // scan stops at the first failed query
+
+    if (bucket_scan.num_entries == 0) continue;
+
+    if (last_unique_id < 0) min_key = bucket_scan.first_key;
+
+    if (m_consecutive && last_unique_id > 0 && bucket_scan.first_unique_id != (last_unique_id + 1))
+      add_discontinuity(prev_key, bucket_scan.first_key);
+
+    for (auto& discontinuity : bucket_scan.discontinuities)
+      add_discontinuity(discontinuity.first, discontinuity.second);
+
+    last_unique_id = bucket_scan.last_unique_id;
+    curr_key = bucket_scan.last_key;
     prev_key = curr_key;
-    entries_examined++;
+    entries_examined += bucket_scan.num_entries;
 
-    if (curr_key > max_key) max_key = curr_key;
+    if (bucket_scan.max_key > max_key) max_key = bucket_scan.max_key;
   }
 
-  generateSelectQuery();  // restore back default search query
+  // nothing is stored inside the discontinuities, so rows filling them don't need IF NOT EXISTS
+  m_existence_index.setGaps(discontinuity_id_pairs);
+
+  // partitions with discontinuities will be refilled
+  for (auto& discontinuity : discontinuity_id_pairs) invalidateCache(discontinuity.first, discontinuity.second);
 
   total_entries = (entries_examined + entries_skipped);
+  num_entries = static_cast<int64_t>(total_entries);
 
   if (fix_metadata) {
     g_critcal_task.lock();
@@ -895,6 +1253,7 @@ bool Database<T>::fixDatabase(bool full_scan, bool fix_metadata, primary_key_t&
       m_db_metadata->setNumEntries(0);
       m_db_metadata->setMinEntryKey({INT32_MAX, 0, INT64_MAX});
       m_db_metadata->setMaxEntryKey({0, 0, 0});
+      g_critcal_task.unlock();
       return false;
     }
 
@@ -939,23 +1298,45 @@ size_t Database<T>::deleteData(Time start_time, Time end_time) {
     return 0;
   }
 
-  COUT << "delete data from database (" << m_name << "): from = " << start_time << " to = " << end_time << endl;
+  // dropping the table would delete the rows of every symbol of a shared table, tables are dropped by sDropTable
+  if (start_time == Time() && end_time == Time()) {
+    CT_CRIT_WARN << m_name << ": deleting all rows isn't supported, a time range should be given\n";
+    return 0;
+  }
 
-  int32_t start_date = start_time.days_since_epoch();
-  int32_t end_date = end_time.days_since_epoch();
+  COUT << "delete data from database (" << m_name << "): from = " << start_time << " to = " << end_time << endl;
 
-  Time start_time_of_day, end_time_of_day;
+  // deleted rows may be in the index
+  m_existence_index.clear();
 
   CassFuture* future;
 
   int count = 0;
 
-  if (start_time == Time() && end_time == Time()) {
-    assert(0);  // disable full table delete for now
+  generateDeleteQuery(true, false, false);
+
+  if (start_time.days_since_epoch() == 0)
+    start_time = m_bucket.getTime(m_bucket.getBucket(getMetadata()->getMinEntryKey()), 0);
+
+  // end of last partition
+  if (end_time.days_since_epoch() == 0)
+    end_time = m_bucket.getTime(m_bucket.getBucket(getMetadata()->getMaxEntryKey()) + 1, 0);
+
+  const int32_t start_bucket = m_bucket.getBucket(start_time);
+  const int32_t end_bucket = m_bucket.getBucket(end_time);
+  const int64_t end_of_bucket = static_cast<int64_t>(m_bucket.getTime(1, 0)) - 1;
+
+  for (int32_t bucket = start_bucket; bucket <= end_bucket; bucket++) {
+    const int64_t start_offset = (bucket == start_bucket) ? m_bucket.getOffset(start_time) : 0;
+    const int64_t end_offset = (bucket == end_bucket) ? m_bucket.getOffset(end_time) : end_of_bucket;
+
+    if (end_offset == 0) break;
 
-    generateDeleteQuery(true, false, true);
+    m_cass_statement = newCassStatement(m_delete_cql, m_primary_key_fields);
 
-    m_cass_statement = cass_statement_new(m_delete_cql.c_str(), 0);
+    bindQueryParamsToCassStatement(m_cass_statement, bucket, start_offset, end_offset);
+
+    if (g_partition_cache) g_partition_cache->erase(getCacheKey(bucket));
 
     future = cass_session_execute(g_cass_session, m_cass_statement);
 
@@ -964,52 +1345,137 @@ size_t Database<T>::deleteData(Time start_time, Time end_time) {
     CassError rc = cass_future_error_code(future);
     if (rc != CASS_OK) CassServer::printError(future);
 
+    cass_future_free(future);
     cass_statement_free(m_cass_statement);
+  }
 
-    return 1;
+  // partitions cached by other processes are left behind with the old generation
+  g_critcal_task.lock();
+  m_db_metadata->incrementGeneration();
+  g_critcal_task.unlock();
 
-  } else {
-    generateDeleteQuery(true, false, false);
+  return count;
+}
+
+template <typename T>
+size_t Database<T>::copyToTable(const string& a_name, const bucket_width_t a_bucket_width) {
+  if (!g_cass_session || (m_db_metadata->getNumEntries() == 0)) return 0;
+
+  Database<T> target(m_key_space, a_name, m_consecutive, m_check_insert, a_bucket_width);
+
+  if (target.getBucketWidth() != a_bucket_width) {
+    CT_CRIT_WARN << a_name << " already exists with " << static_cast<int32_t>(target.getBucketWidth())
+                 << " hour partitions\n";
+    return 0;
   }
 
-  if (start_date == 0) {
-    start_date = m_db_metadata->getMinDate();
-    start_time_of_day = 0;
+  target.createTable();
+
+  COUT << CYELLOW << "Copying " << m_name << " to " << a_name << " (" << static_cast<int32_t>(a_bucket_width)
+       << " hour partitions)" << endl;
+
+  const primary_key_t min_key = m_db_metadata->getMinEntryKey();
+  const primary_key_t max_key = m_db_metadata->getMaxEntryKey();
+
+  size_t num_copied = 0;
+  deque<T> data_arr;
+
+  // a day at a time, so only one day of rows is kept in memory
+  for (int32_t date = min_key.date; date <= max_key.date; date++) {
+    data_arr.clear();
+
+    loadData(data_arr, Time(date, 0), Time(date + 1, 0));
+
+    if (!data_arr.empty()) num_copied += target.storeDataInBatch(data_arr);
   }
 
-  if (end_date == 0) {
-    end_date = m_db_metadata->getMaxDate();
-    end_time_of_day = Time() + Duration(1, 0, 0, 0, 0, -1);  // end of day
+  primary_key_t last_examined;
+  primary_key_t target_min_key;
+  primary_key_t target_max_key;
+  int64_t num_entries;
+  vector<pair<primary_key_t, primary_key_t>> discontinuities;
+
+  target.fixDatabase(true, true, target_min_key, target_max_key, last_examined, num_entries, discontinuities);
+
+  if (!discontinuities.size()) target.getMetadata()->setConsistentEntryKey(last_examined);
+
+  target.updateOldestEntryMetadata();
+
+  COUT << "Copied " << num_copied << " rows from " << m_name << " to " << a_name << endl;
+
+  return num_copied;
+}
+
+template <typename T>
+void Database<T>::sDropTable(const string& a_key_space, const string& a_name) {
+  CassServer::executeQuery(g_cass_session, ("DROP TABLE " + a_key_space + "." + a_name).c_str());
+  CassServer::executeQuery(
+      g_cass_session, ("DELETE FROM " + a_key_space + ".metadata WHERE table_name = '" + a_name + "'").c_str());
+
+  // a table of the same name is created again
+  lock_guard<mutex> lock(g_created_tables_mutex);
+  g_created_tables.erase(a_key_space + "." + a_name);
+}
+
+template <typename T>
+bool Database<T>::sMigrateTable(const string& a_key_space, const string& a_name, const bucket_width_t a_bucket_width,
+                                const bool a_consecutive) {
+  if (!g_cass_session) return false;
+
+  if (a_name.find(':') != string::npos) {
+    CT_CRIT_WARN << a_name << " is a symbol of a shared table, only whole tables can be migrated\n";
+    return false;
   }
 
-  for (int32_t d = start_date; d <= end_date; d++) {
-    m_cass_statement = cass_statement_new(m_delete_cql.c_str(), m_primary_key_fields);
+  const string temp_name = a_name + "_migrate";
+  size_t num_entries;
 
-    if (d == start_date)
-      start_time_of_day = start_time.micros_since_midnight();
-    else
-      start_time_of_day = 0;  // start of day
+  {
+    Database<T> source(a_key_space, a_name, a_consecutive);
 
-    if (d == end_date) {
-      end_time_of_day = end_time.micros_since_midnight();
-      if (end_time_of_day == Time(0)) break;
-    } else {
-      end_time_of_day = Time() + Duration(1, 0, 0, 0, 0, -1);  // end of day
-    }
+    if (source.getBucketWidth() == a_bucket_width) return true;
 
-    bindQueryParamsToCassStatement(m_cass_statement, d, start_time_of_day, end_time_of_day);
+    // rows are counted by a full scan, the metadata may be behind them (e.g. after batch writes). The scan fixes the
+    // key range copied by copyToTable as well.
+    primary_key_t min_key, max_key, last_key;
+    int64_t num_rows;
+    vector<pair<primary_key_t, primary_key_t>> discontinuities;
 
-    future = cass_session_execute(g_cass_session, m_cass_statement);
+    source.fixDatabase(true, true, min_key, max_key, last_key, num_rows, discontinuities);
+    num_entries = static_cast<size_t>(num_rows);
 
-    cass_future_wait(future);
+    if (source.copyToTable(temp_name, a_bucket_width) != num_entries) {
+      CT_CRIT_WARN << "Not able to copy " << a_name << " to " << temp_name << ", " << a_name << " is left unchanged\n";
+      return false;
+    }
+  }
 
-    CassError rc = cass_future_error_code(future);
-    if (rc != CASS_OK) CassServer::printError(future);
+  // partition key of an existing table can't be altered, so the table is recreated with the new width
+  sDropTable(a_key_space, a_name);
 
-    cass_statement_free(m_cass_statement);
+  if (num_entries == 0) {
+    Database<T> table(a_key_space, a_name, a_consecutive, true, a_bucket_width);
+    table.createTable();
+    sDropTable(a_key_space, temp_name);
+    return true;
   }
 
-  return count;
+  {
+    Database<T> temp(a_key_space, temp_name, a_consecutive);
+
+    if (temp.copyToTable(a_name, a_bucket_width) != num_entries) {
+      CT_CRIT_WARN << "Not able to copy " << temp_name << " back to " << a_name << ", rows are kept in " << temp_name
+                   << "\n";
+      return false;
+    }
+  }
+
+  sDropTable(a_key_space, temp_name);
+
+  COUT << CGREEN << "Migrated " << a_name << " to " << static_cast<int32_t>(a_bucket_width) << " hour partitions"
+       << endl;
+
+  return true;
 }
 
 template class Database<Tick>;
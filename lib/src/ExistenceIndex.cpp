@@ -0,0 +1,89 @@
+//
+// Created by subhagato on 10/18/26.
+//
+
+#include "ExistenceIndex.h"
+
+using namespace std;
+
+bool ExistenceIndex::isInGap(const primary_key_t& a_key) const {
+  for (auto& gap : m_gaps) {
+    if ((a_key > gap.first) && (a_key < gap.second)) return true;
+  }
+
+  return false;
+}
+
+void ExistenceIndex::addToDay(const primary_key_t& a_key, const int64_t a_unique_id) {
+  auto day_itr = m_days.find(a_key.date);
+
+  if (day_itr == m_days.end()) {
+    m_lru_days.push_front(a_key.date);
+    day_itr = m_days.insert(make_pair(a_key.date, day_index_t())).first;
+    day_itr->second.lru_itr = m_lru_days.begin();
+  } else {
+    m_lru_days.splice(m_lru_days.begin(), m_lru_days, day_itr->second.lru_itr);
+  }
+
+  day_itr->second.row_ids.insert(make_pair(a_key.time, a_unique_id));
+
+  if (m_days.size() <= m_max_days) return;
+
+  const int32_t date = m_lru_days.back();
+
+  // rows written into a gap of this day are forgotten, so the gap can't be trusted anymore
+  for (auto gap_itr = m_gaps.begin(); gap_itr != m_gaps.end();) {
+    if ((gap_itr->first.date <= date) && (gap_itr->second.date >= date))
+      gap_itr = m_gaps.erase(gap_itr);
+    else
+      gap_itr++;
+  }
+
+  m_days.erase(date);
+  m_lru_days.pop_back();
+}
+
+ExistenceIndex::existence_t ExistenceIndex::claim(const primary_key_t& a_key, const int64_t a_unique_id,
+                                                  const primary_key_t& a_min_key, const primary_key_t& a_max_key,
+                                                  const bool a_empty_table) {
+  lock_guard<mutex> lock(m_mutex);
+
+  auto day_itr = m_days.find(a_key.date);
+
+  if ((day_itr != m_days.end()) && day_itr->second.row_ids.count(make_pair(a_key.time, a_unique_id))) return cExists;
+
+  // the bounds are primary keys, a row with the time of a bound is ambiguous whatever its unique id
+  if (!a_empty_table && !(a_key > a_max_key) && !(a_key < a_min_key) && !isInGap(a_key)) return cUnknown;
+
+  addToDay(a_key, a_unique_id);
+
+  return cNew;
+}
+
+void ExistenceIndex::insert(const primary_key_t& a_key, const int64_t a_unique_id) {
+  lock_guard<mutex> lock(m_mutex);
+
+  addToDay(a_key, a_unique_id);
+}
+
+void ExistenceIndex::erase(const primary_key_t& a_key, const int64_t a_unique_id) {
+  lock_guard<mutex> lock(m_mutex);
+
+  auto day_itr = m_days.find(a_key.date);
+
+  if (day_itr != m_days.end()) day_itr->second.row_ids.erase(make_pair(a_key.time, a_unique_id));
+}
+
+void ExistenceIndex::setGaps(const vector<pair<primary_key_t, primary_key_t>>& a_gaps) {
+  lock_guard<mutex> lock(m_mutex);
+
+  m_gaps = a_gaps;
+}
+
+void ExistenceIndex::clear() {
+  lock_guard<mutex> lock(m_mutex);
+
+  m_days.clear();
+  m_lru_days.clear();
+  m_gaps.clear();
+}
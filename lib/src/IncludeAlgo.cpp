@@ -19,13 +19,15 @@ void Controller::createTradeAlgo(const tradeAlgo_t a_trade_algo_idx) {
   switch (a_trade_algo_idx) {
     case tradeAlgo_t::BASICMARKET: {
       mp_TradeAlgo = new MarketOrderAlgo();
-      return;
+      break;
     }
     case tradeAlgo_t::BASICLIMIT: {
       mp_TradeAlgo = new LimitOrderAlgo();
-      return;
+      break;
     }
     default:
       assert(0);
   }
+
+  mp_TradeAlgo->setIndicatorRegistry(&m_indicator_registry);
 }
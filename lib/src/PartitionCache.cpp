@@ -0,0 +1,191 @@
+//
+// Created by subhagato on 10/18/26.
+//
+
+#include "PartitionCache.h"
+#include "Globals.h"
+#include "utils/ErrorHandling.h"
+#include "utils/Logger.h"
+#include "utils/TraderUtils.h"
+
+#include <algorithm>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+#include <vector>
+
+using namespace std;
+
+PartitionCache::PartitionCache(const string& a_dir, const size_t a_max_bytes) : m_dir(a_dir), m_max_bytes(a_max_bytes) {
+  if (!TradeUtils::isValidPath(m_dir) && !TradeUtils::createDir(m_dir)) {
+    INVALID_DIR_ERROR(m_dir);
+  }
+
+  // files of previous runs, ordered by modification time
+  vector<pair<time_t, string>> files;
+
+  DIR* p_dir = opendir(m_dir.c_str());
+
+  if (p_dir) {
+    struct dirent* p_entry;
+
+    while ((p_entry = readdir(p_dir)) != NULL) {
+      const string filename = p_entry->d_name;
+
+      if ((filename.size() < 5) || (filename.compare(filename.size() - 5, 5, ".part") != 0)) continue;
+
+      struct stat file_stat;
+      if (stat((m_dir + "/" + filename).c_str(), &file_stat)) continue;
+
+      files.push_back(make_pair(file_stat.st_mtime, filename));
+      m_entries[filename] = {static_cast<size_t>(file_stat.st_size), 0};
+      m_total_bytes += file_stat.st_size;
+    }
+
+    closedir(p_dir);
+  }
+
+  sort(files.begin(), files.end());
+
+  for (auto& file : files) m_entries[file.second].last_used = ++m_use_count;
+
+  lock_guard<mutex> lock(m_mutex);
+  evict();
+}
+
+string PartitionCache::sMakeKey(const string& a_table_name, const string& a_table_version, const int32_t a_bucket_hours,
+                                const int32_t a_bucket) {
+  return a_table_name + "@" + a_table_version + "/" + to_string(a_bucket_hours) + "/" + to_string(a_bucket);
+}
+
+// FNV-1a hash of the key
+string PartitionCache::getFilename(const string& a_key) const {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+
+  for (const char c : a_key) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 0x100000001b3ULL;
+  }
+
+  char filename[32];
+  snprintf(filename, sizeof(filename), "%016llx.part", static_cast<unsigned long long>(hash));
+
+  return filename;
+}
+
+size_t PartitionCache::getNumBytes() const {
+  lock_guard<mutex> lock(m_mutex);
+
+  return m_total_bytes;
+}
+
+size_t PartitionCache::getNumEntries() const {
+  lock_guard<mutex> lock(m_mutex);
+
+  return m_entries.size();
+}
+
+void PartitionCache::removeFile(const string& a_filename) {
+  auto entry_itr = m_entries.find(a_filename);
+  if (entry_itr == m_entries.end()) return;
+
+  unlink((m_dir + "/" + a_filename).c_str());
+
+  m_total_bytes -= entry_itr->second.bytes;
+  m_entries.erase(entry_itr);
+}
+
+void PartitionCache::evict() {
+  while ((m_total_bytes > m_max_bytes) && !m_entries.empty()) {
+    auto lru_itr = m_entries.begin();
+    for (auto entry_itr = m_entries.begin(); entry_itr != m_entries.end(); entry_itr++)
+      if (entry_itr->second.last_used < lru_itr->second.last_used) lru_itr = entry_itr;
+
+    removeFile(lru_itr->first);
+  }
+}
+
+bool PartitionCache::get(const string& a_key, string& a_rows) {
+  lock_guard<mutex> lock(m_mutex);
+
+  const string filename = getFilename(a_key);
+
+  auto entry_itr = m_entries.find(filename);
+  if (entry_itr == m_entries.end()) return false;
+
+  const string path = m_dir + "/" + filename;
+  FILE* p_file = fopen(path.c_str(), "rb");
+
+  if (!p_file) {
+    removeFile(filename);
+    return false;
+  }
+
+  bool found = false;
+  uint32_t key_size;
+
+  // another key with the same hash is a miss
+  if ((fread(&key_size, sizeof(key_size), 1, p_file) == 1) && (key_size == a_key.size()) &&
+      (entry_itr->second.bytes >= sizeof(key_size) + key_size)) {
+    string key(key_size, '\0');
+    const size_t rows_size = entry_itr->second.bytes - sizeof(key_size) - key_size;
+
+    if ((fread(&key[0], 1, key_size, p_file) == key_size) && (key == a_key)) {
+      a_rows.resize(rows_size);
+      found = (fread(&a_rows[0], 1, rows_size, p_file) == rows_size);
+    }
+  }
+
+  fclose(p_file);
+
+  if (found) {
+    entry_itr->second.last_used = ++m_use_count;
+    utime(path.c_str(), NULL);  // keeps the usage order for the next run
+  }
+
+  return found;
+}
+
+void PartitionCache::put(const string& a_key, const string& a_rows) {
+  lock_guard<mutex> lock(m_mutex);
+
+  const string filename = getFilename(a_key);
+  const string path = m_dir + "/" + filename;
+  const string temp_path = path + ".tmp";
+
+  removeFile(filename);
+
+  FILE* p_file = fopen(temp_path.c_str(), "wb");
+
+  if (!p_file) {
+    INVALID_FILE_ERROR(temp_path);
+    return;
+  }
+
+  const uint32_t key_size = static_cast<uint32_t>(a_key.size());
+
+  bool written = (fwrite(&key_size, sizeof(key_size), 1, p_file) == 1) &&
+                 (fwrite(a_key.data(), 1, key_size, p_file) == key_size) &&
+                 (fwrite(a_rows.data(), 1, a_rows.size(), p_file) == a_rows.size());
+
+  written &= (fclose(p_file) == 0);
+
+  // a partially written file is never visible under its real name
+  if (!written || rename(temp_path.c_str(), path.c_str())) {
+    CT_CRIT_WARN << "Not able to write " << path << endl;
+    unlink(temp_path.c_str());
+    return;
+  }
+
+  m_entries[filename] = {sizeof(key_size) + key_size + a_rows.size(), ++m_use_count};
+  m_total_bytes += m_entries[filename].bytes;
+
+  evict();
+}
+
+void PartitionCache::erase(const string& a_key) {
+  lock_guard<mutex> lock(m_mutex);
+
+  removeFile(getFilename(a_key));
+}
@@ -0,0 +1,88 @@
+//
+// Created by subhagato on 10/18/26.
+//
+
+#include "TickColumns.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+static_assert((TICK_COLUMNS_CHUNK_SIZE % 8) == 0, "columns of a chunk must stay 64 byte aligned");
+
+TickColumns::chunk_t* TickColumns::sAllocateChunk() {
+  void* p_memory = NULL;
+
+  if (posix_memalign(&p_memory, 64, sizeof(chunk_t))) throw bad_alloc();
+
+  return static_cast<chunk_t*>(p_memory);
+}
+
+void TickColumns::assign(const TickPeriodT<Tick>& a_tick_period) {
+  clear();
+
+  for (auto& tick : a_tick_period) push_back(tick);
+}
+
+void TickColumns::pop_front() {
+  if (m_num_ticks <= 1) {
+    clear();
+    return;
+  }
+
+  m_front_offset++;
+  m_num_ticks--;
+
+  // release the first chunk once all its rows are popped
+  if (m_front_offset == TICK_COLUMNS_CHUNK_SIZE) {
+    free(m_chunks.front());
+    m_chunks.pop_front();
+    m_front_offset = 0;
+  }
+}
+
+void TickColumns::pop_back() {
+  if (m_num_ticks <= 1) {
+    clear();
+    return;
+  }
+
+  m_num_ticks--;
+
+  // release the last chunk once all its rows are popped
+  const size_t last_row = m_front_offset + m_num_ticks - 1;
+
+  if ((last_row / TICK_COLUMNS_CHUNK_SIZE) < (m_chunks.size() - 1)) {
+    free(m_chunks.back());
+    m_chunks.pop_back();
+  }
+}
+
+size_t TickColumns::getSpans(const size_t a_start_idx, const size_t a_end_idx, vector<tick_columns_t>& a_spans) const {
+  size_t num_spans = 0;
+
+  for (size_t idx = a_start_idx; idx < min(a_end_idx, m_num_ticks);) {
+    const size_t row = m_front_offset + idx;
+    const chunk_t* p_chunk = m_chunks[row / TICK_COLUMNS_CHUNK_SIZE];
+    const size_t offset = row % TICK_COLUMNS_CHUNK_SIZE;
+    const size_t num_ticks = min(TICK_COLUMNS_CHUNK_SIZE - offset, min(a_end_idx, m_num_ticks) - idx);
+
+    a_spans.push_back({p_chunk->timestamp + offset, p_chunk->trade_id + offset, p_chunk->price + offset,
+                       p_chunk->size + offset, num_ticks});
+
+    idx += num_ticks;
+    num_spans++;
+  }
+
+  return num_spans;
+}
+
+void TickColumns::clear() {
+  for (auto p_chunk : m_chunks) free(p_chunk);
+
+  m_chunks.clear();
+  m_front_offset = 0;
+  m_num_ticks = 0;
+}
@@ -8,9 +8,12 @@
 #include "CoinAPITick.h"
 #include "Database.h"
 #include "Tick.h"
+#include "TickStore.h"
 #include "TraderBot.h"
 #include "utils/Logger.h"
 
+#include <algorithm>
+
 using namespace std;
 
 template <typename T>
@@ -28,8 +31,55 @@ void TickPeriodT<T>::reset() {
   m_last_stored_itr = deque<T>::end();
 }
 
+template <typename T>
+void TickPeriodT<T>::detachView() {
+  mp_source = NULL;
+  m_view_end = 0;
+}
+
+template <typename T>
+void TickPeriodT<T>::setView(TickPeriodT<T>* ap_source, const size_t a_num_ticks) {
+  assert(ap_source && !ap_source->isView() && (ap_source != this) && (a_num_ticks <= ap_source->size()));
+
+  clear();
+
+  mp_source = ap_source;
+  m_view_end = ap_source->m_num_evicted + a_num_ticks;
+
+  if (a_num_ticks == 0) return;
+
+  m_first_ts = front().getTimeStamp();
+  m_last_ts = back().getTimeStamp();
+  m_first_tid = front().getUniqueID();
+  m_last_tid = back().getUniqueID();
+}
+
+template <typename T>
+int TickPeriodT<T>::advanceView(const T& t) {
+  const deque<T>& source = *mp_source;
+  const size_t view_size = size();
+
+  // a view can only move forward over the ticks of its source
+  if ((view_size >= source.size()) || (source[view_size].getUniqueID() != t.getUniqueID())) {
+    CT_WARN << "Can't add trade which isn't the next one of the source period.\n";
+    return -1;  // Error
+  }
+
+  m_last_ts = t.getTimeStamp();
+  m_last_tid = t.getUniqueID();
+  m_view_end = mp_source->m_num_evicted + view_size + 1;
+
+  // the first tick changes when the source evicts
+  m_first_ts = front().getTimeStamp();
+  m_first_tid = front().getUniqueID();
+
+  return 1;  // added in the end
+}
+
 template <typename T>
 int TickPeriodT<T>::append(T& t, FILE* ap_csv_file) {
+  if (mp_source) return advanceView(t);
+
   int64_t unique_id = t.getUniqueID();
 
   if (this->size() == 0) {
@@ -42,7 +92,7 @@ int TickPeriodT<T>::append(T& t, FILE* ap_csv_file) {
     return 1;  // considered as added in the end
   }
 
-  if ((m_consecutive && getFirstUniqueId() == (unique_id + 1)) || (!m_consecutive && getFirstUniqueId() > unique_id)) {
+  if ((m_consecutive && getFirstUniqueId() == (unique_id + 1)) || (!m_consecutive && sIsBefore(t, this->front()))) {
     m_first_ts = t.getTimeStamp();
     m_first_tid = unique_id;
     this->push_front(t);
@@ -51,7 +101,7 @@ int TickPeriodT<T>::append(T& t, FILE* ap_csv_file) {
 
     return 2;  // added in the beginning
   } else if ((m_consecutive && getLastUniqueId() == (unique_id - 1)) ||
-             (!m_consecutive && getLastUniqueId() < unique_id)) {
+             (!m_consecutive && sIsBefore(this->back(), t))) {
     m_last_ts = t.getTimeStamp();
     m_last_tid = unique_id;
     this->push_back(t);
@@ -59,40 +109,67 @@ int TickPeriodT<T>::append(T& t, FILE* ap_csv_file) {
     if (ap_csv_file) DbUtils::writeToCSVLine<T>(ap_csv_file, t);
 
     return 1;  // added in the end
-  } else if (unique_id <= getLastUniqueId() && unique_id >= getFirstUniqueId()) {
-    bool exists = m_consecutive;
-
-    auto tick_itr = this->begin();
-
-    if (!m_consecutive) {
-      for (; tick_itr != this->end(); tick_itr++) {
-        if (tick_itr->getUniqueID() == unique_id) {
-          exists = true;
-          break;
-        } else if (tick_itr->getUniqueID() > unique_id)  // break when it just crosses the current id
-        {
-          break;
-        }
-      }
-    }
-
-    if (!exists) {
-      if (ap_csv_file) DbUtils::writeToCSVLine<T>(ap_csv_file, t);
+  } else if (!m_consecutive) {
+    // binary search, ticks of a non consecutive period are ordered by (timestamp, unique id)
+    auto tick_itr = lower_bound(this->begin(), this->end(), t, sIsBefore);
 
-      this->insert(tick_itr, t);
-      return 3;  // added in the middle
-    } else {
+    if ((tick_itr != this->end()) && !sIsBefore(t, *tick_itr)) {
       CT_WARN << t << " tick already exists\n";
       return 0;  // didn't add
     }
 
+    if (ap_csv_file) DbUtils::writeToCSVLine<T>(ap_csv_file, t);
+
+    this->insert(tick_itr, t);
+    return 3;  // added in the middle
+  } else if (unique_id <= getLastUniqueId() && unique_id >= getFirstUniqueId()) {
+    CT_WARN << t << " tick already exists\n";
+    return 0;  // didn't add
   } else {
-    assert(m_consecutive);
     CT_WARN << "Can't add trade which is outside the range.\n";
     return -1;  // Error
   }
 }
 
+template <typename T>
+int TickPeriodT<T>::merge(vector<T>& a_ticks) {
+  assert(!m_consecutive && !mp_source);
+
+  sort(a_ticks.begin(), a_ticks.end(), sIsBefore);
+
+  const size_t num_old_ticks = this->size();
+
+  for (size_t idx = 0; idx < a_ticks.size(); ++idx) {
+    const T& t = a_ticks[idx];
+
+    if ((idx > 0) && !sIsBefore(a_ticks[idx - 1], t)) continue;  // duplicate in the batch
+
+    auto old_end = this->begin() + num_old_ticks;
+    auto tick_itr = lower_bound(this->begin(), old_end, t, sIsBefore);
+
+    if ((tick_itr != old_end) && !sIsBefore(t, *tick_itr)) continue;  // already exists
+
+    this->push_back(t);
+  }
+
+  const size_t num_added = this->size() - num_old_ticks;
+
+  if (num_added == 0) return 0;
+
+  // only the old ticks after the earliest new one take part in the merge
+  auto old_end = this->begin() + num_old_ticks;
+  auto merge_start = upper_bound(this->begin(), old_end, *old_end, sIsBefore);
+
+  inplace_merge(merge_start, old_end, this->end(), sIsBefore);
+
+  m_first_ts = this->front().getTimeStamp();
+  m_last_ts = this->back().getTimeStamp();
+  m_first_tid = this->front().getUniqueID();
+  m_last_tid = this->back().getUniqueID();
+
+  return static_cast<int>(num_added);
+}
+
 template <typename T>
 void TickPeriodT<T>::sFixTimestamps(deque<T>& trades) {
   vector<T> ticks;
@@ -108,11 +185,38 @@ void TickPeriodT<T>::sFixTimestamps(deque<T>& trades) {
   }
 }
 
+template <typename T>
+size_t TickPeriodT<T>::evictFront(const size_t a_num_ticks) {
+  if (mp_source) return 0;
+
+  const size_t num_evicted = min(a_num_ticks, size());
+  if (num_evicted == 0) return 0;
+
+  if (num_evicted == size()) {
+    const size_t num_total_evicted = m_num_evicted + num_evicted;
+    clear();
+    m_num_evicted = num_total_evicted;
+    return num_evicted;
+  }
+
+  deque<T>::erase(deque<T>::begin(), deque<T>::begin() + num_evicted);
+  m_num_evicted += num_evicted;
+
+  m_first_ts = front().getTimeStamp();
+  m_first_tid = front().getUniqueID();
+
+  // stored ticks start at the new front now
+  if (m_num_saved != 0) m_first_stored_itr = deque<T>::begin();
+
+  return num_evicted;
+}
+
 template <typename T>
 int TickPeriodT<T>::storeToDatabase(Database<T>* db) {
   size_t num_stored = 0;
 
-  if (this->empty()) return 0;
+  // ticks of a view are stored through its source, its own deque is empty
+  if (this->empty() || mp_source) return 0;
 
   sFixTimestamps(*this);
 
@@ -159,11 +263,65 @@ int TickPeriodT<T>::storeToDatabase(Database<T>* db) {
 
 template <typename T>
 bool TickPeriodT<T>::loadFromDatabase(Database<T>* db, Time start_time, Time end_time) {
+  detachView();
+
+  deque<T>& data = *this;
+  data.clear();
+
+  return updateLoadedRange(db->loadData(data, start_time, end_time));
+}
+
+template <typename T>
+bool TickPeriodT<T>::sLoadFromDatabase(const vector<Database<T>*>& dbs, const vector<TickPeriodT<T>*>& tick_periods,
+                                       Time start_time, Time end_time) {
+  vector<deque<T>*> data;
+
+  for (auto tick_period : tick_periods) {
+    tick_period->detachView();
+    tick_period->deque<T>::clear();
+    data.push_back(tick_period);
+  }
+
+  Database<T>::sLoadData(dbs, data, start_time, end_time);
+
+  bool success = true;
+
+  for (auto tick_period : tick_periods)
+    success &= tick_period->updateLoadedRange(static_cast<int>(tick_period->size()));
+
+  return success;
+}
+
+template <typename T>
+bool TickPeriodT<T>::loadFromDatabase(TickStore* store, Time start_time, Time end_time) {
+  detachView();
+
+  deque<T>& data = *this;
+  data.clear();
+
+  return updateLoadedRange(store->loadData(data, start_time, end_time));
+}
+
+template <typename T>
+bool TickPeriodT<T>::loadFromDatabase(TickStore* store, Database<T>* db, Time start_time, Time store_end_time,
+                                      Time end_time) {
+  detachView();
+
   deque<T>& data = *this;
-  size_t num_stored;
   data.clear();
-  num_stored = db->loadData(data, start_time, end_time);
 
+  int num_loaded = store->loadData(data, start_time, min(store_end_time, end_time));
+
+  if (db && (store_end_time < end_time)) {
+    const int num_db_loaded = db->loadData(data, max(store_end_time, start_time), end_time);
+    num_loaded = ((num_loaded < 0) || (num_db_loaded < 0)) ? -1 : (num_loaded + num_db_loaded);
+  }
+
+  return updateLoadedRange(num_loaded);
+}
+
+template <typename T>
+bool TickPeriodT<T>::updateLoadedRange(const int num_loaded) {
   if (this->empty()) {
     CT_WARN << "No data in database\n";
     reset();
@@ -178,8 +336,8 @@ bool TickPeriodT<T>::loadFromDatabase(Database<T>* db, Time start_time, Time end
   m_first_stored_itr = this->begin();
   m_last_stored_itr = this->end();
 
-  if (num_stored == this->size()) {
-    m_num_saved = num_stored;
+  if (num_loaded == static_cast<int>(this->size())) {
+    m_num_saved = num_loaded;
     return true;
   } else {
     return false;
@@ -198,6 +356,7 @@ void TickPeriodT<T>::saveToCSV(FILE* a_csv_file) {
 
 template <typename T>
 void TickPeriodT<T>::clear() {
+  detachView();
   deque<T>::clear();
 
   m_first_tid = 0;
@@ -207,6 +366,7 @@ void TickPeriodT<T>::clear() {
   m_first_stored_itr = deque<T>::end();
   m_last_stored_itr = deque<T>::end();
   m_num_saved = 0;
+  m_num_evicted = 0;
 }
 
 template class TickPeriodT<Tick>;
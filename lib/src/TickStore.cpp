@@ -0,0 +1,343 @@
+//
+// Created by subhagato on 10/17/26.
+//
+
+#include "TickStore.h"
+#include "CMCandleStick.h"
+#include "Candlestick.h"
+#include "CoinAPITick.h"
+#include "Globals.h"
+#include "Tick.h"
+#include "utils/ErrorHandling.h"
+#include "utils/Logger.h"
+
+#include <algorithm>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <tuple>
+#include <unistd.h>
+
+using namespace std;
+
+const char* TickStore::s_column_names[cNumColumns] = {"timestamp", "trade_id", "price", "size"};
+
+TickStore::TickStore(const string& a_root_dir, const string& a_table_name) {
+  m_dir = a_root_dir + "/" + a_table_name;
+
+  if (!TradeUtils::isValidPath(m_dir) && !TradeUtils::createDir(m_dir)) {
+    INVALID_DIR_ERROR(m_dir);
+  }
+}
+
+TickStore::~TickStore() {
+  lock_guard<mutex> lock(m_segment_mutex);
+
+  while (!m_segments.empty()) unmapSegment(m_segments.begin()->first);
+}
+
+string TickStore::getColumnFilename(const int32_t a_date, const column_t a_column) const {
+  return m_dir + "/" + to_string(a_date) + "." + s_column_names[a_column];
+}
+
+int64_t TickStore::getGeneration() const {
+  int64_t generation = -1;
+
+  ifstream file(getGenerationFilename().c_str());
+  if (!(file >> generation)) return -1;
+
+  return generation;
+}
+
+void TickStore::setGeneration(const int64_t a_generation) {
+  if (getGeneration() == a_generation) return;
+
+  lock_guard<mutex> lock(m_segment_mutex);
+
+  while (!m_segments.empty()) unmapSegment(m_segments.begin()->first);
+
+  DIR* p_dir = opendir(m_dir.c_str());
+
+  if (p_dir) {
+    struct dirent* p_entry;
+
+    while ((p_entry = readdir(p_dir)) != NULL) {
+      const string filename = p_entry->d_name;
+
+      for (int col = 0; col < cNumColumns; ++col) {
+        const string suffix = string(".") + s_column_names[col];
+
+        if ((filename.size() > suffix.size()) &&
+            (filename.compare(filename.size() - suffix.size(), suffix.size(), suffix) == 0)) {
+          unlink((m_dir + "/" + filename).c_str());
+          break;
+        }
+      }
+    }
+
+    closedir(p_dir);
+  }
+
+  COUT << "Tick store " << m_dir << " cleared for generation " << a_generation << " of the table\n";
+
+  ofstream file(getGenerationFilename().c_str(), ios::trunc);
+  file << a_generation << endl;
+
+  if (!file) INVALID_FILE_ERROR(getGenerationFilename());
+}
+
+bool TickStore::hasSegment(const int32_t a_date) const {
+  return TradeUtils::isValidPath(getColumnFilename(a_date, cTimestamp));
+}
+
+void TickStore::addEmptyDay(const int32_t a_date) {
+  lock_guard<mutex> lock(m_segment_mutex);
+
+  // the timestamp column marks the day, it's created last
+  for (int col = cNumColumns - 1; col >= 0; --col) {
+    const string filename = getColumnFilename(a_date, static_cast<column_t>(col));
+    FILE* p_file = fopen(filename.c_str(), "ab");
+
+    if (!p_file) {
+      INVALID_FILE_ERROR(filename);
+      return;
+    }
+
+    fclose(p_file);
+  }
+}
+
+// maps all columns of a day, returns NULL if the segment doesn't exist or is empty
+const TickStore::segment_t* TickStore::mapSegment(const int32_t a_date) {
+  auto seg_itr = m_segments.find(a_date);
+  if (seg_itr != m_segments.end()) return &seg_itr->second;
+
+  segment_t segment;
+  size_t file_bytes[cNumColumns];
+  int fds[cNumColumns];
+
+  for (int col = 0; col < cNumColumns; ++col) {
+    fds[col] = open(getColumnFilename(a_date, static_cast<column_t>(col)).c_str(), O_RDONLY);
+
+    struct stat file_stat;
+    if ((fds[col] < 0) || fstat(fds[col], &file_stat)) {
+      for (int idx = 0; idx <= col; ++idx)
+        if (fds[idx] >= 0) close(fds[idx]);
+      return NULL;
+    }
+
+    file_bytes[col] = static_cast<size_t>(file_stat.st_size);
+  }
+
+  // a partially written append leaves columns of different length, only the common part is valid
+  segment.num_ticks = *min_element(file_bytes, file_bytes + cNumColumns) / sizeof(int64_t);
+
+  bool mapped = (segment.num_ticks > 0);
+
+  for (int col = 0; col < cNumColumns; ++col) {
+    segment.columns[col] = NULL;
+    segment.mapped_bytes[col] = segment.num_ticks * sizeof(int64_t);
+
+    if (mapped) {
+      void* addr = mmap(NULL, segment.mapped_bytes[col], PROT_READ, MAP_SHARED, fds[col], 0);
+
+      if (addr == MAP_FAILED) {
+        CT_CRIT_WARN << "Not able to map " << getColumnFilename(a_date, static_cast<column_t>(col)) << endl;
+        mapped = false;
+      } else {
+        segment.columns[col] = addr;
+        madvise(addr, segment.mapped_bytes[col], MADV_SEQUENTIAL);
+      }
+    }
+
+    close(fds[col]);
+  }
+
+  if (!mapped) {
+    for (int col = 0; col < cNumColumns; ++col)
+      if (segment.columns[col]) munmap(segment.columns[col], segment.mapped_bytes[col]);
+    return NULL;
+  }
+
+  return &m_segments.insert(make_pair(a_date, segment)).first->second;
+}
+
+void TickStore::unmapSegment(const int32_t a_date) {
+  auto seg_itr = m_segments.find(a_date);
+  if (seg_itr == m_segments.end()) return;
+
+  segment_t& segment = seg_itr->second;
+
+  for (int col = 0; col < cNumColumns; ++col)
+    if (segment.columns[col]) munmap(segment.columns[col], segment.mapped_bytes[col]);
+
+  m_segments.erase(seg_itr);
+}
+
+size_t TickStore::appendToSegment(const int32_t a_date, const vector<int64_t>& a_timestamps,
+                                  const vector<int64_t>& a_trade_ids, const vector<double>& a_prices,
+                                  const vector<double>& a_sizes) {
+  const void* columns[cNumColumns] = {a_timestamps.data(), a_trade_ids.data(), a_prices.data(), a_sizes.data()};
+  const size_t num_ticks = a_timestamps.size();
+
+  // existing mapping will be stale after the append
+  unmapSegment(a_date);
+
+  // rows all the columns had before the append, a failed append is rolled back to it
+  off_t common_bytes = INT64_MAX;
+  for (int col = 0; col < cNumColumns; ++col) {
+    struct stat file_stat;
+    const off_t file_bytes =
+        stat(getColumnFilename(a_date, static_cast<column_t>(col)).c_str(), &file_stat) ? 0 : file_stat.st_size;
+    common_bytes = min(common_bytes, file_bytes - (file_bytes % static_cast<off_t>(sizeof(int64_t))));
+  }
+
+  bool written = true;
+
+  for (int col = 0; (col < cNumColumns) && written; ++col) {
+    const string filename = getColumnFilename(a_date, static_cast<column_t>(col));
+    FILE* p_file = fopen(filename.c_str(), "ab");
+
+    if (!p_file) {
+      INVALID_FILE_ERROR(filename);
+      written = false;
+      continue;
+    }
+
+    // a column left longer by an earlier failed append is cut back first, so the rows of all columns line up
+    if (fflush(p_file) || ftruncate(fileno(p_file), common_bytes)) written = false;
+
+    written = written && (fwrite(columns[col], sizeof(int64_t), num_ticks, p_file) == num_ticks);
+    written = (fclose(p_file) == 0) && written;
+
+    if (!written) CT_CRIT_WARN << "Partial write in " << filename << endl;
+  }
+
+  if (written) return num_ticks;
+
+  for (int col = 0; col < cNumColumns; ++col) {
+    const string filename = getColumnFilename(a_date, static_cast<column_t>(col));
+    if (TradeUtils::isValidPath(filename) && truncate(filename.c_str(), common_bytes))
+      CT_CRIT_WARN << "Not able to roll back " << filename << endl;
+  }
+
+  return 0;
+}
+
+size_t TickStore::append(deque<Tick>::const_iterator a_start_itr, deque<Tick>::const_iterator a_end_itr) {
+  lock_guard<mutex> lock(m_segment_mutex);
+
+  size_t num_appended = 0;
+
+  vector<int64_t> timestamps, trade_ids;
+  vector<double> prices, sizes;
+
+  auto tick_itr = a_start_itr;
+
+  while (tick_itr != a_end_itr) {
+    const int32_t date = tick_itr->getDate();
+
+    // last stored tick of the day, new ticks must come after it
+    tuple<int64_t, int64_t> last_key(INT64_MIN, INT64_MIN);
+
+    const segment_t* p_segment = mapSegment(date);
+    if (p_segment) {
+      const size_t last_idx = p_segment->num_ticks - 1;
+      last_key = make_tuple(static_cast<const int64_t*>(p_segment->columns[cTimestamp])[last_idx],
+                            static_cast<const int64_t*>(p_segment->columns[cTradeId])[last_idx]);
+    }
+
+    timestamps.clear();
+    trade_ids.clear();
+    prices.clear();
+    sizes.clear();
+
+    for (; (tick_itr != a_end_itr) && (tick_itr->getDate() == date); ++tick_itr) {
+      tuple<int64_t, int64_t> key((int64_t)tick_itr->getTimeStamp(), tick_itr->getUniqueID());
+
+      if (key <= last_key) continue;
+
+      timestamps.push_back(get<0>(key));
+      trade_ids.push_back(get<1>(key));
+      prices.push_back(tick_itr->getPrice());
+      sizes.push_back(tick_itr->getSize());
+
+      last_key = key;
+    }
+
+    if (!timestamps.empty()) num_appended += appendToSegment(date, timestamps, trade_ids, prices, sizes);
+  }
+
+  return num_appended;
+}
+
+size_t TickStore::scan(const Time a_start_time, const Time a_end_time, vector<tick_columns_t>& a_ranges) {
+  lock_guard<mutex> lock(m_segment_mutex);
+
+  return scanLocked(a_start_time, a_end_time, a_ranges);
+}
+
+size_t TickStore::scanLocked(const Time a_start_time, const Time a_end_time, vector<tick_columns_t>& a_ranges) {
+  size_t num_ticks = 0;
+
+  if (a_start_time >= a_end_time) return 0;
+
+  const int64_t start_micros = (int64_t)a_start_time;
+  const int64_t end_micros = (int64_t)a_end_time;
+
+  for (int32_t date = a_start_time.days_since_epoch(); date <= a_end_time.days_since_epoch(); ++date) {
+    const segment_t* p_segment = mapSegment(date);
+    if (!p_segment) continue;
+
+    const int64_t* timestamps = static_cast<const int64_t*>(p_segment->columns[cTimestamp]);
+
+    const size_t start_idx = lower_bound(timestamps, timestamps + p_segment->num_ticks, start_micros) - timestamps;
+    const size_t end_idx = lower_bound(timestamps, timestamps + p_segment->num_ticks, end_micros) - timestamps;
+
+    if (start_idx >= end_idx) continue;
+
+    tick_columns_t range;
+    range.timestamp = timestamps + start_idx;
+    range.trade_id = static_cast<const int64_t*>(p_segment->columns[cTradeId]) + start_idx;
+    range.price = static_cast<const double*>(p_segment->columns[cPrice]) + start_idx;
+    range.size = static_cast<const double*>(p_segment->columns[cSize]) + start_idx;
+    range.num_ticks = end_idx - start_idx;
+
+    a_ranges.push_back(range);
+    num_ticks += range.num_ticks;
+  }
+
+  return num_ticks;
+}
+
+template <typename T>
+int TickStore::loadData(deque<T>& a_data, const Time a_start_time, const Time a_end_time) {
+  CT_CRIT_WARN << T::m_type << " can't be loaded from tick store\n";
+  return -1;
+}
+
+template <>
+int TickStore::loadData(deque<Tick>& a_data, const Time a_start_time, const Time a_end_time) {
+  vector<tick_columns_t> ranges;
+
+  COUT << "loading data from tick store (" << m_dir << "): start_time = " << a_start_time
+       << " end_time = " << a_end_time << endl;
+
+  // an append from another thread unmaps the segments, so they are read under the lock
+  lock_guard<mutex> lock(m_segment_mutex);
+
+  const size_t num_ticks = scanLocked(a_start_time, a_end_time, ranges);
+
+  for (auto& range : ranges) {
+    for (size_t idx = 0; idx < range.num_ticks; ++idx)
+      a_data.emplace_back(Time(range.timestamp[idx]), range.trade_id[idx], range.price[idx], range.size[idx]);
+  }
+
+  return static_cast<int>(num_ticks);
+}
+
+template int TickStore::loadData(deque<CMCandleStick>&, const Time, const Time);
+template int TickStore::loadData(deque<CoinAPITick>&, const Time, const Time);
+template int TickStore::loadData(deque<Candlestick>&, const Time, const Time);
@@ -8,11 +8,14 @@
 #include "Controller.h"
 #include "Database.h"
 #include "Tick.h"
+#include "TickStore.h"
 #include "TraderBot.h"
 #include "exchanges/Exchange.h"
 #include "indicators/MA.h"
 
+#include <algorithm>
 #include <cmath>
+#include <type_traits>
 #include <vector>
 
 using namespace std;
@@ -21,7 +24,7 @@ template <typename T>
 TradeHistoryT<T>::TradeHistoryT(const exchange_t exchange_id, const CurrencyPair currency_pair, const bool consecutive,
                                 const vector<Duration> candlestick_intervals)
     : m_exchange_id(exchange_id), m_currency_pair(currency_pair) {
-  m_db = new Database<T>("crypto", exchange_id, currency_pair, consecutive);
+  m_db = new Database<T>("crypto", exchange_id, currency_pair, consecutive, true, bucket_width_t::DAY, g_shared_tables);
 
 #if 0
   // delete table
@@ -35,18 +38,42 @@ TradeHistoryT<T>::TradeHistoryT(const exchange_t exchange_id, const CurrencyPair
   m_db->createTable();  // create table if not exists
 
   for (auto& interval : candlestick_intervals) {
-    m_candle_periods.insert(make_pair(interval, new CandlePeriodT<Candlestick, T>(interval)));
+    m_candle_periods.insert(make_pair(interval, newCandlePeriod(interval)));
+    m_candle_snapshots[interval];  // readers walk the snapshots unlocked, they are only added before trading
   }
 
   m_tick_period = new TickPeriodT<T>(consecutive);
 
+  m_tick_store = NULL;
+
+  m_retention = {0, 0};
+
   m_ongoing_trading = false;
+
+  m_num_callbacks = 0;
+  m_num_callback_ticks = 0;
+  m_num_candle_updates = 0;
+
+  m_candles_updated_from = Time::sMax();
+
+  publishCandles();
+}
+
+template <typename T>
+CandlePeriodT<Candlestick, T>* TradeHistoryT<T>::newCandlePeriod(const Duration a_interval) const {
+  CandlePeriodT<Candlestick, T>* p_candle_period = new CandlePeriodT<Candlestick, T>(a_interval);
+
+  // short candles of illiquid pairs are mostly flat
+  p_candle_period->setSparse(a_interval.getDurationInSec() <= g_sparse_candle_sec);
+
+  return p_candle_period;
 }
 
 template <typename T>
 TradeHistoryT<T>::~TradeHistoryT() {
   clearData();
   DELETE(m_db);
+  DELETE(m_tick_store);
 
   DELETE(m_tick_period);
 
@@ -69,12 +96,17 @@ string TradeHistoryT<T>::getFullSymbolStr(bool lower) const {
 template <typename T>
 void TradeHistoryT<T>::clearData() {
   m_tick_period->clear();
+  m_reorder_window.clear();
+  m_candles_updated_from = Time::sMax();
 
   for (auto& candle_period : m_candle_periods) {
     candle_period.second->clear();
   }
 
   m_indicators.clear();
+  m_continuous_indicators.clear();
+
+  publishCandles();
 }
 
 template <typename T>
@@ -84,6 +116,8 @@ T TradeHistoryT<T>::getLatestTick() {
 
 template <typename T>
 int64_t TradeHistoryT<T>::syncToDatabase() {
+  flushReorderWindow();
+
   return m_tick_period->storeToDatabase(m_db);
 }
 
@@ -147,9 +181,11 @@ void TradeHistoryT<T>::initLogs(const string& a_csv_file_dir) {
     // candle stick header
     iter.second->saveHeaderToCSV(p_file, false);
 
-    if (m_indicators.find(interval) != m_indicators.end()) {
-      // indicator headers
-      m_indicators.at(interval)->saveHeaderToCSV(p_file, false);
+    // indicator headers, the values are logged with every candle so they are computed eagerly
+    const auto indicators = m_indicators.equal_range(interval);
+    for (auto indicator_itr = indicators.first; indicator_itr != indicators.second; ++indicator_itr) {
+      indicator_itr->second->saveHeaderToCSV(p_file, false);
+      indicator_itr->second->setLazy(false);
     }
 
     // completion of 1st line
@@ -173,7 +209,7 @@ void TradeHistoryT<T>::saveStatsInCSV(const Duration a_interval) const {
   Controller* p_Controller = TraderBot::getInstance()->getController();
   if (!p_Controller || (p_Controller->getPortfolioValue(m_exchange_id) < 0)) return;
 
-  if (p_candle_period->size() < 2) return;
+  if (p_candle_period->getNumCandles() < 2) return;
 
   if (m_logs.find(a_interval) == m_logs.end()) return;
 
@@ -182,13 +218,13 @@ void TradeHistoryT<T>::saveStatsInCSV(const Duration a_interval) const {
 
   p_Controller->saveStatsInCSV(p_file, m_exchange_id);
 
-  auto& matured_candle_stick = *(p_candle_period->begin() + p_candle_period->size() - 2);
+  const Candlestick matured_candle_stick = p_candle_period->getCandleFromEnd(1);
   DbUtils::writeToCSVLine(p_file, matured_candle_stick, false);
 
-  if (m_indicators.find(a_interval) != m_indicators.end()) {
-    // save indicators
-    m_indicators.at(a_interval)->saveToCSV(p_file, false);
-  }
+  // save indicators
+  const auto indicators = m_indicators.equal_range(a_interval);
+  for (auto indicator_itr = indicators.first; indicator_itr != indicators.second; ++indicator_itr)
+    indicator_itr->second->saveToCSV(p_file, false);
 
   // completion of line
   fprintf(p_file, "\n");
@@ -224,14 +260,62 @@ bool TradeHistoryT<T>::appendTrade(T& t) {
   // lock tick based data
   m_new_tick.lock();
 
+  int t_result = appendTradeLocked(t);
+  const Time candles_updated_from = takeCandlesUpdatedFrom();
+
+  // unlock tick based data
+  m_new_tick.unlock();
+
+  if (m_ongoing_trading) p_Controller->UnlockTrading();
+
+  // the late ticks came before the new one
+  if (candles_updated_from != Time::sMax()) candleUpdateCallBack(candles_updated_from);
+
+  if (t_result == -1) return false;
+
+  if (t_result == 1) controllerCallBack();
+
+  return true;
+}
+
+template <typename T>
+int TradeHistoryT<T>::appendTradeLocked(T& t) {
+  // late ticks of a non consecutive history don't create tick events, they are merged in bulk
+  const bool is_late = (!m_tick_period->isConsecutive() && !m_tick_period->isView() && !m_tick_period->empty() &&
+                        !TickPeriodT<T>::sIsBefore(m_tick_period->back(), t));
+
+  if (is_late) {
+    // a repeat of the last tick is dropped, the merge would only find it again
+    if (!TickPeriodT<T>::sIsBefore(t, m_tick_period->back())) return 0;
+
+    if (m_reorder_window.empty()) m_reorder_window_start = Time::sNow();
+    m_reorder_window.push_back(t);
+  }
+
+  // merged once enough of them are waiting, or once the oldest one waited long enough when ticks are sparse
+  if (!m_reorder_window.empty() &&
+      ((m_reorder_window.size() >= TRADE_REORDER_WINDOW_SIZE) ||
+       ((Time::sNow() - m_reorder_window_start) >= Duration(0, 0, 0, 0, TRADE_REORDER_WINDOW_MSEC))))
+    mergeReorderWindow();
+
+  if (is_late) return 0;
+
   int t_result = m_tick_period->append(t);
 
   if (t_result == 1) {
+    enforceRetention();
+
+    for (auto p_indicator : m_continuous_indicators) p_indicator->append(t);
+
+    // every interval adds the tick to its own last moments, a coarser candle derived from the finest one would still
+    // merge the moments on every tick, which is no cheaper than the add
     for (auto& candle_period : m_candle_periods) {
       int c_result = candle_period.second->appendTick(t);
       int num_candles = candle_period.second->size();
       Time last_candle_timestamp = candle_period.second->back().getTimeStamp();
 
+      if (c_result > 0) publishCandles(candle_period.first);
+
       if (c_result == 2 && num_candles > 1)  // new candlestick created
       {
         Duration interval = candle_period.first;
@@ -239,73 +323,315 @@ bool TradeHistoryT<T>::appendTrade(T& t) {
         // save controller stats
         saveStatsInCSV(interval);
 
-        if (m_indicators.find(interval) != m_indicators.end()) {
-          // add all the the mature candlesticks to indicators
-          int64_t num_candles_to_add =
-              (last_candle_timestamp - m_indicators[interval]->getLastTimeStamp()) / interval - 1;
-          for (int64_t i = (num_candles_to_add + 1); i > 1; i--) {
-            m_indicators[interval]->append(candle_period.second->at(num_candles - i));  // add the second latest candle
-          }
-        }
+        // all the candles before the new one are mature, a lazy indicator adds them when it's read
+        const auto indicators = m_indicators.equal_range(interval);
+        for (auto indicator_itr = indicators.first; indicator_itr != indicators.second; ++indicator_itr)
+          indicator_itr->second->advanceTo(last_candle_timestamp);
       }
     }
   }
 
-  // unlock tick based data
-  m_new_tick.unlock();
+  return t_result;
+}
 
-  if (m_ongoing_trading) p_Controller->UnlockTrading();
+template <>
+void TradeHistoryT<Tick>::controllerCallBack(const size_t a_num_new_ticks) {
+  m_num_callbacks++;
+  m_num_callback_ticks += a_num_new_ticks;
 
-  if (t_result == -1) return false;
+  if (m_ongoing_trading) {
+    Controller* p_Controller = TraderBot::getInstance()->getController();
+    ASSERT(p_Controller);
 
-  if (t_result == 1) controllerCallBack();
+    p_Controller->doRealTimeTrading(this, a_num_new_ticks);
+  }
+}
 
-  return true;
+template <>
+void TradeHistoryT<CoinAPITick>::controllerCallBack(const size_t a_num_new_ticks) {
+  m_num_callbacks++;
+  m_num_callback_ticks += a_num_new_ticks;
+
+  assert(!m_ongoing_trading);
 }
 
 template <>
-void TradeHistoryT<Tick>::controllerCallBack() const {
+void TradeHistoryT<Tick>::candleUpdateCallBack(const Time a_from) {
+  m_num_candle_updates++;
+
   if (m_ongoing_trading) {
     Controller* p_Controller = TraderBot::getInstance()->getController();
     ASSERT(p_Controller);
 
-    p_Controller->doRealTimeTrading(this);
+    p_Controller->doCandleUpdate(this, a_from);
   }
 }
 
 template <>
-void TradeHistoryT<CoinAPITick>::controllerCallBack() const {
+void TradeHistoryT<CoinAPITick>::candleUpdateCallBack(const Time a_from) {
+  m_num_candle_updates++;
+
   assert(!m_ongoing_trading);
 }
 
+template <typename T>
+Time TradeHistoryT<T>::takeCandlesUpdatedFrom() {
+  const Time candles_updated_from = m_candles_updated_from;
+  m_candles_updated_from = Time::sMax();
+
+  return candles_updated_from;
+}
+
 template <typename T>
 bool TradeHistoryT<T>::appendTrades(TickPeriodT<T>& tick_period) {
-  int result;
+  Controller* p_Controller = TraderBot::getInstance()->getController();
+  if (m_ongoing_trading) {
+    ASSERT(p_Controller);
+    p_Controller->LockTrading();
+  }
+
+  // lock tick based data once for the batch
+  m_new_tick.lock();
+
+  bool result = true;
+  size_t num_new_ticks = 0;
 
   for (auto& t : tick_period) {
-    result = this->appendTrade(t);
+    const int t_result = appendTradeLocked(t);
 
-    if (!result) {
+    if (t_result == -1) {
       CT_WARN << "Unable to add trades to TradeHistoryT\n";
-      return false;
+      result = false;
+      break;
     }
+
+    if (t_result == 1) num_new_ticks++;
   }
 
-  return true;
+  mergeReorderWindow();
+  const Time candles_updated_from = takeCandlesUpdatedFrom();
+
+  // unlock tick based data
+  m_new_tick.unlock();
+
+  if (m_ongoing_trading) p_Controller->UnlockTrading();
+
+  // the late ticks of the batch came before the new ones
+  if (candles_updated_from != Time::sMax()) candleUpdateCallBack(candles_updated_from);
+
+  // one event for all the new ticks of the batch
+  if (num_new_ticks > 0) controllerCallBack(num_new_ticks);
+
+  return result;
+}
+
+template <typename T>
+void TradeHistoryT<T>::mergeReorderWindow() {
+  if (m_reorder_window.empty()) return;
+
+  // also sorts the window
+  if (m_tick_period->merge(m_reorder_window) == 0) {
+    m_reorder_window.clear();  // all of them were there already
+    return;
+  }
+
+  m_candles_updated_from = min(m_candles_updated_from, m_reorder_window.front().getTimeStamp());
+
+  // candles which are already built are rebuilt with their late ticks
+  for (auto& candle_period : m_candle_periods) {
+    Time last_start_time = Time::sMax();
+
+    for (auto& t : m_reorder_window) {
+      const Time start_time = t.getTimeStamp().quantize(candle_period.first);
+      if (start_time == last_start_time) continue;
+
+      candle_period.second->updateCandle(*m_tick_period, start_time);
+      last_start_time = start_time;
+    }
+  }
+
+  m_reorder_window.clear();
+
+  publishCandles();
+}
+
+template <typename T>
+void TradeHistoryT<T>::flushReorderWindow() {
+  m_new_tick.lock();
+  mergeReorderWindow();
+  const Time candles_updated_from = takeCandlesUpdatedFrom();
+  m_new_tick.unlock();
+
+  if (candles_updated_from != Time::sMax()) candleUpdateCallBack(candles_updated_from);
+}
+
+template <typename T>
+void TradeHistoryT<T>::updateCandles(const Time a_from) {
+  // lock tick based data
+  m_new_tick.lock();
+
+  const auto first_itr =
+      lower_bound(m_tick_period->begin(), m_tick_period->end(), a_from,
+                  [](const T& a_tick, const Time a_time) { return (a_tick.getTimeStamp() < a_time); });
+
+  // every candle with ticks from a_from on, the last one included
+  for (auto& candle_period : m_candle_periods) {
+    Time last_start_time = Time::sMax();
+
+    for (auto tick_itr = first_itr; tick_itr != m_tick_period->end(); ++tick_itr) {
+      const Time start_time = tick_itr->getTimeStamp().quantize(candle_period.first);
+      if (start_time == last_start_time) continue;
+
+      candle_period.second->updateCandle(*m_tick_period, start_time);
+      last_start_time = start_time;
+    }
+  }
+
+  publishCandles();
+
+  // unlock tick based data
+  m_new_tick.unlock();
+}
+
+template <typename T>
+void TradeHistoryT<T>::setRetention(const retention_t& a_retention) {
+  m_new_tick.lock();
+
+  m_retention = a_retention;
+  enforceRetention();
+
+  m_new_tick.unlock();
+}
+
+template <typename T>
+void TradeHistoryT<T>::enforceRetention() {
+  const size_t max_ticks = m_retention.max_ticks;
+
+  // ticks of a view are evicted by its source
+  if (max_ticks && !m_tick_period->isView() &&
+      (m_tick_period->size() > (max_ticks + max_ticks / TRADE_RETENTION_SLACK_DIV))) {
+    // late ticks go in before the ticks are evicted, otherwise they would be added back to the front
+    mergeReorderWindow();
+
+    const size_t num_to_evict = m_tick_period->size() - max_ticks;
+
+    spillTicks(num_to_evict);
+    m_tick_period->evictFront(num_to_evict);
+  }
+
+  const size_t max_candles = m_retention.max_candles;
+  if (max_candles == 0) return;
+
+  for (auto& candle_period : m_candle_periods) {
+    CandlePeriodT<Candlestick, T>* p_candle_period = candle_period.second;
+
+    if (p_candle_period->size() > (max_candles + max_candles / TRADE_RETENTION_SLACK_DIV)) {
+      // a lazy indicator adds the candles before they are evicted
+      const auto indicators = m_indicators.equal_range(candle_period.first);
+      for (auto indicator_itr = indicators.first; indicator_itr != indicators.second; ++indicator_itr)
+        indicator_itr->second->catchUp();
+
+      p_candle_period->evictFront(p_candle_period->size() - max_candles);
+      publishCandles(candle_period.first);
+    }
+  }
+
+  // values are removed from the front of deques, one by one is cheap enough
+  for (auto& indicator : m_indicators) indicator.second->trimValues(max_candles);
+}
+
+template <>
+void TradeHistoryT<Tick>::spillTicks(const size_t a_num_ticks) {
+  if (g_tick_store_dir.empty()) return;  // left to the database
+
+  if (!m_tick_store) m_tick_store = new TickStore(g_tick_store_dir, m_db->getTableName(m_exchange_id, m_currency_pair));
+
+  // the deque of a view is empty, a view is spilled through its source
+  ASSERT(!m_tick_period->isView());
+
+  const deque<Tick>& ticks = *m_tick_period;
+  m_tick_store->append(ticks.begin(), ticks.begin() + min(a_num_ticks, ticks.size()));
+}
+
+template <>
+void TradeHistoryT<CoinAPITick>::spillTicks(const size_t a_num_ticks) {
+  // left to the database
 }
 
 template <typename T>
 void TradeHistoryT<T>::addCandlePeriod(Duration interval) {
+  // lock tick based data
+  m_new_tick.lock();
+
   if (m_candle_periods.find(interval) == m_candle_periods.end()) {
-    CandlePeriodT<Candlestick, T>* candle_period = new CandlePeriodT<Candlestick, T>(interval);
+    CandlePeriodT<Candlestick, T>* candle_period = newCandlePeriod(interval);
     m_candle_periods.insert(make_pair(interval, candle_period));
+    m_candle_snapshots[interval];
     candle_period->convertFrom(*m_tick_period);
+
+    publishCandles(interval);
   }
+
+  // unlock tick based data
+  m_new_tick.unlock();
 }
 
 template <typename T>
 void TradeHistoryT<T>::addCandlePeriod(const std::set<Duration>& a_intervals) {
-  for (auto duration : a_intervals) addCandlePeriod(duration);
+  vector<CandlePeriodT<Candlestick, T>*> new_periods;
+
+  // lock tick based data
+  m_new_tick.lock();
+
+  for (auto interval : a_intervals) {
+    if (m_candle_periods.find(interval) != m_candle_periods.end()) continue;
+
+    CandlePeriodT<Candlestick, T>* candle_period = newCandlePeriod(interval);
+    m_candle_periods.insert(make_pair(interval, candle_period));
+    m_candle_snapshots[interval];
+    new_periods.push_back(candle_period);
+  }
+
+  CandlePeriodT<Candlestick, T>::sConvertFrom(*m_tick_period, new_periods);
+
+  publishCandles();
+
+  // unlock tick based data
+  m_new_tick.unlock();
+}
+
+template <typename T>
+void TradeHistoryT<T>::convertTicksToCandles() {
+  vector<CandlePeriodT<Candlestick, T>*> candle_periods;
+
+  for (auto& candle_period : m_candle_periods) candle_periods.push_back(candle_period.second);
+
+  CandlePeriodT<Candlestick, T>::sConvertFrom(*m_tick_period, candle_periods);
+
+  publishCandles();
+}
+
+template <typename T>
+void TradeHistoryT<T>::publishCandles(const Duration a_interval) {
+  const CandlePeriodT<Candlestick, T>* p_candle_period = m_candle_periods.at(a_interval);
+
+  candle_snapshot_t snapshot;
+
+  const size_t num_candles = p_candle_period->getNumCandles();
+
+  snapshot.num_candles = static_cast<int64_t>(p_candle_period->getNumEvicted() + num_candles);
+  snapshot.num_recent = static_cast<int64_t>(min(num_candles, static_cast<size_t>(TRADE_SNAPSHOT_NUM_CANDLES)));
+
+  for (int64_t idx = 0; idx < snapshot.num_recent; idx++)
+    snapshot.recent_candles[idx] = p_candle_period->getCandleFromEnd(static_cast<size_t>(idx));
+
+  // the entry is created with the candle period, the map doesn't change under the readers
+  m_candle_snapshots.at(a_interval).store(snapshot);
+}
+
+template <typename T>
+void TradeHistoryT<T>::publishCandles() {
+  for (auto& candle_period : m_candle_periods) publishCandles(candle_period.first);
 }
 
 template <typename T>
@@ -314,15 +640,102 @@ bool TradeHistoryT<T>::loadFromDatabase(Time start_time, Time end_time) {
     clearData();
   }
 
-  m_tick_period->loadFromDatabase(m_db, start_time, end_time);
+  loadTicks(start_time, end_time);
 
-  for (auto& candle_period : m_candle_periods) {
-    candle_period.second->convertFrom(*m_tick_period);  // convert tick to candles
+  convertTicksToCandles();
+
+  return true;
+}
+
+template <typename T>
+void TradeHistoryT<T>::setViewOf(TradeHistoryT<T>* ap_full_history, const Time a_end_time) {
+  TickPeriodT<T>* p_full_period = ap_full_history->m_tick_period;
+
+  // ticks are ordered by time, the view is the prefix before the first tick at or after a_end_time
+  const size_t num_ticks =
+      lower_bound(p_full_period->begin(), p_full_period->end(), a_end_time,
+                  [](const T& a_tick, const Time a_time) { return (a_tick.getTimeStamp() < a_time); }) -
+      p_full_period->begin();
+
+  clearData();
+
+  m_tick_period->setView(p_full_period, num_ticks);
+
+  convertTicksToCandles();
+}
+
+template <typename T>
+bool TradeHistoryT<T>::sLoadFromDatabase(const vector<TradeHistoryT<T>*>& a_histories, Time start_time, Time end_time) {
+  // ticks in the local tick store are loaded by each history
+  if (is_same<T, Tick>::value && !g_tick_store_dir.empty()) {
+    for (auto p_history : a_histories) p_history->loadFromDatabase(start_time, end_time);
+    return true;
+  }
+
+  vector<Database<T>*> dbs;
+  vector<TickPeriodT<T>*> tick_periods;
+
+  for (auto p_history : a_histories) {
+    if (p_history->m_tick_period->size() > 0) p_history->clearData();
+
+    dbs.push_back(p_history->m_db);
+    tick_periods.push_back(p_history->m_tick_period);
   }
 
+  TickPeriodT<T>::sLoadFromDatabase(dbs, tick_periods, start_time, end_time);
+
+  for (auto p_history : a_histories) p_history->convertTicksToCandles();
+
   return true;
 }
 
+template <>
+void TradeHistoryT<Tick>::loadTicks(const Time a_start_time, const Time a_end_time) {
+  if (g_tick_store_dir.empty()) {
+    m_tick_period->loadFromDatabase(m_db, a_start_time, a_end_time);
+    return;
+  }
+
+  if (!m_tick_store) m_tick_store = new TickStore(g_tick_store_dir, m_db->getTableName(m_exchange_id, m_currency_pair));
+
+  if (!g_cass_session) {
+    m_tick_period->loadFromDatabase(m_tick_store, a_start_time, a_end_time);
+    return;
+  }
+
+  // days copied before a repair of the table are dropped
+  m_tick_store->setGeneration(m_db->getMetadata()->getGeneration());
+
+  // copy days before the consistent entry key which are missing in the tick store from Cassandra, later days may still
+  // change. Days without ticks are recorded as empty.
+  const primary_key_t consistent_key = m_db->getMetadata()->getConsistentEntryKey();
+  const int32_t consistent_date = Time(consistent_key.date, consistent_key.time).days_since_epoch();
+  const int32_t start_date =
+      (a_start_time == Time(0)) ? m_db->getMetadata()->getMinDate() : a_start_time.days_since_epoch();
+  const int32_t last_complete_date = min(Time::sNow().days_since_epoch(), consistent_date) - 1;
+  const int32_t end_date = min(last_complete_date, a_end_time.days_since_epoch());
+
+  for (int32_t date = start_date; date <= end_date; ++date) {
+    if (m_tick_store->hasSegment(date)) continue;
+
+    deque<Tick> day_ticks;
+    m_db->loadData(day_ticks, Time(date, 0), Time(date + 1, 0));
+
+    if (day_ticks.empty())
+      m_tick_store->addEmptyDay(date);
+    else
+      m_tick_store->append(day_ticks);
+  }
+
+  // the ticks after the copied days are loaded from Cassandra
+  m_tick_period->loadFromDatabase(m_tick_store, m_db, a_start_time, Time(end_date + 1, 0), a_end_time);
+}
+
+template <>
+void TradeHistoryT<CoinAPITick>::loadTicks(const Time a_start_time, const Time a_end_time) {
+  m_tick_period->loadFromDatabase(m_db, a_start_time, a_end_time);
+}
+
 template <typename T>
 bool TradeHistoryT<T>::addIndicator(Duration interval, DiscreteIndicatorA<Candlestick, T>* indicator) {
   if (m_candle_periods.find(interval) == m_candle_periods.end()) {
@@ -332,6 +745,8 @@ bool TradeHistoryT<T>::addIndicator(Duration interval, DiscreteIndicatorA<Candle
 
   assert(indicator->getInterval() == interval);
 
+  // indicators logged to CSV stay eager
+  indicator->setLazy(g_lazy_indicators && (m_logs.find(interval) == m_logs.end()));
   indicator->constructFrom(*m_candle_periods[interval]);
 
   m_indicators.insert(make_pair(interval, indicator));
@@ -339,6 +754,15 @@ bool TradeHistoryT<T>::addIndicator(Duration interval, DiscreteIndicatorA<Candle
   return true;
 }
 
+template <typename T>
+void TradeHistoryT<T>::addContinuousIndicator(ContinuousIndicatorA<T>* indicator) {
+  assert((indicator->getExchangeId() == m_exchange_id) && (indicator->getCurrencyPair() == m_currency_pair));
+
+  indicator->constructFrom(*m_tick_period);
+
+  m_continuous_indicators.push_back(indicator);
+}
+
 template <typename T>
 string TradeHistoryT<T>::createDir(const string& a_csv_file_dir) const {
   const string dir = a_csv_file_dir + "/" + Exchange::sExchangeToString(m_exchange_id);
@@ -352,7 +776,7 @@ Candlestick TradeHistoryT<T>::getCandleFromBegin(Duration interval, const int ca
   m_new_tick.lock();
 
   auto candle_period = m_candle_periods.at(interval);
-  const Candlestick candle = candle_period->at(candle_idx);
+  const Candlestick candle = candle_period->getCandle(candle_idx);
 
   // unlock tick based data
   m_new_tick.unlock();
@@ -362,11 +786,14 @@ Candlestick TradeHistoryT<T>::getCandleFromBegin(Duration interval, const int ca
 
 template <typename T>
 Candlestick TradeHistoryT<T>::getCandleFromEnd(Duration interval, const int candle_idx) const {
+  const candle_snapshot_t snapshot = m_candle_snapshots.at(interval).load();
+  if ((candle_idx >= 0) && (candle_idx < snapshot.num_recent)) return snapshot.recent_candles[candle_idx];
+
   // lock tick based data
   m_new_tick.lock();
 
   auto candle_period = m_candle_periods.at(interval);
-  const Candlestick candle = candle_period->at(candle_period->size() - candle_idx - 1);
+  const Candlestick candle = candle_period->getCandleFromEnd(candle_idx);
 
   // unlock tick based data
   m_new_tick.unlock();
@@ -376,6 +803,27 @@ Candlestick TradeHistoryT<T>::getCandleFromEnd(Duration interval, const int cand
 
 template <typename T>
 Candlestick TradeHistoryT<T>::getLastCandle(Duration interval, const Time a_cur_time, const int a_idx_from_back) const {
+  assert(m_candle_snapshots.find(interval) != m_candle_snapshots.end());
+  const candle_snapshot_t snapshot = m_candle_snapshots.at(interval).load();
+
+  if (snapshot.num_recent > 0) {
+    const Candlestick& last_candle = snapshot.recent_candles[0];
+
+    int num_missing_candles = ((a_cur_time - last_candle.getTimeStamp() - 1L) / interval);
+    if (num_missing_candles > a_idx_from_back) {
+      Candlestick cs;
+      cs.setTimeStamp(last_candle.getTimeStamp() + (interval * num_missing_candles));
+      cs.setPrice(last_candle.getClose());
+
+      return cs;
+    }
+
+    const int idx_from_back = (a_idx_from_back - num_missing_candles);
+    if ((idx_from_back >= 0) && (idx_from_back < snapshot.num_recent)) return snapshot.recent_candles[idx_from_back];
+  }
+
+  // older candles are read from the candle period
+
   // lock tick based data
   m_new_tick.lock();
 
@@ -396,8 +844,8 @@ Candlestick TradeHistoryT<T>::getLastCandle(Duration interval, const Time a_cur_
     return cs;
   }
 
-  const int candle_idx = (candle_period->size() + num_missing_candles - a_idx_from_back - 1);
-  const Candlestick candle = candle_period->at(candle_idx);
+  const int candle_idx = (candle_period->getNumCandles() + num_missing_candles - a_idx_from_back - 1);
+  const Candlestick candle = candle_period->getCandle(candle_idx);
 
   // unlock tick based data
   m_new_tick.unlock();
@@ -407,32 +855,18 @@ Candlestick TradeHistoryT<T>::getLastCandle(Duration interval, const Time a_cur_
 
 template <typename T>
 void TradeHistoryT<T>::populateNumCandles(map<Duration, int>& nunCandlesHash) const {
-  // lock tick based data
-  m_new_tick.lock();
-
-  for (auto iter : m_candle_periods) {
+  for (auto& iter : m_candle_snapshots) {
     Duration duration = iter.first;
-    auto candle_period = iter.second;
 
-    nunCandlesHash[duration] = candle_period->size();
+    nunCandlesHash[duration] = static_cast<int>(iter.second.load().num_candles);
   }
-
-  // unlock tick based data
-  m_new_tick.unlock();
 }
 
 template <typename T>
 int TradeHistoryT<T>::getNumCandles(Duration interval) const {
-  // lock tick based data
-  m_new_tick.lock();
-
-  ASSERT(m_candle_periods.find(interval) != m_candle_periods.end());
-  int numCandle = m_candle_periods.at(interval)->size();
-
-  // unlock tick based data
-  m_new_tick.unlock();
+  ASSERT(m_candle_snapshots.find(interval) != m_candle_snapshots.end());
 
-  return numCandle;
+  return static_cast<int>(m_candle_snapshots.at(interval).load().num_candles);
 }
 
 template <typename T>
@@ -9,9 +9,14 @@
 //
 
 #include "TraderBot.h"
+#include "CMCandleStick.h"
+#include "Candlestick.h"
 #include "CoinAPI.h"
+#include "CoinAPITick.h"
 #include "CoinMarketCap.h"
 #include "Controller.h"
+#include "Database.h"
+#include "PartitionCache.h"
 #include "Tick.h"
 #include "dbServer.h"
 #include "exchanges/GDAX.h"
@@ -34,9 +39,10 @@ void signal_handler(int signal) {
   } else {
     std::signal(signal, SIG_DFL);
     std::thread t([=] {
-      g_critcal_task.lock();
+      // stop once the database writes in flight are counted in the metadata
+      unique_lock<mutex> lock(g_critcal_task);
+      g_db_writes_drained.wait(lock, [] { return g_db_writes_in_flight == 0; });
       kill(getpid(), signal);
-      g_critcal_task.unlock();
     });
     t.detach();
   }
@@ -125,6 +131,8 @@ TraderBot::TraderBot()
   m_capture_gemini_update = false;
   m_update_coinapi = false;
   m_fix_database = false;
+  m_migrated_table = "";
+  m_migrated_bucket_width = bucket_width_t::DAY;
   m_enable_gemini = false;
   m_user_id = 1;
   m_csv_database_dir = "";
@@ -138,6 +146,12 @@ TraderBot::TraderBot()
 TraderBot::~TraderBot() {
   if (m_early_exit) exit(0);
 
+  {
+    // writes still running on other threads finish before the globals they use go away
+    unique_lock<mutex> lock(g_critcal_task);
+    g_db_writes_drained.wait(lock, [] { return g_db_writes_in_flight == 0; });
+  }
+
   DELETE(mp_coinmarketcap);
 
   DELETE(mp_coinapi);
@@ -148,6 +162,8 @@ TraderBot::~TraderBot() {
 
   DELETE(mp_trading_ctrl);
 
+  DELETE(g_partition_cache);
+
   g_exiting = true;
 
   m_thread_pool.shutdown();
@@ -251,6 +267,46 @@ int TraderBot::traderMain(const int argc, const char** argv) {
     return 0;
   }
 
+  // change partition width of a table
+  if (m_migrated_table != "") {
+    const string table_type = dbMetadata::sGetType("crypto", m_migrated_table);
+
+    // the table is dropped and recreated, rows written meanwhile would be lost
+    const bool capturing =
+        m_capture_gdax_update || m_capture_gemini_update || m_capture_coinmarketcap_update || m_update_coinapi;
+
+    // trade ids of a tick table are consecutive if its exchange has consecutive trades, a shared table has the symbols
+    // of all exchanges. CoinAPI trades aren't consecutive, see CoinAPIHistory.
+    bool consecutive = true;
+    for (Exchange* p_exchange : {static_cast<Exchange*>(mp_gdax), static_cast<Exchange*>(mp_gemini)}) {
+      if (!p_exchange) continue;
+
+      const string suffix = "_" + p_exchange->getExchangeIDString(true);
+      const bool exchange_table = (m_migrated_table.size() > suffix.size()) &&
+                                  (m_migrated_table.compare(m_migrated_table.size() - suffix.size(), suffix.size(),
+                                                            suffix) == 0);
+
+      if (exchange_table || (m_migrated_table == Database<Tick>::getSharedTableName()))
+        consecutive = consecutive && p_exchange->isConsecutive();
+    }
+
+    if (capturing) {
+      CT_CRIT_WARN << m_migrated_table << " isn't migrated while data is being captured\n";
+    } else if (table_type == Tick::m_type) {
+      Database<Tick>::sMigrateTable("crypto", m_migrated_table, m_migrated_bucket_width, consecutive);
+    } else if (table_type == CMCandleStick::m_type) {
+      Database<CMCandleStick>::sMigrateTable("crypto", m_migrated_table, m_migrated_bucket_width, true);
+    } else if (table_type == CoinAPITick::m_type) {
+      Database<CoinAPITick>::sMigrateTable("crypto", m_migrated_table, m_migrated_bucket_width, false);
+    } else if (table_type == Candlestick::m_type) {
+      Database<Candlestick>::sMigrateTable("crypto", m_migrated_table, m_migrated_bucket_width, true);
+    } else {
+      CT_CRIT_WARN << "Unknown table " << m_migrated_table << ", not migrated\n";
+    }
+
+    return 0;
+  }
+
   // repair database
   if (m_fix_database) {
     for (auto iter : mp_gdax->getMarkets()) {
@@ -320,6 +376,16 @@ void TraderBot::resetGlobals() const {
   g_random = true;
   g_exiting = false;
   g_order_idx = 0;
+  g_tick_store_dir = "";
+  g_shared_tables = false;
+  g_sparse_candle_sec = 0;
+  g_retention_ticks = 0;
+  g_retention_candles = 0;
+  g_lazy_indicators = false;
+  DELETE(g_partition_cache);
+
+  lock_guard<mutex> lock(g_created_tables_mutex);
+  g_created_tables.clear();
 }
 
 void TraderBot::checkForSize() const {
@@ -238,7 +238,12 @@ void Exchange::initForTrading(const Duration history_duration, const Time start_
       if (m_mode != exchange_mode_t::REAL) getVirFullHistory().insert(make_pair(trading_pair, th_full));
 
       th_past = new TradeHistory(exchange_t::COINBASE, trading_pair);
-      th_past->appendTrades(*th_full->getTickPeriod());
+      th_past->setViewOf(th_full);
+
+      // only the recent data stays in memory while trading in real time
+      const retention_t retention = {g_retention_ticks, g_retention_candles};
+      th_full->setRetention(retention);
+      th_past->setRetention(retention);
 
       if (m_mode != exchange_mode_t::SIMULATION) m_histories_till_ctrl_time.insert(make_pair(trading_pair, th_past));
 
@@ -274,8 +279,9 @@ void Exchange::initForTrading(const Duration history_duration, const Time start_
       th_full = new TradeHistory(exchange_t::COINBASE, trading_pair);
       th_past = m_markets[trading_pair]->getTradeHistory();
 
+      // the history till start time is a prefix of the full history, so it's a view instead of a second load
       th_full->loadFromDatabase(start_time - history_duration, end_time);
-      th_past->loadFromDatabase(start_time - history_duration, start_time);
+      th_past->setViewOf(th_full, start_time);
 
       getVirFullHistory().insert(make_pair(trading_pair, th_full));
       getVirPartHistory().insert(make_pair(trading_pair, th_past));
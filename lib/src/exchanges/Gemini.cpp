@@ -433,12 +433,19 @@ int64_t Gemini::storeInitialTrades(const CurrencyPair currency_pair) {
   // create folder if required
   TradeUtils::createDir(csv_foldername);
 
+  // trades up to this key may already be stored, also when the table isn't filled from the beginning (e.g. an import
+  // stopped midway), so they are checked with IF NOT EXISTS
+  primary_key_t last_stored_key = {0, 0, 0};
+
+  if (db->getMetadata()->getNumEntries() > 0) last_stored_key = db->getMetadata()->getMaxEntryKey();
+
   if (db->checkIfFilledFromBeginning() == false)
     csv_date = csv_initial_date;
   else {
     Tick newest_row;
     db->getNewestRow(newest_row);
     csv_date = newest_row.getTimeStamp().quantize(Duration(1));
+    last_stored_key = newest_row.getPrimaryKey();
   }
 
   while (true) {
@@ -495,7 +502,14 @@ int64_t Gemini::storeInitialTrades(const CurrencyPair currency_pair) {
     COUT << "trades.size() = " << trades.size() << " csv_lines_count = " << csv_lines_count << endl;
     assert(trades.size() == csv_lines_count / 2);
 
-    num_trades_saved += trades.storeToDatabase(db);
+    // trades after the newest stored one are new, so they can be written in unlogged batches without IF NOT EXISTS
+    ASSERT(!trades.isView());
+    TickPeriod::sFixTimestamps(trades);
+    auto new_trades_itr = find_if(trades.begin(), trades.end(),
+                                  [&](const Tick& trade) { return trade.getPrimaryKey() > last_stored_key; });
+
+    num_trades_saved += db->storeData(trades.begin(), new_trades_itr);
+    num_trades_saved += db->storeDataInBatch(new_trades_itr, trades.end());
 
     if (csv_date == csv_initial_date) db->updateOldestEntryMetadata();
 
@@ -0,0 +1,85 @@
+//
+// Created by subhagato on 10/18/26.
+//
+
+#include "indicators/CandleColumns.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define CANDLE_COLUMNS_AVX2 1
+#endif
+
+// volume below which a candle is weighted as if it had this volume
+#define CANDLE_MIN_VOLUME 1e-9
+
+using namespace std;
+
+const vector<double>& candle_columns_t::get(const candle_price_t a_price) const {
+  switch (a_price) {
+    case candle_price_t::CLOSE:
+      return close;
+    case candle_price_t::LOW:
+      return low;
+    case candle_price_t::HIGH:
+      return high;
+    case candle_price_t::MEAN:
+      return mean;
+    default:
+      return open;
+  }
+}
+
+static void weightVolumes(const double* a_prices, const double* a_volumes, const size_t a_num_candles,
+                          double* a_clamped, double* a_products) {
+  for (size_t i = 0; i < a_num_candles; i++) {
+    a_clamped[i] = max(CANDLE_MIN_VOLUME, a_volumes[i]);
+    a_products[i] = a_prices[i] * a_clamped[i];
+  }
+}
+
+#ifdef CANDLE_COLUMNS_AVX2
+// four candles at a time, max and multiply are exact so the results are the same as weightVolumes
+__attribute__((target("avx2"))) static void weightVolumesAvx2(const double* a_prices, const double* a_volumes,
+                                                               const size_t a_num_candles, double* a_clamped,
+                                                               double* a_products) {
+  const __m256d min_volume = _mm256_set1_pd(CANDLE_MIN_VOLUME);
+  size_t i = 0;
+
+  for (; i + 4 <= a_num_candles; i += 4) {
+    // the second operand is returned for a NaN volume, the minimum volume as with std::max
+    const __m256d clamped = _mm256_max_pd(_mm256_loadu_pd(a_volumes + i), min_volume);
+
+    _mm256_storeu_pd(a_clamped + i, clamped);
+    _mm256_storeu_pd(a_products + i, _mm256_mul_pd(_mm256_loadu_pd(a_prices + i), clamped));
+  }
+
+  weightVolumes(a_prices + i, a_volumes + i, a_num_candles - i, a_clamped + i, a_products + i);
+}
+
+static bool sHasAvx2() {
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  return has_avx2;
+}
+#endif
+
+void candle_columns_t::getWeightedVolumes(const candle_price_t a_price, vector<double>& a_volumes,
+                                          vector<double>& a_products) const {
+  const vector<double>& prices = get(a_price);
+  const size_t num_candles = size();
+
+  a_volumes.resize(num_candles);
+  a_products.resize(num_candles);
+
+  if (num_candles == 0) return;
+
+#ifdef CANDLE_COLUMNS_AVX2
+  if (sHasAvx2()) {
+    weightVolumesAvx2(prices.data(), volume.data(), num_candles, a_volumes.data(), a_products.data());
+    return;
+  }
+#endif
+
+  weightVolumes(prices.data(), volume.data(), num_candles, a_volumes.data(), a_products.data());
+}
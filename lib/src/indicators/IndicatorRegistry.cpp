@@ -0,0 +1,130 @@
+//
+// Created by subhagato on 10/18/26.
+//
+
+#include "indicators/IndicatorRegistry.h"
+
+#include "TradeHistory.h"
+
+using namespace std;
+
+// type and parameters of a node e.g. "EMA(26,1)", the price is the last parameter
+static indicator_key_t sMakeKey(const exchange_t a_exchange_id, const CurrencyPair& a_currency_pair,
+                                const Duration a_interval, const string& a_type, const vector<int>& a_params,
+                                const candle_price_t a_price) {
+  string name = a_type + "(";
+  for (int param : a_params) name += to_string(param) + ",";
+  name += to_string(static_cast<int>(a_price)) + ")";
+
+  return indicator_key_t{a_exchange_id, a_currency_pair, a_interval, name};
+}
+
+IndicatorRegistry::~IndicatorRegistry() {
+  // derived nodes are deleted before the nodes they read
+  for (auto node_itr = m_nodes.rbegin(); node_itr != m_nodes.rend(); ++node_itr) {
+    DiscreteIndicatorA<>* p_node = node_itr->second;
+    DELETE(p_node);
+  }
+
+  m_nodes.clear();
+  m_node_map.clear();
+}
+
+DiscreteIndicator<EMA>* IndicatorRegistry::getEMA(const exchange_t a_exchange_id, const CurrencyPair& a_currency_pair,
+                                                  const Duration a_interval, const int a_period,
+                                                  const candle_price_t a_price) {
+  return getNode<EMA>(sMakeKey(a_exchange_id, a_currency_pair, a_interval, "EMA", {a_period}, a_price), [&]() {
+    return new DiscreteIndicator<EMA>(a_exchange_id, a_currency_pair, a_interval, EMA(a_period, a_price));
+  });
+}
+
+DiscreteIndicator<SMA>* IndicatorRegistry::getSMA(const exchange_t a_exchange_id, const CurrencyPair& a_currency_pair,
+                                                  const Duration a_interval, const int a_period,
+                                                  const candle_price_t a_price) {
+  return getNode<SMA>(sMakeKey(a_exchange_id, a_currency_pair, a_interval, "SMA", {a_period}, a_price), [&]() {
+    return new DiscreteIndicator<SMA>(a_exchange_id, a_currency_pair, a_interval, SMA(a_period, a_price));
+  });
+}
+
+DiscreteIndicator<MA>* IndicatorRegistry::getMA(const exchange_t a_exchange_id, const CurrencyPair& a_currency_pair,
+                                                const Duration a_interval, const int a_period,
+                                                const bool a_volume_weighted, const candle_price_t a_price) {
+  const indicator_key_t key =
+      sMakeKey(a_exchange_id, a_currency_pair, a_interval, "MA", {a_period, a_volume_weighted}, a_price);
+
+  return getNode<MA>(key, [&]() {
+    return new DiscreteIndicator<MA>(a_exchange_id, a_currency_pair, a_interval,
+                                     MA(a_period, a_volume_weighted, a_price));
+  });
+}
+
+DiscreteIndicator<RSI>* IndicatorRegistry::getRSI(const exchange_t a_exchange_id, const CurrencyPair& a_currency_pair,
+                                                  const Duration a_interval, const int a_period,
+                                                  const candle_price_t a_price) {
+  return getNode<RSI>(sMakeKey(a_exchange_id, a_currency_pair, a_interval, "RSI", {a_period}, a_price), [&]() {
+    return new DiscreteIndicator<RSI>(a_exchange_id, a_currency_pair, a_interval, RSI(a_period, a_price));
+  });
+}
+
+DiscreteIndicator<STDDEV>* IndicatorRegistry::getSTDDEV(const exchange_t a_exchange_id,
+                                                        const CurrencyPair& a_currency_pair,
+                                                        const Duration a_interval, const int a_period,
+                                                        const candle_price_t a_price) {
+  return getNode<STDDEV>(sMakeKey(a_exchange_id, a_currency_pair, a_interval, "STDDEV", {a_period}, a_price), [&]() {
+    return new DiscreteIndicator<STDDEV>(a_exchange_id, a_currency_pair, a_interval, STDDEV(a_period, a_price));
+  });
+}
+
+DiscreteIndicator<TEMA>* IndicatorRegistry::getTEMA(const exchange_t a_exchange_id,
+                                                    const CurrencyPair& a_currency_pair, const Duration a_interval,
+                                                    const int a_period, const candle_price_t a_price) {
+  return getNode<TEMA>(sMakeKey(a_exchange_id, a_currency_pair, a_interval, "TEMA", {a_period}, a_price), [&]() {
+    return new DiscreteIndicator<TEMA>(a_exchange_id, a_currency_pair, a_interval, TEMA(a_period, a_price));
+  });
+}
+
+DiscreteIndicator<DerivedMACD>* IndicatorRegistry::getMACD(const exchange_t a_exchange_id,
+                                                           const CurrencyPair& a_currency_pair,
+                                                           const Duration a_interval, const int a_fast_period,
+                                                           const int a_slow_period, const int a_signal_period,
+                                                           const candle_price_t a_price) {
+  const indicator_key_t key = sMakeKey(a_exchange_id, a_currency_pair, a_interval, "MACD",
+                                       {a_fast_period, a_slow_period, a_signal_period}, a_price);
+
+  return getNode<DerivedMACD>(key, [&]() {
+    // the EMA nodes are created first, so they are fed before the MACD
+    DiscreteIndicator<EMA>* p_fast_ema = getEMA(a_exchange_id, a_currency_pair, a_interval, a_fast_period, a_price);
+    DiscreteIndicator<EMA>* p_slow_ema = getEMA(a_exchange_id, a_currency_pair, a_interval, a_slow_period, a_price);
+
+    return new DiscreteIndicator<DerivedMACD>(
+        a_exchange_id, a_currency_pair, a_interval,
+        DerivedMACD(p_fast_ema, p_slow_ema, a_fast_period, a_slow_period, a_signal_period));
+  });
+}
+
+set<Duration> IndicatorRegistry::getIntervals(const exchange_t a_exchange_id,
+                                              const CurrencyPair& a_currency_pair) const {
+  set<Duration> intervals;
+
+  for (auto& node : m_nodes) {
+    if ((node.first.exchange_id == a_exchange_id) && (node.first.currency_pair == a_currency_pair))
+      intervals.insert(node.first.interval);
+  }
+
+  return intervals;
+}
+
+void IndicatorRegistry::addTo(TradeHistoryT<Tick>* ap_trade_history) const {
+  const exchange_t exchange_id = ap_trade_history->getExchangeId();
+  const CurrencyPair& currency_pair = ap_trade_history->getCurrencyPair();
+
+  const set<Duration> intervals = getIntervals(exchange_id, currency_pair);
+  if (intervals.empty()) return;
+
+  ap_trade_history->addCandlePeriod(intervals);
+
+  for (auto& node : m_nodes) {
+    if ((node.first.exchange_id == exchange_id) && (node.first.currency_pair == currency_pair))
+      ap_trade_history->addIndicator(node.first.interval, node.second);
+  }
+}
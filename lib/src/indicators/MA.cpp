@@ -9,24 +9,24 @@ using namespace std;
 void MA::append(const Candlestick& candle) {
   double volume = candle.getTotalVolume();
   double price = candle.get(m_select_price);
-  double edge_price = 0;
-  double edge_volume = 0;
+  pair<double, double> edge;
 
   volume = max(1e-9, volume);
 
   if (m_history.size() == 0)  // build up the history with same values
   {
     for (uint32_t i = 0; i < m_time_period; i++) {
-      m_history.push(make_tuple(price, volume));
+      m_history.push(make_pair(price, volume));
       m_total_volume += volume;
     }
     m_moving_average = price;
   }
 
-  m_history.push(make_tuple(price, volume));
+  // the oldest candle leaves the window
+  m_history.push(make_pair(price, volume), &edge);
 
-  edge_price = get<0>(m_history.front());
-  edge_volume = get<1>(m_history.front());
+  const double edge_price = edge.first;
+  const double edge_volume = edge.second;
 
   if (m_volume_weighted) {
     m_moving_average = (m_moving_average * m_total_volume + price * volume - edge_price * edge_volume) /
@@ -36,7 +36,86 @@ void MA::append(const Candlestick& candle) {
     m_moving_average = (m_moving_average * m_time_period + price - edge_price) / m_time_period;
   }
 
-  if (m_history.size() == (m_time_period + 1)) m_history.pop();
-
   m_values.push_back({m_moving_average});
 }
+
+void MA::appendRun(const Candlestick& candle, const size_t a_count) {
+  const size_t num_appended = min(a_count, static_cast<size_t>(m_time_period));
+
+  for (size_t i = 0; i < num_appended; i++) append(candle);
+
+  if (num_appended == a_count) return;
+
+  // the window holds only the candle, the average is its price
+  const double volume = max(1e-9, candle.getTotalVolume());
+  const double price = candle.get(m_select_price);
+
+  m_history.clear();
+  for (uint32_t i = 0; i < m_time_period; i++) m_history.push(make_pair(price, volume));
+
+  m_total_volume = volume * m_time_period;
+  m_moving_average = price;
+
+  m_values.insert(m_values.end(), a_count - num_appended, {m_moving_average});
+}
+
+void MA::appendBatch(const candle_columns_t& a_columns) {
+  const size_t num_candles = a_columns.size();
+  if (num_candles == 0) return;
+
+  const vector<double>& prices = a_columns.get(m_select_price);
+
+  // clamped volumes and price times volume of every candle, the element-wise part of the recursion
+  vector<double> volumes, products;
+  a_columns.getWeightedVolumes(m_select_price, volumes, products);
+
+  // (price, volume, product) of the window before the first candle followed by the candles, the candle leaving the
+  // window when candle i is added is at i
+  vector<double> window_prices, window_volumes, window_products;
+  window_prices.reserve(m_time_period + num_candles);
+  window_volumes.reserve(m_time_period + num_candles);
+  window_products.reserve(m_time_period + num_candles);
+
+  if (m_history.size() == 0)  // build up the history with same values
+  {
+    for (uint32_t i = 0; i < m_time_period; i++) {
+      window_prices.push_back(prices[0]);
+      window_volumes.push_back(volumes[0]);
+      window_products.push_back(products[0]);
+      m_total_volume += volumes[0];
+    }
+    m_moving_average = prices[0];
+  } else {
+    for (size_t i = 0; i < m_history.size(); i++) {
+      window_prices.push_back(m_history[i].first);
+      window_volumes.push_back(m_history[i].second);
+      window_products.push_back(m_history[i].first * m_history[i].second);
+    }
+  }
+
+  window_prices.insert(window_prices.end(), prices.begin(), prices.end());
+  window_volumes.insert(window_volumes.end(), volumes.begin(), volumes.end());
+  window_products.insert(window_products.end(), products.begin(), products.end());
+
+  // the running sums of append, in the same order so the values are identical
+  for (size_t i = 0; i < num_candles; i++) {
+    const size_t edge = i;
+    const size_t added = m_time_period + i;
+
+    if (m_volume_weighted) {
+      m_moving_average = (m_moving_average * m_total_volume + window_products[added] - window_products[edge]) /
+                         (m_total_volume + window_volumes[added] - window_volumes[edge]);
+      m_total_volume += (window_volumes[added] - window_volumes[edge]);
+    } else {
+      m_moving_average =
+          (m_moving_average * m_time_period + window_prices[added] - window_prices[edge]) / m_time_period;
+    }
+
+    m_values.push_back({m_moving_average});
+  }
+
+  // the window of the last candle, as left by append
+  m_history.clear();
+  for (size_t i = num_candles; i < num_candles + m_time_period; i++)
+    m_history.push(make_pair(window_prices[i], window_volumes[i]));
+}
@@ -30,8 +30,7 @@ MarketOrderAlgo::MarketOrderAlgo() : TradeAlgo(tradeAlgo_t::BASICMARKET) {
 }
 
 void MarketOrderAlgo::updateIndicator(const exchange_t exchange_id, const CurrencyPair& currency_pair) {
-  auto indicator = new DiscreteIndicator<MA>(exchange_id, currency_pair, 1_min, MA(5, true, candle_price_t::MEAN));
-  registerIndicator(indicator);
+  mp_indicator_registry->getMA(exchange_id, currency_pair, 1_min, 5, true, candle_price_t::MEAN);
 }
 
 void MarketOrderAlgo::init(const Time a_cur_time, const vector<const TradeHistory*>& ap_past_trade_histories) {
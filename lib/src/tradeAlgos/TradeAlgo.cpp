@@ -35,6 +35,8 @@ TradeAlgo::TradeAlgo(const tradeAlgo_t a_tradeAlgo_idx) : m_algo_idx(a_tradeAlgo
 
   m_max_event_check_time = 0;
   m_max_event_time = 0;
+
+  mp_indicator_registry = NULL;
 }
 
 TradeAlgo::~TradeAlgo() {
@@ -51,6 +53,11 @@ TradeAlgo::~TradeAlgo() {
       }
     }
   }
+
+  for (auto p_indicator : m_continuous_indicators) {
+    DELETE(p_indicator);
+  }
+  m_continuous_indicators.clear();
 }
 
 void TradeAlgo::checkForEvent(const Time a_cur_time, const bool a_interval_event) {
@@ -174,6 +181,10 @@ void TradeAlgo::registerIndicator(DiscreteIndicatorA<>* indicator) {
   m_indicator_map[exchange_id][interval][currency_pair] = indicator;
 }
 
+void TradeAlgo::registerContinuousIndicator(ContinuousIndicatorA<>* ap_indicator) {
+  m_continuous_indicators.push_back(ap_indicator);
+}
+
 Duration TradeAlgo::getMinInterval() const {
   Duration min_interval;
 
@@ -13,7 +13,9 @@
 
 #include <catch2/catch.hpp>
 
+#include <atomic>
 #include <thread>
+#include <utils/SeqLock.h>
 #include <utils/Volume.h>
 
 #include "TraderBot.h"
@@ -102,6 +104,44 @@ TEST_CASE("volume", "[basic][precommit]") {
   cout << "v3 = " << v3 << endl;
 }
 
+TEST_CASE("seqlock", "[basic][precommit]") {
+  // every field of a published value holds the same number, a torn read would mix two of them
+  typedef struct seqlock_value_t {
+    int64_t fields[8];
+  } seqlock_value_t;
+
+  SeqLock<seqlock_value_t> published;
+  atomic<bool> done(false);
+
+  thread writer([&]() {
+    for (int64_t i = 1; i <= 1000000; i++) {
+      seqlock_value_t value;
+      for (auto& field : value.fields) field = i;
+      published.store(value);
+    }
+    done = true;
+  });
+
+  int64_t last_seen = 0;
+  bool consistent = true;
+  bool ordered = true;
+
+  while (!done) {
+    const seqlock_value_t value = published.load();
+
+    for (auto field : value.fields) consistent &= (field == value.fields[0]);
+    ordered &= (value.fields[0] >= last_seen);
+    last_seen = value.fields[0];
+  }
+
+  writer.join();
+
+  REQUIRE(consistent);
+  REQUIRE(ordered);
+  REQUIRE(published.load().fields[7] == 1000000);
+  REQUIRE(published.getVersion() == 1000001);
+}
+
 TEST_CASE("signal", "[basic][precommit]") {
   TraderBot* trader_bot = TraderBot::getInstance();
   REQUIRE(!trader_bot->traderMain());
@@ -0,0 +1,371 @@
+//
+//*****************************************************************
+//
+// WARRANTY:
+// Use all material in this file at your own risk.
+//
+// Created by subhagato on 10/18/26.
+//
+// This consists benchmarks of the in memory data structures.
+
+#include <algorithm>
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+#include "CandlePeriod.h"
+#include "Tick.h"
+#include "TickColumns.h"
+#include "TickPeriod.h"
+#include "TradeHistory.h"
+#include "TraderBot.h"
+#include "indicators/DiscreteIndicator.h"
+#include "indicators/RollingWindow.h"
+
+using namespace std;
+
+#define BENCHMARK_NUM_TICKS 4000000
+
+// runs a_foo a_num_runs times and returns the best run in seconds
+template <typename F>
+static double timeBestOf(const int a_num_runs, F a_foo) {
+  double best = 0;
+
+  for (int run = 0; run < a_num_runs; ++run) {
+    const auto start = chrono::steady_clock::now();
+    a_foo();
+    const double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    if ((run == 0) || (elapsed < best)) best = elapsed;
+  }
+
+  return best;
+}
+
+static Tick makeBenchmarkTick(const Time a_start_time, const int64_t a_idx) {
+  // ~4 ticks per second with a random walk like price
+  return Tick(a_start_time + Duration(a_idx * 250000), 1000000000 + a_idx, 7000 + ((a_idx * 7919) % 1000) * 0.01,
+              ((a_idx % 3) ? 0.1 : -0.2));
+}
+
+TEST_CASE("benchmark_tick_storage", "[benchmark]") {
+  COUT << CBLUE << "TEST: benchmark_tick_storage [benchmark]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  const Time start_time(2019, 12, 17, 0, 0, 0);
+
+  vector<Tick> ticks;
+  for (int64_t idx = 0; idx < BENCHMARK_NUM_TICKS; ++idx) ticks.push_back(makeBenchmarkTick(start_time, idx));
+
+  TickPeriod tick_period;
+  TickColumns tick_columns;
+
+  const double deque_append = timeBestOf(3, [&]() {
+    tick_period.clear();
+    for (auto& tick : ticks) tick_period.append(tick);
+  });
+
+  const double columns_append = timeBestOf(3, [&]() {
+    tick_columns.clear();
+    for (auto& tick : ticks) tick_columns.push_back(tick);
+  });
+
+  REQUIRE(tick_period.size() == ticks.size());
+  REQUIRE(tick_columns.size() == ticks.size());
+
+  COUT << CGREEN << "append : TickPeriod " << (ticks.size() / deque_append / 1e6) << " M ticks/s, TickColumns "
+       << (ticks.size() / columns_append / 1e6) << " M ticks/s\n";
+
+  for (auto interval : {1_min, 1_hour}) {
+    CandlePeriod from_ticks(interval);
+    CandlePeriod from_columns(interval);
+
+    const double deque_convert = timeBestOf(3, [&]() { from_ticks.convertFrom(tick_period); });
+    const double columns_convert = timeBestOf(3, [&]() { from_columns.convertFrom(tick_columns); });
+
+    REQUIRE(from_columns.size() == from_ticks.size());
+    CHECK(from_columns.back().getClose() == from_ticks.back().getClose());
+
+    COUT << CGREEN << "convert to " << interval << " candles : TickPeriod "
+         << (ticks.size() / deque_convert / 1e6) << " M ticks/s, TickColumns "
+         << (ticks.size() / columns_convert / 1e6) << " M ticks/s\n";
+  }
+
+  // all intervals of a trade history, one at a time and in one go
+  vector<CandlePeriod> candle_periods = {CandlePeriod(1_min), CandlePeriod(5_min), CandlePeriod(15_min),
+                                         CandlePeriod(1_hour), CandlePeriod(1_day)};
+  vector<CandlePeriod*> p_candle_periods;
+  for (auto& candle_period : candle_periods) p_candle_periods.push_back(&candle_period);
+
+  const double single_convert = timeBestOf(3, [&]() {
+    for (auto p_candle_period : p_candle_periods) p_candle_period->convertFrom(tick_period);
+  });
+  const size_t num_single_candles = candle_periods.front().size();
+
+  const double bulk_convert = timeBestOf(3, [&]() { CandlePeriod::sConvertFrom(tick_period, p_candle_periods); });
+
+  REQUIRE(candle_periods.front().size() == num_single_candles);
+
+  COUT << CGREEN << "convert to " << candle_periods.size() << " intervals : one at a time "
+       << (ticks.size() / single_convert / 1e6) << " M ticks/s, in one go " << (ticks.size() / bulk_convert / 1e6)
+       << " M ticks/s\n";
+
+  TraderBot::deleteInstance();
+}
+
+TEST_CASE("benchmark_append_trades", "[benchmark]") {
+  COUT << CBLUE << "TEST: benchmark_append_trades [benchmark]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  const Time start_time(2019, 12, 17, 0, 0, 0);
+  const CurrencyPair currency_pair(currency_t::BTC, currency_t::USD);
+
+  // a gap backfill of a few hours
+  TickPeriod ticks;
+  for (int64_t idx = 0; idx < 100000; ++idx) {
+    Tick tick = makeBenchmarkTick(start_time, idx);
+    ticks.append(tick);
+  }
+
+  TradeHistory one_by_one(exchange_t::COINBASE, currency_pair, true, {1_min, 5_min, 1_hour});
+  TradeHistory batched(exchange_t::COINBASE, currency_pair, true, {1_min, 5_min, 1_hour});
+
+  const double single_append = timeBestOf(1, [&]() {
+    for (auto& tick : ticks) one_by_one.appendTrade(tick);
+  });
+
+  const double batch_append = timeBestOf(1, [&]() { REQUIRE(batched.appendTrades(ticks)); });
+
+  REQUIRE(batched.getTickPeriod()->size() == ticks.size());
+  REQUIRE(batched.getNumCandles(1_min) == one_by_one.getNumCandles(1_min));
+  CHECK(batched.getCandleFromEnd(1_min).getMean() == one_by_one.getCandleFromEnd(1_min).getMean());
+
+  COUT << CGREEN << "append " << ticks.size() << " ticks : one by one " << (single_append * 1e3) << " ms, batched "
+       << (batch_append * 1e3) << " ms\n";
+
+  TraderBot::deleteInstance();
+}
+
+TEST_CASE("benchmark_snapshot_reads", "[benchmark]") {
+  COUT << CBLUE << "TEST: benchmark_snapshot_reads [benchmark]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  const Time start_time(2019, 12, 17, 0, 0, 0);
+  const CurrencyPair currency_pair(currency_t::BTC, currency_t::USD);
+  const int num_ticks = 400000;
+
+  vector<Tick> ticks;
+  for (int64_t idx = 0; idx < num_ticks; ++idx) ticks.push_back(makeBenchmarkTick(start_time, idx));
+
+  // one writer appending a burst of market data, a_num_readers algos polling the candles like a CandleTrigger
+  auto run = [&](const int a_num_readers, int64_t& a_num_reads) {
+    TradeHistory history(exchange_t::COINBASE, currency_pair, true, {1_min, 5_min, 1_hour});
+
+    atomic<bool> done(false);
+    atomic<int64_t> num_reads(0);
+    vector<thread> readers;
+
+    for (int reader = 0; reader < a_num_readers; ++reader) {
+      readers.push_back(thread([&]() {
+        int64_t reads = 0;
+        map<Duration, int> num_candles;
+
+        while (!done) {
+          history.populateNumCandles(num_candles);
+          if (num_candles[1_min] > 1) history.getLastCandle(1_min, history.getCandleFromEnd(1_min).getTimeStamp(), 1);
+          reads++;
+        }
+        num_reads += reads;
+      }));
+    }
+
+    const double elapsed = timeBestOf(1, [&]() {
+      for (auto& tick : ticks) history.appendTrade(tick);
+    });
+
+    done = true;
+    for (auto& reader : readers) reader.join();
+
+    REQUIRE(history.getNumCandles(1_min) == ((num_ticks - 1) / 240 + 1));  // 4 ticks per second
+
+    a_num_reads = num_reads;
+    return elapsed;
+  };
+
+  int64_t num_reads = 0;
+  const double alone = run(0, num_reads);
+
+  COUT << CGREEN << "append without readers : " << (num_ticks / alone / 1e6) << " M ticks/s\n";
+
+  for (int num_readers : {1, 4}) {
+    const double contended = run(num_readers, num_reads);
+
+    COUT << CGREEN << "append with " << num_readers << " readers : " << (num_ticks / contended / 1e6)
+         << " M ticks/s, " << (num_reads / contended / 1e6) << " M reads/s\n";
+  }
+
+  TraderBot::deleteInstance();
+}
+
+TEST_CASE("benchmark_indicator_warmup", "[benchmark]") {
+  COUT << CBLUE << "TEST: benchmark_indicator_warmup [benchmark]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  typedef DiscreteIndicator<MA, MA, SMA, EMA, RSI, MACD, TEMA, STDDEV> indicators_t;
+  const CurrencyPair currency_pair(currency_t::BTC, currency_t::USD);
+
+  // a month of 1 minute candles
+  const Time start_time(2019, 12, 17, 0, 0, 0);
+
+  TickPeriod tick_period;
+  for (int64_t idx = 0; idx < 30 * 24 * 60 * 4; ++idx) {
+    Tick tick = makeBenchmarkTick(start_time, idx * 60);
+    tick_period.append(tick);
+  }
+
+  CandlePeriod candle_period(1_min);
+  candle_period.convertFrom(tick_period);
+
+  auto warm_up = [&](const bool a_batch) {
+    return timeBestOf(3, [&]() {
+      indicators_t indicators(exchange_t::COINBASE, currency_pair, 1_min, MA(5, true, candle_price_t::MEAN),
+                              MA(50, false), SMA(10), EMA(12), RSI(14), MACD(12, 26, 9), TEMA(5), STDDEV(20));
+
+      if (a_batch)
+        indicators.constructFrom(candle_period);
+      else
+        for (auto& candle : candle_period) indicators.append(candle);
+    });
+  };
+
+  const double one_by_one = warm_up(false);
+  const double batched = warm_up(true);
+
+  COUT << CGREEN << "warm up over " << candle_period.size() << " candles : one by one " << (one_by_one * 1e3)
+       << " ms, batched " << (batched * 1e3) << " ms\n";
+
+  TraderBot::deleteInstance();
+}
+
+TEST_CASE("benchmark_rolling_window", "[benchmark]") {
+  COUT << CBLUE << "TEST: benchmark_rolling_window [benchmark]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  // a month of 1 minute candles and a window of 4 hours
+  const Time start_time(2019, 12, 17, 0, 0, 0);
+  const size_t period = 240;
+
+  TickPeriod tick_period;
+  for (int64_t idx = 0; idx < 30 * 24 * 60 * 4; ++idx) {
+    Tick tick = makeBenchmarkTick(start_time, idx * 60);
+    tick_period.append(tick);
+  }
+
+  CandlePeriod candle_period(1_min);
+  candle_period.convertFrom(tick_period);
+
+  const size_t num_candles = candle_period.size();
+  vector<double> rescanned(num_candles), streamed(num_candles);
+
+  // channel and median of every window, rescanning the candles of the window like an algo does
+  const double rescan = timeBestOf(3, [&]() {
+    vector<double> window;
+
+    for (size_t i = 0; i < num_candles; ++i) {
+      const size_t first = (i + 1 >= period) ? (i + 1 - period) : 0;
+      double low = DBL_MAX, high = -DBL_MAX;
+      window.clear();
+
+      for (size_t k = first; k <= i; ++k) {
+        const Candlestick& candle = candle_period[k];
+
+        low = min(low, candle.getLow());
+        high = max(high, candle.getHigh());
+        window.push_back(candle.getClose());
+      }
+
+      const size_t mid = window.size() / 2;
+      nth_element(window.begin(), window.begin() + mid, window.end());
+
+      double median = window[mid];
+      if ((window.size() % 2) == 0) median = (median + *max_element(window.begin(), window.begin() + mid)) / 2;
+
+      rescanned[i] = high - low + median;
+    }
+  });
+
+  const double stream = timeBestOf(3, [&]() {
+    RollingMin low(period);
+    RollingMax high(period);
+    RollingQuantile close(period);
+
+    for (size_t i = 0; i < num_candles; ++i) {
+      const Candlestick& candle = candle_period[i];
+
+      low.push(candle.getLow());
+      high.push(candle.getHigh());
+      close.push(candle.getClose());
+
+      streamed[i] = high.value() - low.value() + close.median();
+    }
+  });
+
+  double max_diff = 0;
+  for (size_t i = 0; i < num_candles; ++i) max_diff = max(max_diff, abs(streamed[i] - rescanned[i]));
+
+  CHECK(max_diff < 1e-9);
+
+  COUT << CGREEN << "channel and median of " << period << " candles over " << num_candles << " candles : rescanning "
+       << (rescan * 1e3) << " ms, rolling " << (stream * 1e3) << " ms\n";
+
+  TraderBot::deleteInstance();
+}
+
+TEST_CASE("benchmark_continuous_indicators", "[benchmark]") {
+  COUT << CBLUE << "TEST: benchmark_continuous_indicators [benchmark]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  const Time start_time(2019, 12, 17, 0, 0, 0);
+  const CurrencyPair currency_pair(currency_t::BTC, currency_t::USD);
+  const int num_ticks = 400000;
+
+  vector<Tick> ticks;
+  for (int64_t idx = 0; idx < num_ticks; ++idx) ticks.push_back(makeBenchmarkTick(start_time, idx));
+
+  // a history updating the tick indicators of an algo reacting to every tick
+  auto append = [&](const bool a_with_indicators) {
+    ContinuousIndicator<TickEWMA, TickVWAP, OrderFlowImbalance, RealizedVolatility> indicators(
+        exchange_t::COINBASE, currency_pair, TickEWMA(Duration(0, 0, 0, 10)), TickVWAP(1000),
+        OrderFlowImbalance(1000), RealizedVolatility(1000));
+
+    TradeHistory history(exchange_t::COINBASE, currency_pair, true, {1_min, 5_min, 1_hour});
+    if (a_with_indicators) history.addContinuousIndicator(&indicators);
+
+    return timeBestOf(1, [&]() {
+      for (auto& tick : ticks) history.appendTrade(tick);
+    });
+  };
+
+  const double without_indicators = append(false);
+  const double with_indicators = append(true);
+
+  COUT << CGREEN << "append " << num_ticks << " ticks : " << (without_indicators * 1e9 / num_ticks)
+       << " ns/tick, with tick indicators " << (with_indicators * 1e9 / num_ticks) << " ns/tick\n";
+
+  TraderBot::deleteInstance();
+}
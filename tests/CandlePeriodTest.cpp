@@ -0,0 +1,175 @@
+//
+//*****************************************************************
+//
+// WARRANTY:
+// Use all material in this file at your own risk.
+//
+// Created by subhagato on 10/18/26.
+//
+// in memory candle period test code.
+
+#include <catch2/catch.hpp>
+#include <cmath>
+
+#include "CandlePeriod.h"
+#include "Tick.h"
+#include "TickPeriod.h"
+#include "TraderBot.h"
+#include "indicators/DiscreteIndicator.h"
+
+using namespace std;
+
+TEST_CASE("candle_moments", "[basic][precommit]") {
+  COUT << CBLUE << "TEST: candle_moments [basic]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  const Time start_time(2019, 12, 17, 22, 0, 0);
+
+  // one tick per second for three days, so the ticks are split in day chunks, with an hour of empty candles
+  TickPeriod tick_period;
+  for (int64_t idx = 0; idx < 3 * 24 * 3600; ++idx) {
+    if ((idx >= 7200) && (idx < 10800)) continue;
+
+    Tick tick(start_time + Duration(0, 0, 0, idx), 1000000000 + idx, 7000 + ((idx * 7919) % 1000) * 0.01,
+              ((idx % 3) ? 0.1 : -0.2) * (1 + (idx % 7)));
+    tick_period.append(tick);
+  }
+
+  // moments merged from parts are the same as the ones accumulated tick by tick
+  candle_moments_t all_moments(start_time), first_moments(start_time), second_moments(start_time);
+  for (size_t idx = 0; idx < 1000; ++idx) {
+    const Tick& tick = tick_period[idx];
+    all_moments.add(tick.getPrice(), tick.getSize());
+    ((idx < 400) ? first_moments : second_moments).add(tick.getPrice(), tick.getSize());
+  }
+
+  first_moments.merge(second_moments);
+  CHECK(first_moments.num_ticks == all_moments.num_ticks);
+  CHECK(first_moments.close == all_moments.close);
+  CHECK(abs(first_moments.mean - all_moments.mean) < 1e-9);
+  CHECK(abs(first_moments.toCandlestick().getStdDev() - all_moments.toCandlestick().getStdDev()) < 1e-9);
+
+  // candles of all intervals at once, 5 minutes derived from 1 minute and 1 hour from 5 minutes, 90 seconds is built
+  // from the ticks as well, same as one interval at a time
+  CandlePeriod one_min(1_min), five_min(5_min), one_hour(1_hour), ninety_sec(Duration(0, 0, 1, 30));
+  REQUIRE(CandlePeriod::sConvertFrom(tick_period, {&one_hour, &five_min, &ninety_sec, &one_min}));
+
+  for (auto p_candle_period : {&one_min, &five_min, &ninety_sec, &one_hour}) {
+    CandlePeriod expected_period(p_candle_period->getInterval());
+    expected_period.convertFrom(tick_period);
+
+    REQUIRE(p_candle_period->size() == expected_period.size());
+    CHECK(p_candle_period->getLastPrice() == expected_period.getLastPrice());
+
+    for (size_t idx = 0; idx < expected_period.size(); ++idx) {
+      const Candlestick& cs = (*p_candle_period)[idx];
+      const Candlestick& expected_cs = expected_period[idx];
+
+      CHECK(cs.getTimeStamp() == expected_cs.getTimeStamp());
+      CHECK(cs.getOpen() == expected_cs.getOpen());
+      CHECK(cs.getClose() == expected_cs.getClose());
+      CHECK(cs.getLow() == expected_cs.getLow());
+      CHECK(cs.getHigh() == expected_cs.getHigh());
+      CHECK(abs(cs.getTotalVolume() - expected_cs.getTotalVolume()) < 1e-9);
+      CHECK(abs(cs.getMean() - expected_cs.getMean()) < 1e-9);
+      CHECK(abs(cs.getStdDev() - expected_cs.getStdDev()) < 1e-9);
+    }
+  }
+
+  // bigger candles from 5 minute candles merge their stddev exactly as well
+  CandlePeriod merged_hour(1_hour);
+  merged_hour.convertFrom(five_min);
+
+  REQUIRE(merged_hour.size() == one_hour.size());
+  for (size_t idx = 0; idx < one_hour.size(); ++idx) {
+    if (one_hour[idx].getTotalVolume() == 0) continue;
+
+    CHECK(merged_hour[idx].getOpen() == one_hour[idx].getOpen());
+    CHECK(merged_hour[idx].getClose() == one_hour[idx].getClose());
+    CHECK(abs(merged_hour[idx].getMean() - one_hour[idx].getMean()) < 1e-9);
+    CHECK(abs(merged_hour[idx].getStdDev() - one_hour[idx].getStdDev()) < 1e-9);
+  }
+
+  TraderBot::deleteInstance();
+}
+
+TEST_CASE("candle_period_sparse", "[basic][precommit]") {
+  COUT << CBLUE << "TEST: candle_period_sparse [basic]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  const Time start_time(2019, 12, 17, 0, 0, 0);
+
+  // bursts of ticks with long idle gaps in between
+  TickPeriod tick_period;
+  for (int64_t burst = 0; burst < 30; ++burst) {
+    for (int64_t idx = 0; idx < 20; ++idx) {
+      Tick tick(start_time + Duration(0, 0, 7 * burst, idx), 1000000000 + burst * 20 + idx,
+                7000 + ((burst * 20 + idx) * 7919 % 1000) * 0.01, ((idx % 3) ? 0.1 : -0.2));
+      tick_period.append(tick);
+    }
+  }
+
+  CandlePeriod dense(5_sec), sparse(5_sec), dense_live(5_sec), sparse_live(5_sec);
+  REQUIRE(sparse.setSparse(true));
+  REQUIRE(sparse_live.setSparse(true));
+
+  dense.convertFrom(tick_period);
+  sparse.convertFrom(tick_period);
+
+  for (auto& tick : tick_period) {
+    dense_live.appendTick(tick);
+    sparse_live.appendTick(tick);
+  }
+
+  CHECK(sparse.size() < (dense.size() / 10));
+  CHECK(!sparse_live.setSparse(false));  // mode of a period with candles doesn't change
+
+  for (auto p_sparse : {&sparse, &sparse_live}) {
+    const CandlePeriod& expected_period = (p_sparse == &sparse) ? dense : dense_live;
+
+    REQUIRE(p_sparse->getNumCandles() == expected_period.size());
+
+    for (size_t idx = 0; idx < expected_period.size(); ++idx) {
+      const Candlestick cs = p_sparse->getCandle(idx);
+
+      CHECK(cs.getTimeStamp() == expected_period[idx].getTimeStamp());
+      CHECK(cs.getOpen() == expected_period[idx].getOpen());
+      CHECK(cs.getClose() == expected_period[idx].getClose());
+      CHECK(cs.getMean() == expected_period[idx].getMean());
+      CHECK(cs.getTotalVolume() == expected_period[idx].getTotalVolume());
+    }
+
+    CHECK(p_sparse->getCandleFromEnd(1).getTimeStamp() == expected_period[expected_period.size() - 2].getTimeStamp());
+
+    // a flat run ends at the next candle with ticks
+    Candlestick flat_cs;
+    CHECK(p_sparse->getCandleRun(start_time + 20_sec, start_time + 1_hour, flat_cs) == (7 * 12 - 4));
+    CHECK(flat_cs.getClose() == expected_period[3].getClose());
+  }
+
+  // indicators advance over flat runs to the same values
+  DiscreteIndicator<MA, SMA, EMA> dense_indicator(exchange_t::COINBASE, CurrencyPair(currency_t::BTC, currency_t::USD),
+                                                  5_sec, MA(5, true, candle_price_t::MEAN),
+                                                  SMA(10, candle_price_t::CLOSE), EMA(10, candle_price_t::CLOSE));
+  DiscreteIndicator<MA, SMA, EMA> sparse_indicator(exchange_t::COINBASE, CurrencyPair(currency_t::BTC, currency_t::USD),
+                                                   5_sec, MA(5, true, candle_price_t::MEAN),
+                                                   SMA(10, candle_price_t::CLOSE), EMA(10, candle_price_t::CLOSE));
+
+  dense_indicator.constructFrom(dense);
+  sparse_indicator.constructFrom(sparse);
+
+  REQUIRE(sparse_indicator.getNumCandles() == dense_indicator.getNumCandles());
+  CHECK(sparse_indicator.getLastTimeStamp() == dense_indicator.getLastTimeStamp());
+
+  for (size_t idx = 0; idx < dense_indicator.getNumCandles(); ++idx) {
+    CHECK(abs(sparse_indicator.getIndicatorAtIdx<0>(idx).ma - dense_indicator.getIndicatorAtIdx<0>(idx).ma) < 1e-6);
+    CHECK(abs(sparse_indicator.getIndicatorAtIdx<1>(idx).sma - dense_indicator.getIndicatorAtIdx<1>(idx).sma) < 1e-6);
+    CHECK(sparse_indicator.getIndicatorAtIdx<2>(idx).ema == dense_indicator.getIndicatorAtIdx<2>(idx).ema);
+  }
+
+  TraderBot::deleteInstance();
+}
@@ -10,12 +10,15 @@
 
 #include <catch2/catch.hpp>
 #include <regex>
+#include <unistd.h>
 
 #include "CoinAPI.h"
 #include "CoinAPITick.h"
 #include "CoinMarketCap.h"
 #include "Database.h"
+#include "PartitionCache.h"
 #include "Tick.h"
+#include "TickPeriod.h"
 #include "TraderBot.h"
 #include "exchanges/GDAX.h"
 
@@ -133,6 +136,36 @@ TEST_CASE("database_iterator_cmc", "[basic]") {
   TraderBot::deleteInstance();
 }
 
+TEST_CASE("database_load", "[basic][precommit]") {
+  COUT << CBLUE << "TEST: database_load [basic]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  Database<Tick>* db = trader_bot->getGDAX()->getTradeHistory(CurrencyPair("BTC-USD"))->getDb();
+
+  const Time start_time(2017, 12, 1, 12, 0, 0);
+  const Time end_time(2017, 12, 4, 12, 0, 0);
+
+  deque<Tick> ticks;
+  int num_loaded = db->loadData(ticks, start_time, end_time);
+
+  CHECK(num_loaded == static_cast<int>(ticks.size()));
+
+  // pages of all days must come in time order
+  CHECK(is_sorted(ticks.begin(), ticks.end()));
+
+  // same rows as loading one day at a time
+  deque<Tick> day_ticks;
+  for (Time day_start = start_time; day_start < end_time; day_start = day_start + Duration(1, 0, 0, 0)) {
+    db->loadData(day_ticks, day_start, min(day_start + Duration(1, 0, 0, 0), end_time));
+  }
+
+  CHECK(day_ticks == ticks);
+
+  TraderBot::deleteInstance();
+}
+
 TEST_CASE("database_metadata", "[basic][precommit]") {
   COUT << CBLUE << "TEST: database_metadata [basic]\n";
 
@@ -188,6 +221,255 @@ TEST_CASE("database_repair", "[long]") {
   TraderBot::deleteInstance();
 }
 
+TEST_CASE("database_fix_scan", "[long]") {
+  COUT << CBLUE << "TEST: database_fix_scan [long]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  g_update_cass = true;
+
+  // unique to the process, so concurrent runs don't share the table
+  const string table_name = "test_fix_scan_" + to_string(getpid());
+
+  {
+    Database<Tick> db("crypto", table_name, true);
+    db.createTable();
+
+    // 3 days of trades every 30 minutes, without trade 20 (inside the first day) and 49 (first of the second day)
+    deque<Tick> ticks;
+    for (int64_t trade_id = 1; trade_id <= 144; ++trade_id) {
+      if (trade_id == 20 || trade_id == 49) continue;
+      ticks.push_back(Tick(Time(2019, 12, 16, 0, 15, 0) + Duration(0, 0, 30, 0) * (trade_id - 1), trade_id, 100, 1));
+    }
+
+    db.storeDataInBatch(ticks);
+    CHECK(db.getNumEntries() == (int64_t)ticks.size());
+
+    // overwriting the same rows doesn't count them again
+    CHECK(db.storeDataInBatch(ticks) == ticks.size());
+    CHECK(db.getNumEntries() == (int64_t)ticks.size());
+
+    primary_key_t min_key, max_key, last_key;
+    int64_t num_entries;
+    vector<pair<primary_key_t, primary_key_t>> discontinuities;
+
+    const Time start = Time::sNow();
+    CHECK(db.fixDatabase(true, true, min_key, max_key, last_key, num_entries, discontinuities));
+    COUT << "full scan took " << (Time::sNow() - start) << "\n";
+
+    REQUIRE(discontinuities.size() == 2);
+    CHECK(discontinuities[0].first.unique_id == 19);
+    CHECK(discontinuities[0].second.unique_id == 21);
+    CHECK(discontinuities[1].first.unique_id == 48);
+    CHECK(discontinuities[1].second.unique_id == 50);
+
+    CHECK(min_key == ticks.front().getPrimaryKey());
+    CHECK(max_key == ticks.back().getPrimaryKey());
+    CHECK(last_key == ticks.back().getPrimaryKey());
+    CHECK(db.getNumEntries() == (int64_t)ticks.size());
+  }
+
+  Database<Tick>::sDropTable("crypto", table_name);
+
+  TraderBot::deleteInstance();
+}
+
+TEST_CASE("database_migrate", "[long]") {
+  COUT << CBLUE << "TEST: database_migrate [long]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  g_update_cass = true;
+
+  const string table_name = "test_migrate_" + to_string(getpid());
+
+  {
+    // 2 days of trades every 10 minutes
+    deque<Tick> ticks;
+    for (int64_t trade_id = 1; trade_id <= 288; ++trade_id)
+      ticks.push_back(Tick(Time(2019, 12, 16, 0, 5, 0) + Duration(0, 0, 10, 0) * (trade_id - 1), trade_id, 100, 1));
+
+    {
+      Database<Tick> db("crypto", table_name, true);
+      db.createTable();
+      db.storeDataInBatch(ticks);
+
+      // rows are counted by the migration, not taken from the metadata
+      db.getMetadata()->setNumEntries(1);
+    }
+
+    REQUIRE(Database<Tick>::sMigrateTable("crypto", table_name, bucket_width_t::HOUR, true));
+
+    Database<Tick> db("crypto", table_name, true);
+    CHECK(db.getBucketWidth() == bucket_width_t::HOUR);
+    CHECK(db.getNumEntries() == (int64_t)ticks.size());
+
+    // ranges starting and ending inside a partition
+    deque<Tick> loaded;
+    db.loadData(loaded, Time(2019, 12, 16, 10, 30, 0), Time(2019, 12, 17, 3, 20, 0));
+
+    REQUIRE(loaded.size() == (size_t)101);
+    CHECK(loaded.front().getUniqueID() == 64);
+    CHECK(loaded.back().getUniqueID() == 164);
+
+    db.setScope(Time(2019, 12, 16, 0, 0, 0), Time(2019, 12, 18, 0, 0, 0));
+
+    size_t num_iterated = 0;
+    for (auto tick : db) {
+      CHECK(tick.getUniqueID() == ticks[num_iterated].getUniqueID());
+      num_iterated++;
+    }
+    CHECK(num_iterated == ticks.size());
+  }
+
+  Database<Tick>::sDropTable("crypto", table_name);
+
+  TraderBot::deleteInstance();
+}
+
+TEST_CASE("database_shared_table", "[long]") {
+  COUT << CBLUE << "TEST: database_shared_table [long]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  g_update_cass = true;
+
+  const vector<string> symbols = {"btc_usd_test", "eth_usd_test", "ltc_usd_test"};
+  const string table_name = "test_shared_" + to_string(getpid());
+
+  {
+    vector<unique_ptr<Database<Tick>>> dbs;
+    vector<deque<Tick>> ticks(symbols.size());
+
+    // 2 days of trades every 10 minutes, symbols differ in price and trade ids
+    for (size_t idx = 0; idx < symbols.size(); idx++) {
+      dbs.emplace_back(new Database<Tick>("crypto", table_name, true, true, bucket_width_t::DAY, symbols[idx]));
+      dbs[idx]->createTable();
+
+      for (int64_t num_trades = 0; num_trades < 288; ++num_trades)
+        ticks[idx].push_back(Tick(Time(2019, 12, 16, 0, 5, 0) + Duration(0, 0, 10, 0) * num_trades,
+                                  1 + 1000 * idx + num_trades, 100 * (idx + 1), 1));
+
+      dbs[idx]->storeDataInBatch(ticks[idx]);
+
+      // each symbol has its own metadata row
+      CHECK(dbs[idx]->getNumEntries() == (int64_t)ticks[idx].size());
+      CHECK(dbs[idx]->getMetadata()->getTableName() == table_name + ":" + symbols[idx]);
+    }
+
+    CHECK(g_created_tables.count("crypto." + table_name));
+
+    vector<Database<Tick>*> db_ptrs;
+    for (auto& db : dbs) db_ptrs.push_back(db.get());
+
+    vector<deque<Tick>> loaded(symbols.size());
+    vector<deque<Tick>*> loaded_ptrs;
+    for (auto& data : loaded) loaded_ptrs.push_back(&data);
+
+    const int num_loaded =
+        Database<Tick>::sLoadData(db_ptrs, loaded_ptrs, Time(2019, 12, 16, 12, 0, 0), Time(2019, 12, 17, 12, 0, 0));
+
+    CHECK(num_loaded == 3 * 144);
+
+    for (size_t idx = 0; idx < symbols.size(); idx++) {
+      REQUIRE(loaded[idx].size() == (size_t)144);
+      CHECK(loaded[idx].front().getUniqueID() == (int64_t)(73 + 1000 * idx));
+      CHECK(is_sorted(loaded[idx].begin(), loaded[idx].end()));
+      CHECK(loaded[idx].front().getPrice() == 100 * (idx + 1));
+
+      // same rows through the single symbol path
+      deque<Tick> single;
+      dbs[idx]->loadData(single, Time(2019, 12, 16, 12, 0, 0), Time(2019, 12, 17, 12, 0, 0));
+      CHECK(single.size() == loaded[idx].size());
+
+      Tick newest;
+      REQUIRE(dbs[idx]->getNewestRow(newest));
+      CHECK(newest.getUniqueID() == ticks[idx].back().getUniqueID());
+    }
+
+    dbs.clear();
+  }
+
+  Database<Tick>::sDropTable("crypto", table_name);
+
+  for (auto& symbol : symbols) {
+    const string query = "DELETE FROM crypto.metadata WHERE table_name = '" + table_name + ":" + symbol + "'";
+    CassServer::executeQuery(g_cass_session, query.c_str());
+  }
+
+  // the next run creates the shared table again
+  CHECK(!g_created_tables.count("crypto." + table_name));
+
+  TraderBot::deleteInstance();
+}
+
+TEST_CASE("database_partition_cache", "[long]") {
+  COUT << CBLUE << "TEST: database_partition_cache [long]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  g_update_cass = true;
+
+  const string cache_dir = g_trader_home + "/test_db_partition_cache";
+  g_partition_cache = new PartitionCache(cache_dir);
+
+  const string table_name = "test_partition_cache_" + to_string(getpid());
+
+  {
+    Database<Tick> db("crypto", table_name, true);
+    db.createTable();
+
+    // 3 days of trades every 10 minutes, consistent till the start of the last day
+    deque<Tick> ticks;
+    for (int64_t trade_id = 1; trade_id <= 432; ++trade_id)
+      ticks.push_back(Tick(Time(2019, 12, 16, 0, 5, 0) + Duration(0, 0, 10, 0) * (trade_id - 1), trade_id, 100, 1));
+
+    db.storeDataInBatch(ticks);
+    db.getMetadata()->setConsistentEntryKey(ticks[288].getPrimaryKey());
+
+    const Time start_time(2019, 12, 16, 12, 0, 0);
+    const Time end_time(2019, 12, 18, 12, 0, 0);
+
+    deque<Tick> loaded;
+    db.loadData(loaded, start_time, end_time);
+    CHECK(g_partition_cache->getNumEntries() == 2);  // the last day isn't consistent yet
+
+    // second load is served from the cache for the first two days
+    deque<Tick> cached;
+    db.loadData(cached, start_time, end_time);
+
+    REQUIRE(cached.size() == loaded.size());
+    CHECK(cached.size() == (size_t)288);
+    for (size_t idx = 0; idx < cached.size(); ++idx) CHECK(cached[idx] == loaded[idx]);
+
+    // advancing the consistent entry key keeps the cached partitions
+    const int64_t generation = db.getMetadata()->getGeneration();
+    db.getMetadata()->setConsistentEntryKey(ticks[300].getPrimaryKey());
+    cached.clear();
+    db.loadData(cached, start_time, end_time);
+    CHECK(g_partition_cache->getNumEntries() == 2);
+
+    // a write into a cached partition invalidates it, and the table gets a new generation
+    deque<Tick> late_tick = {Tick(Time(2019, 12, 16, 12, 0, 1), 100000, 100, 1)};
+    db.storeData(late_tick);
+    CHECK(g_partition_cache->getNumEntries() == 1);
+    CHECK(db.getMetadata()->getGeneration() == generation + 1);
+  }
+
+  Database<Tick>::sDropTable("crypto", table_name);
+
+  DELETE(g_partition_cache);
+
+  const string command = "rm -rf " + cache_dir;
+  CHECK(!system(command.c_str()));
+
+  TraderBot::deleteInstance();
+}
+
 TEST_CASE("database_restore", "[long]") {
   COUT << CBLUE << "TEST: database_restore [long]\n";
 
@@ -210,6 +492,201 @@ TEST_CASE("database_restore", "[long]") {
   TraderBot::deleteInstance();
 }
 
+TEST_CASE("database_prepared_insert_rate", "[long]") {
+  COUT << CBLUE << "TEST: database_prepared_insert_rate [long]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  g_update_cass = true;
+
+  const int num_rows = 50000;
+  double rows_per_sec[2];
+
+  const string table_name = "test_prepared_insert_" + to_string(getpid());
+
+  {
+    Database<Tick> db("crypto", table_name);
+    db.createTable();
+
+    for (int prepared = 0; prepared < 2; ++prepared) {
+      deque<Tick> ticks;
+      for (int idx = 0; idx < num_rows; ++idx) {
+        const int64_t trade_id = prepared * num_rows + idx + 1;
+        ticks.push_back(Tick(Time(2019, 12, 16, 0, 0, 0) + Duration(trade_id * 1000), trade_id, 100, 1));
+      }
+
+      db.setUsePreparedStatements(prepared);
+
+      const Time start = Time::sNow();
+      db.storeData(ticks, Time(), Time(), false);
+      rows_per_sec[prepared] = num_rows / ((Time::sNow() - start).getDuration() / 1e6);
+    }
+  }
+
+  Database<Tick>::sDropTable("crypto", table_name);
+
+  COUT << "insert rate: " << rows_per_sec[0] << " rows/sec (simple), " << rows_per_sec[1] << " rows/sec (prepared)\n";
+
+  TraderBot::deleteInstance();
+}
+
+TEST_CASE("database_write_window", "[long]") {
+  COUT << CBLUE << "TEST: database_write_window [long]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  g_update_cass = true;
+
+  const int num_rows = 50000;
+  const size_t windows[] = {1, CASS_MAX_WRITES_IN_FLIGHT};
+
+  const string table_name = "test_write_window_" + to_string(getpid());
+
+  {
+    Database<Tick> db("crypto", table_name);
+    db.createTable();
+
+    for (int pass = 0; pass < 2; ++pass) {
+      deque<Tick> ticks;
+      for (int idx = 0; idx < num_rows; ++idx) {
+        const int64_t trade_id = pass * num_rows + idx + 1;
+        ticks.push_back(Tick(Time(2019, 12, 16, 0, 0, 0) + Duration(trade_id * 1000), trade_id, 100, 1));
+      }
+
+      db.setMaxWritesInFlight(windows[pass]);
+
+      const Time start = Time::sNow();
+      CHECK(db.storeData(ticks) == (size_t)num_rows);
+      COUT << "insert rate with " << windows[pass]
+           << " writes in flight: " << num_rows / ((Time::sNow() - start).getDuration() / 1e6) << " rows/sec\n";
+
+      // nothing new on the second store, every row must be reported as not applied
+      CHECK(db.storeData(ticks) == (size_t)0);
+    }
+  }
+
+  Database<Tick>::sDropTable("crypto", table_name);
+
+  TraderBot::deleteInstance();
+}
+
+TEST_CASE("database_batch_insert_rate", "[long]") {
+  COUT << CBLUE << "TEST: database_batch_insert_rate [long]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  g_update_cass = true;
+
+  const int num_rows = 200000;
+  double rows_per_sec[2];
+
+  const string table_name = "test_batch_insert_" + to_string(getpid());
+
+  {
+    Database<Tick> db("crypto", table_name);
+    db.createTable();
+
+    for (int batched = 0; batched < 2; ++batched) {
+      // rows of each pass span several days, trade ids of the passes don't overlap
+      const Time start_time = Time(2019, 12, 16, 0, 0, 0) + Duration(batched * 10, 0, 0, 0);
+      deque<Tick> ticks;
+      for (int idx = 0; idx < num_rows; ++idx) {
+        const int64_t trade_id = batched * num_rows + idx + 1;
+        ticks.push_back(Tick(start_time + Duration(idx * 2000000LL), trade_id, 100 + idx % 7, 1));
+      }
+
+      const Time start = Time::sNow();
+      if (batched)
+        CHECK(db.storeDataInBatch(ticks) == (size_t)num_rows);
+      else
+        db.storeData(ticks, Time(), Time(), false);
+      rows_per_sec[batched] = num_rows / ((Time::sNow() - start).getDuration() / 1e6);
+
+      deque<Tick> loaded;
+      db.loadData(loaded, ticks.front().getTimeStamp(), ticks.back().getTimeStamp() + Duration(1));
+      CHECK(loaded == ticks);
+    }
+  }
+
+  Database<Tick>::sDropTable("crypto", table_name);
+
+  COUT << "insert rate: " << rows_per_sec[0] << " rows/sec (single), " << rows_per_sec[1] << " rows/sec (batched)\n";
+
+  TraderBot::deleteInstance();
+}
+
+TEST_CASE("database_row_decode_rate", "[long]") {
+  COUT << CBLUE << "TEST: database_row_decode_rate [long]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  const int32_t date = Time(2017, 12, 1, 0, 0, 0).days_since_epoch();
+  const string query =
+      "SELECT date, time, trade_id, price, size FROM crypto.btc_usd_coinbase WHERE date = " + to_string(date);
+
+  CassStatement* cass_statement = cass_statement_new(query.c_str(), 0);
+  CassFuture* cass_future = cass_session_execute(g_cass_session, cass_statement);
+  REQUIRE(cass_future_error_code(cass_future) == CASS_OK);
+
+  const CassResult* cass_result = cass_future_get_result(cass_future);
+
+  const int num_passes = 20;
+  size_t num_rows = 0;
+  double rows_per_sec[2];
+  deque<Tick> ticks[2];
+
+  for (int codec = 0; codec < 2; ++codec) {
+    const Time start = Time::sNow();
+
+    for (int pass = 0; pass < num_passes; ++pass) {
+      ticks[codec].clear();
+      CassIterator* cass_iterator = cass_iterator_from_result(cass_result);
+
+      while (cass_iterator_next(cass_iterator)) {
+        const CassRow* cass_row = cass_iterator_get_row(cass_iterator);
+
+        if (codec == 0) {
+          // string type dispatch with lookup by column name
+          int32_t row_date;
+          int64_t row_time, trade_id;
+          double fields[2];
+
+          DbUtils::cass_value_get_type(cass_row, "date", "int", &row_date);
+          DbUtils::cass_value_get_type(cass_row, "time", "bigint", &row_time);
+          DbUtils::cass_value_get_type(cass_row, Tick::m_unique_id.first, Tick::m_unique_id.second, &trade_id);
+
+          for (size_t idx = 0; idx < Tick::m_fields.size(); ++idx)
+            DbUtils::cass_value_get_type(cass_row, Tick::m_fields[idx].first, Tick::m_fields[idx].second, &fields[idx]);
+
+          ticks[codec].push_back(Tick(Time(row_date, row_time), trade_id, fields[0], fields[1]));
+        } else {
+          ticks[codec].push_back(DbUtils::readRow<Tick>(cass_row));
+        }
+      }
+
+      cass_iterator_free(cass_iterator);
+    }
+
+    num_rows = ticks[codec].size() * num_passes;
+    rows_per_sec[codec] = num_rows / max((Time::sNow() - start).getDuration() / 1e6, 1e-6);
+  }
+
+  COUT << "decode rate (" << num_rows << " rows): " << rows_per_sec[0] << " rows/sec (by name), " << rows_per_sec[1]
+       << " rows/sec (row codec)\n";
+
+  CHECK(ticks[0] == ticks[1]);
+
+  cass_result_free(cass_result);
+  cass_future_free(cass_future);
+  cass_statement_free(cass_statement);
+
+  TraderBot::deleteInstance();
+}
+
 TEST_CASE("coinmarketcap", "[long]") {
   COUT << CBLUE << "TEST: coinmarketcap [long]\n";
 
@@ -0,0 +1,70 @@
+//
+//*****************************************************************
+//
+// WARRANTY:
+// Use all material in this file at your own risk.
+//
+// Created by subhagato on 10/18/26.
+//
+// existence index test code.
+
+#include <catch2/catch.hpp>
+
+#include "CoinAPITick.h"
+#include "ExistenceIndex.h"
+#include "TraderBot.h"
+
+using namespace std;
+
+TEST_CASE("existence_index", "[basic][precommit]") {
+  COUT << CBLUE << "TEST: existence_index [basic]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  ExistenceIndex index(2);
+
+  auto key = [](int32_t date, int64_t trade_id) { return primary_key_t(date, trade_id * 1000, trade_id); };
+
+  const primary_key_t min_key = key(100, 10);
+  const primary_key_t max_key = key(101, 20);
+
+  CHECK(index.claim(key(101, 21), 21, min_key, max_key, false) == ExistenceIndex::cNew);     // after max
+  CHECK(index.claim(key(101, 21), 21, min_key, max_key, false) == ExistenceIndex::cExists);  // claimed above
+  CHECK(index.claim(key(99, 9), 9, min_key, max_key, false) == ExistenceIndex::cNew);        // before min
+  CHECK(index.claim(key(100, 15), 15, min_key, max_key, false) == ExistenceIndex::cUnknown);
+  CHECK(index.claim(key(100, 15), 15, min_key, max_key, true) == ExistenceIndex::cNew);  // empty table
+
+  index.erase(key(101, 21), 21);
+  CHECK(index.claim(key(101, 21), 21, min_key, max_key, false) == ExistenceIndex::cNew);
+
+  // rows strictly inside a discontinuity are new
+  index.setGaps({make_pair(key(100, 11), key(100, 14))});
+  CHECK(index.claim(key(100, 12), 12, min_key, max_key, false) == ExistenceIndex::cNew);
+  CHECK(index.claim(key(100, 14), 14, min_key, max_key, false) == ExistenceIndex::cUnknown);
+
+  // a third day evicts the least recently used one, day 100 takes its gap along
+  CHECK(index.claim(key(99, 9), 9, min_key, max_key, false) == ExistenceIndex::cNew);
+  index.insert(key(103, 40), 40);
+  CHECK(index.claim(key(100, 13), 13, min_key, max_key, false) == ExistenceIndex::cUnknown);
+
+  // trades of the same millisecond have the same primary key, they differ by the unique id column only
+  const Time trade_time = Time(2019, 12, 16, 7, 30, 0);
+  const CoinAPITick first_trade(trade_time, 7000, 1, exchange_t::COINBASE, "a4a5c2ba-3ee6-4a8a-8c4a-1b0e8e3b0a11");
+  const CoinAPITick second_trade(trade_time, 7000, 2, exchange_t::COINBASE, "0f2d7e55-91b3-4c1e-b6a2-6cc1d2f7e6d0");
+
+  REQUIRE(first_trade.getPrimaryKey() == second_trade.getPrimaryKey());
+  REQUIRE(first_trade.getUniqueID() != second_trade.getUniqueID());
+
+  ExistenceIndex coinapi_index;
+  const primary_key_t coinapi_max_key(trade_time.days_since_epoch() - 1, 0, 0);
+
+  CHECK(coinapi_index.claim(first_trade.getPrimaryKey(), first_trade.getUniqueID(), min_key, coinapi_max_key,
+                            false) == ExistenceIndex::cNew);
+  CHECK(coinapi_index.claim(second_trade.getPrimaryKey(), second_trade.getUniqueID(), min_key, coinapi_max_key,
+                            false) == ExistenceIndex::cNew);
+  CHECK(coinapi_index.claim(second_trade.getPrimaryKey(), second_trade.getUniqueID(), min_key, coinapi_max_key,
+                            false) == ExistenceIndex::cExists);
+
+  TraderBot::deleteInstance();
+}
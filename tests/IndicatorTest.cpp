@@ -16,13 +16,19 @@
 #include "TraderBot.h"
 #include "exchanges/GDAX.h"
 
+#include "indicators/ContinuousIndicator.h"
 #include "indicators/EMA.h"
+#include "indicators/IndicatorRegistry.h"
 #include "indicators/MA.h"
 #include "indicators/MACD.h"
 #include "indicators/RSI.h"
 #include "indicators/SMA.h"
 #include "indicators/TEMA.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
 #include <indicators/DiscreteIndicator.h>
+#include <memory>
 #include <thread>
 
 using namespace std;
@@ -109,3 +115,360 @@ TEST_CASE("indicator_discrete", "[basic][precommit]") {
 
   TraderBot::deleteInstance();
 }
+
+// relative difference, values which are both NaN (e.g. during the warm up of an indicator) are the same
+static double relativeDiff(const double a_value, const double a_expected) {
+  if (std::isnan(a_value) && std::isnan(a_expected)) return 0;
+
+  return abs(a_value - a_expected) / max(1.0, abs(a_expected));
+}
+
+TEST_CASE("indicator_batch", "[basic][precommit]") {
+  COUT << CBLUE << "TEST: indicator_batch [basic]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  typedef DiscreteIndicator<MA, MA, MA, SMA, EMA, RSI, MACD, TEMA, STDDEV> indicators_t;
+
+  auto new_indicators = []() {
+    return new indicators_t(exchange_t::COINBASE, CurrencyPair(currency_t::BTC, currency_t::USD), 1_min,
+                            MA(5, true, candle_price_t::MEAN), MA(7, false, candle_price_t::CLOSE),
+                            MA(200, true, candle_price_t::MEAN), SMA(10, candle_price_t::CLOSE), EMA(12), RSI(14),
+                            MACD(12, 26, 9, candle_price_t::CLOSE), TEMA(5), STDDEV(20, candle_price_t::HIGH));
+  };
+
+  const Time start_time(2019, 12, 17, 0, 0, 0);
+
+  // a month of 1 minute candles, with runs of candles without volume shorter and longer than the windows
+  vector<Candlestick> candles;
+  for (int64_t idx = 0; idx < 30 * 24 * 60 + 100; ++idx) {
+    const double price = 7000 + ((idx * 7919) % 1000) * 0.01 + idx * 0.001;
+    const double volume = ((idx % 11 < 3) || ((idx / 1000) % 10 == 3)) ? 0 : (0.1 + (idx % 7) * 0.3);
+    candles.push_back(Candlestick(start_time + Duration(idx * 60000000), price, price + 1, price - 1, price + 2,
+                                  price + 0.5, 0.3, Volume(volume)));
+  }
+
+  CandlePeriod candle_period(1_min);
+  for (size_t idx = 0; idx + 100 < candles.size(); ++idx) candle_period.append(candles[idx]);
+
+  unique_ptr<indicators_t> p_batched(new_indicators());
+  unique_ptr<indicators_t> p_streamed(new_indicators());
+
+  p_batched->constructFrom(candle_period);
+  for (auto& candle : candle_period) p_streamed->append(candle);
+
+  // both continue from the same state
+  for (size_t idx = candle_period.size(); idx < candles.size(); ++idx) {
+    p_batched->append(candles[idx]);
+    p_streamed->append(candles[idx]);
+  }
+
+  REQUIRE(p_batched->getNumCandles() == candles.size());
+  REQUIRE(p_batched->getLastTimeStamp() == p_streamed->getLastTimeStamp());
+
+  vector<double> max_diffs(11, 0);
+
+  for (size_t idx = 0; idx < candles.size(); ++idx) {
+    const macd_t macd = p_batched->getIndicatorAtIdx<6>(idx);
+    const macd_t expected_macd = p_streamed->getIndicatorAtIdx<6>(idx);
+
+    const vector<double> diffs = {
+        relativeDiff(p_batched->getIndicatorAtIdx<0>(idx).ma, p_streamed->getIndicatorAtIdx<0>(idx).ma),
+        relativeDiff(p_batched->getIndicatorAtIdx<1>(idx).ma, p_streamed->getIndicatorAtIdx<1>(idx).ma),
+        relativeDiff(p_batched->getIndicatorAtIdx<2>(idx).ma, p_streamed->getIndicatorAtIdx<2>(idx).ma),
+        relativeDiff(p_batched->getIndicatorAtIdx<3>(idx).sma, p_streamed->getIndicatorAtIdx<3>(idx).sma),
+        relativeDiff(p_batched->getIndicatorAtIdx<4>(idx).ema, p_streamed->getIndicatorAtIdx<4>(idx).ema),
+        relativeDiff(p_batched->getIndicatorAtIdx<5>(idx).rsi, p_streamed->getIndicatorAtIdx<5>(idx).rsi),
+        relativeDiff(macd.macd, expected_macd.macd),
+        relativeDiff(macd.macd_signal, expected_macd.macd_signal),
+        relativeDiff(macd.macd_hist, expected_macd.macd_hist),
+        relativeDiff(p_batched->getIndicatorAtIdx<7>(idx).tema, p_streamed->getIndicatorAtIdx<7>(idx).tema),
+        relativeDiff(p_batched->getIndicatorAtIdx<8>(idx).stddev, p_streamed->getIndicatorAtIdx<8>(idx).stddev)};
+
+    for (size_t i = 0; i < diffs.size(); ++i) max_diffs[i] = max(max_diffs[i], diffs[i]);
+  }
+
+  for (auto max_diff : max_diffs) CHECK(max_diff < 1e-9);
+
+  CHECK(p_batched->getLastValue<0>().ma == p_batched->getIndicatorAtIdx<0>().ma);
+
+  TraderBot::deleteInstance();
+}
+
+TEST_CASE("indicator_lazy", "[basic][precommit]") {
+  COUT << CBLUE << "TEST: indicator_lazy [basic]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  typedef DiscreteIndicator<MA, EMA, RSI> indicators_t;
+  const CurrencyPair currency_pair(currency_t::BTC, currency_t::USD);
+
+  indicators_t eager(exchange_t::COINBASE, currency_pair, 1_min, MA(5, true, candle_price_t::MEAN), EMA(12), RSI(14));
+  indicators_t lazy(exchange_t::COINBASE, currency_pair, 1_min, MA(5, true, candle_price_t::MEAN), EMA(12), RSI(14));
+
+  lazy.setLazy(true);
+
+  const Time start_time(2019, 12, 17, 0, 0, 0);
+  CandlePeriod candle_period(1_min);
+
+  auto append_candle = [&](const int64_t a_idx) {
+    const double price = 7000 + ((a_idx * 7919) % 1000) * 0.01;
+    const Time timestamp = start_time + Duration(a_idx * 60000000);
+
+    candle_period.append(Candlestick(timestamp, price, price + 1, price - 1, price + 2, price + 0.5, 0.3,
+                                     Volume(0.1 + (a_idx % 7) * 0.3)));
+    return timestamp;
+  };
+
+  int64_t idx = 0;
+  for (; idx < 1000; ++idx) append_candle(idx);
+
+  eager.constructFrom(candle_period);
+  lazy.constructFrom(candle_period);
+
+  // candles keep coming like in a trade history, the lazy indicator is read on a few of them only
+  for (; idx < 6000; ++idx) {
+    const Time timestamp = append_candle(idx);
+
+    eager.advanceTo(timestamp);
+    lazy.advanceTo(timestamp);
+
+    REQUIRE(lazy.getNumCandles() == eager.getNumCandles());
+
+    if ((idx % 1000) == 0) {
+      CHECK(lazy.getLastTimeStamp() == eager.getLastTimeStamp());
+      CHECK(lazy.getIndicatorAtTime<1>(timestamp - 1_min).ema == eager.getIndicatorAtTime<1>(timestamp - 1_min).ema);
+    }
+  }
+
+  double max_diff = 0;
+
+  for (size_t i = 0; i < eager.getNumCandles(); ++i) {
+    max_diff = max(max_diff, relativeDiff(lazy.getIndicatorAtIdx<0>(i).ma, eager.getIndicatorAtIdx<0>(i).ma));
+    max_diff = max(max_diff, relativeDiff(lazy.getIndicatorAtIdx<1>(i).ema, eager.getIndicatorAtIdx<1>(i).ema));
+    max_diff = max(max_diff, relativeDiff(lazy.getIndicatorAtIdx<2>(i).rsi, eager.getIndicatorAtIdx<2>(i).rsi));
+  }
+
+  CHECK(max_diff < 1e-9);
+
+  // an eager indicator publishes its last value as the candles mature, a lazy one isn't read from other threads
+  CHECK(eager.getLastValue<1>().ema == eager.getIndicatorAtIdx<1>().ema);
+
+  TraderBot::deleteInstance();
+}
+
+TEST_CASE("indicator_registry", "[basic][precommit]") {
+  COUT << CBLUE << "TEST: indicator_registry [basic]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  const CurrencyPair currency_pair(currency_t::BTC, currency_t::USD);
+  IndicatorRegistry registry;
+
+  // a standalone EMA(26) and a MACD(12, 26, 9) of two algos share the EMA(26)
+  DiscreteIndicator<EMA>* p_slow_ema = registry.getEMA(exchange_t::COINBASE, currency_pair, 1_min, 26);
+  DiscreteIndicator<DerivedMACD>* p_macd = registry.getMACD(exchange_t::COINBASE, currency_pair, 1_min, 12, 26, 9);
+  DiscreteIndicator<EMA>* p_fast_ema = registry.getEMA(exchange_t::COINBASE, currency_pair, 1_min, 12);
+
+  REQUIRE(registry.getNumNodes() == 3);
+  REQUIRE(registry.getMACD(exchange_t::COINBASE, currency_pair, 1_min, 12, 26, 9) == p_macd);
+  REQUIRE(registry.getEMA(exchange_t::COINBASE, currency_pair, 1_min, 26) == p_slow_ema);
+
+  // other parameters, price, interval or pair are other nodes
+  REQUIRE(registry.getEMA(exchange_t::COINBASE, currency_pair, 1_min, 26, candle_price_t::CLOSE) != p_slow_ema);
+  REQUIRE(registry.getEMA(exchange_t::COINBASE, currency_pair, 5_min, 26) != p_slow_ema);
+  REQUIRE(registry.getEMA(exchange_t::COINBASE, CurrencyPair(currency_t::ETH, currency_t::USD), 1_min, 26) !=
+          p_slow_ema);
+  REQUIRE(registry.getNumNodes() == 6);
+
+  TradeHistory history(exchange_t::COINBASE, currency_pair, true, {1_min});
+  registry.addTo(&history);
+
+  // the ta-lib MACD of the same candles, with EMAs of its own
+  unique_ptr<DiscreteIndicator<MACD>> p_talib_macd(
+      new DiscreteIndicator<MACD>(exchange_t::COINBASE, currency_pair, 1_min, MACD(12, 26, 9)));
+  REQUIRE(history.addIndicator(1_min, p_talib_macd.get()));
+
+  const Time start_time(2019, 12, 17, 0, 0, 0);
+
+  // 500 minutes with 4 ticks a minute
+  for (int64_t idx = 0; idx < 2000; ++idx) {
+    Tick tick(start_time + Duration(idx * 15000000), 1000000000 + idx, 7000 + ((idx * 7919) % 1000) * 0.01, 0.1);
+    history.appendTrade(tick);
+  }
+
+  REQUIRE(p_macd->getNumCandles() == p_slow_ema->getNumCandles());
+  REQUIRE(p_macd->getNumCandles() == 499);
+
+  // every node is fed once, the MACD from the values of the shared EMAs
+  for (size_t i = 40; i < p_macd->getNumCandles(); ++i) {
+    const macd_t macd = p_macd->getIndicatorAtIdx<0>(i);
+
+    CHECK(macd.macd == (p_fast_ema->getIndicatorAtIdx<0>(i).ema - p_slow_ema->getIndicatorAtIdx<0>(i).ema));
+    CHECK(macd.macd_hist == (macd.macd - macd.macd_signal));
+  }
+
+  CHECK(std::isnan(p_macd->getIndicatorAtIdx<0>(0).macd));
+
+  // the fast EMA of the ta-lib MACD starts later, the difference fades as the EMAs converge
+  double max_diff = 0;
+
+  for (size_t i = 250; i < p_macd->getNumCandles(); ++i) {
+    const macd_t macd = p_macd->getIndicatorAtIdx<0>(i);
+    const macd_t expected_macd = p_talib_macd->getIndicatorAtIdx<0>(i);
+
+    max_diff = max(max_diff, fabs(macd.macd - expected_macd.macd));
+    max_diff = max(max_diff, fabs(macd.macd_signal - expected_macd.macd_signal));
+    max_diff = max(max_diff, fabs(macd.macd_hist - expected_macd.macd_hist));
+  }
+
+  CHECK(max_diff < 1e-6);
+
+  TraderBot::deleteInstance();
+}
+
+TEST_CASE("indicator_rolling", "[basic][precommit]") {
+  COUT << CBLUE << "TEST: indicator_rolling [basic]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  const CurrencyPair currency_pair(currency_t::BTC, currency_t::USD);
+  const Time start_time(2019, 12, 17, 0, 0, 0);
+  const size_t period = 20;
+
+  CandlePeriod candle_period(1_min);
+
+  // with a run of candles without volume longer than the window
+  for (int64_t idx = 0; idx < 3000; ++idx) {
+    const double price = 7000 + ((idx * 7919) % 1000) * 0.01;
+    const double volume = ((idx >= 1010) && (idx < 1060)) ? 0 : (idx % 5) * 0.3;
+
+    candle_period.append(Candlestick(start_time + Duration(idx * 60000000), price, price + 1, price - 1, price + 2,
+                                     price + 0.5, 0.3, Volume(volume)));
+  }
+
+  DiscreteIndicator<CHANNEL, QUANTILE, VWAP, VARIANCE> indicators(
+      exchange_t::COINBASE, currency_pair, 1_min, CHANNEL(period), QUANTILE(period, 0.5, candle_price_t::MEAN),
+      VWAP(period), VARIANCE(period, candle_price_t::CLOSE));
+
+  indicators.constructFrom(candle_period);
+  REQUIRE(indicators.getNumCandles() == candle_period.size());
+
+  double max_diff = 0;
+
+  // the window of every candle rescanned
+  for (size_t i = 0; i < candle_period.size(); ++i) {
+    const size_t first = (i + 1 >= period) ? (i + 1 - period) : 0;
+
+    double low = DBL_MAX, high = -DBL_MAX, traded_value = 0, volume = 0, sum = 0;
+    vector<double> means;
+
+    for (size_t k = first; k <= i; ++k) {
+      const Candlestick& candle = candle_period[k];
+
+      low = min(low, candle.getLow());
+      high = max(high, candle.getHigh());
+      traded_value += candle.getMean() * candle.getTotalVolume();
+      volume += candle.getTotalVolume();
+      sum += candle.getClose();
+      means.push_back(candle.getMean());
+    }
+
+    const double mean = sum / means.size();
+    double sum_squares = 0;
+    for (size_t k = first; k <= i; ++k) sum_squares += pow(candle_period[k].getClose() - mean, 2);
+
+    sort(means.begin(), means.end());
+    const double median = (means.size() % 2) ? means[means.size() / 2]
+                                             : (means[means.size() / 2 - 1] + means[means.size() / 2]) / 2;
+
+    CHECK(indicators.getIndicatorAtIdx<0>(i).channel_low == low);
+    CHECK(indicators.getIndicatorAtIdx<0>(i).channel_high == high);
+
+    max_diff = max(max_diff, relativeDiff(indicators.getIndicatorAtIdx<1>(i).quantile, median));
+    max_diff = max(max_diff, relativeDiff(indicators.getIndicatorAtIdx<3>(i).mean, mean));
+    max_diff = max(max_diff, relativeDiff(indicators.getIndicatorAtIdx<3>(i).variance, sum_squares / means.size()));
+
+    // the last price while the window has no volume
+    const double vwap = (volume > 0) ? (traded_value / volume) : candle_period[i].getMean();
+    max_diff = max(max_diff, relativeDiff(indicators.getIndicatorAtIdx<2>(i).vwap, vwap));
+  }
+
+  CHECK(max_diff < 1e-9);
+
+  // a run of ticks without size longer than the window, after trades
+  OrderFlowImbalance order_flow(period);
+  const int64_t num_trades = 46;
+
+  for (int64_t idx = 0; idx < 100; ++idx) {
+    const double size = (idx < num_trades) ? ((idx % 3) ? 0.1 : -0.3) : 0;
+
+    order_flow.append(Tick(start_time + Duration(idx * 1000000), 1000 + idx, 7000, size));
+
+    if (idx + 1 == num_trades) CHECK(order_flow.m_value.imbalance != 0);
+
+    if (idx >= num_trades + (int64_t)period - 1) {
+      CHECK(order_flow.m_value.imbalance == 0);
+      CHECK(order_flow.m_value.net_volume == 0);
+    }
+  }
+
+  TraderBot::deleteInstance();
+}
+
+TEST_CASE("indicator_continuous", "[basic][precommit]") {
+  COUT << CBLUE << "TEST: indicator_continuous [basic]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  typedef ContinuousIndicator<TickEWMA, TickVWAP, OrderFlowImbalance, RealizedVolatility> indicators_t;
+  const CurrencyPair currency_pair(currency_t::BTC, currency_t::USD);
+  const Time start_time(2019, 12, 17, 0, 0, 0);
+
+  indicators_t attached(exchange_t::COINBASE, currency_pair, TickEWMA(Duration(0, 0, 0, 10)), TickVWAP(50),
+                        OrderFlowImbalance(50), RealizedVolatility(50));
+  indicators_t fed(exchange_t::COINBASE, currency_pair, TickEWMA(Duration(0, 0, 0, 10)), TickVWAP(50),
+                   OrderFlowImbalance(50), RealizedVolatility(50));
+
+  TradeHistory history(exchange_t::COINBASE, currency_pair, true, {1_min});
+  vector<Tick> ticks;
+
+  for (int64_t idx = 0; idx < 3000; ++idx) {
+    Tick tick(start_time + Duration(idx * 250000), 1000000000 + idx, 7000 + ((idx * 7919) % 1000) * 0.01,
+              ((idx % 3) ? 0.1 : -0.2));
+    ticks.push_back(tick);
+
+    // constructed from the first 1000 ticks, then updated by the history
+    if (idx == 1000) history.addContinuousIndicator(&attached);
+
+    history.appendTrade(tick);
+    fed.append(tick);
+
+    if (idx >= 1000) {
+      REQUIRE(attached.getLastTimeStamp() == tick.getTimeStamp());
+      CHECK(attached.getValue<0>().ewma == fed.getValue<0>().ewma);
+    }
+  }
+
+  REQUIRE(attached.getNumTicks() == ticks.size());
+
+  double bought_volume = 0, sold_volume = 0, traded_value = 0;
+  for (size_t i = ticks.size() - 50; i < ticks.size(); ++i) {
+    (ticks[i].getSize() > 0 ? bought_volume : sold_volume) += fabs(ticks[i].getSize());
+    traded_value += ticks[i].getPrice() * fabs(ticks[i].getSize());
+  }
+
+  const order_flow_t order_flow = attached.getLastValue<2>();
+
+  CHECK(relativeDiff(order_flow.net_volume, bought_volume - sold_volume) < 1e-9);
+  CHECK(relativeDiff(order_flow.imbalance, (bought_volume - sold_volume) / (bought_volume + sold_volume)) < 1e-9);
+  CHECK(relativeDiff(attached.getValue<1>().vwap, traded_value / (bought_volume + sold_volume)) < 1e-9);
+  CHECK(attached.getValue<3>().volatility == fed.getValue<3>().volatility);
+
+  TraderBot::deleteInstance();
+}
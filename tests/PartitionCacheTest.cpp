@@ -0,0 +1,86 @@
+//
+//*****************************************************************
+//
+// WARRANTY:
+// Use all material in this file at your own risk.
+//
+// Created by subhagato on 10/18/26.
+//
+// partition cache test code.
+
+#include <catch2/catch.hpp>
+
+#include "PartitionCache.h"
+#include "Tick.h"
+#include "TraderBot.h"
+#include "utils/dbUtils.h"
+
+using namespace std;
+
+TEST_CASE("partition_cache", "[basic][precommit]") {
+  COUT << CBLUE << "TEST: partition_cache [basic]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  const string cache_dir = g_trader_home + "/test_partition_cache";
+
+  deque<Tick> ticks = {Tick(Time(2019, 12, 16, 23, 59, 0), 1000000000, 1, 1),
+                       Tick(Time(2019, 12, 16, 23, 59, 30), 1000000001, 20, -1)};
+
+  string rows;
+  for (auto& tick : ticks) DbUtils::writeRowBinary(rows, tick);
+
+  const string version = "3";  // generation of the table
+  const string key = PartitionCache::sMakeKey("crypto.btc_usd_coinbase", version, 24, 18246);
+  const size_t file_bytes = sizeof(uint32_t) + key.size() + rows.size();
+
+  {
+    PartitionCache cache(cache_dir, 2 * file_bytes);
+
+    string cached_rows;
+    CHECK(!cache.get(key, cached_rows));
+
+    cache.put(key, rows);
+    REQUIRE(cache.get(key, cached_rows));
+
+    const char* p_bytes = cached_rows.data();
+    for (auto& tick : ticks) {
+      const Tick cached_tick = DbUtils::readRowBinary<Tick>(p_bytes);
+      CHECK(cached_tick == tick);
+      CHECK(cached_tick.getSize() == tick.getSize());
+    }
+    CHECK(p_bytes == cached_rows.data() + cached_rows.size());
+
+    // a third partition evicts the least recently used one
+    cache.put(PartitionCache::sMakeKey("crypto.btc_usd_coinbase", version, 24, 18247), rows);
+    CHECK(cache.get(key, cached_rows));
+    cache.put(PartitionCache::sMakeKey("crypto.btc_usd_coinbase", version, 24, 18248), rows);
+    CHECK(cache.getNumEntries() == 2);
+    CHECK(cache.get(key, cached_rows));
+    CHECK(!cache.get(PartitionCache::sMakeKey("crypto.btc_usd_coinbase", version, 24, 18247), cached_rows));
+  }
+
+  {
+    // files of the previous run are found again
+    PartitionCache cache(cache_dir, 2 * file_bytes);
+    CHECK(cache.getNumEntries() == 2);
+    CHECK(cache.getNumBytes() == 2 * file_bytes);
+
+    string cached_rows;
+    CHECK(cache.get(key, cached_rows));
+    CHECK(cached_rows == rows);
+
+    // the partition cached before the table was repaired isn't used
+    const string repaired_key = PartitionCache::sMakeKey("crypto.btc_usd_coinbase", "4", 24, 18246);
+    CHECK(!cache.get(repaired_key, cached_rows));
+
+    cache.erase(key);
+    CHECK(!cache.get(key, cached_rows));
+  }
+
+  const string command = "rm -rf " + cache_dir;
+  CHECK(!system(command.c_str()));
+
+  TraderBot::deleteInstance();
+}
@@ -0,0 +1,259 @@
+//
+//*****************************************************************
+//
+// WARRANTY:
+// Use all material in this file at your own risk.
+//
+// Created by subhagato on 10/18/26.
+//
+// in memory tick period and tick columns test code.
+
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <cstdint>
+
+#include "CandlePeriod.h"
+#include "Tick.h"
+#include "TickColumns.h"
+#include "TickPeriod.h"
+#include "TraderBot.h"
+#include "indicators/DiscreteIndicator.h"
+
+using namespace std;
+
+TEST_CASE("tickperiod_view", "[basic][precommit]") {
+  COUT << CBLUE << "TEST: tickperiod_view [basic]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  TickPeriod full_period;
+
+  for (int64_t idx = 0; idx < 4; ++idx) {
+    Tick tick(Time(2019, 12, 17, 0, idx, 0), 1000000000 + idx, 10 + idx, 1);
+    REQUIRE(full_period.append(tick) == 1);
+  }
+
+  TickPeriod view_period;
+  view_period.setView(&full_period, 2);
+
+  REQUIRE(view_period.isView());
+  CHECK(view_period.size() == 2);
+  CHECK(&view_period.front() == &full_period.front());  // no copy of the ticks
+  CHECK(view_period.back().getUniqueID() == 1000000001);
+  CHECK(view_period.getLastUniqueId() == 1000000001);
+  CHECK((view_period.end() - view_period.begin()) == 2);
+
+  Tick next_tick = full_period[2];
+  Tick skipped_tick = full_period[3];
+
+  CHECK(view_period.append(skipped_tick) == -1);  // only the next tick of the source can be added
+  CHECK(view_period.append(next_tick) == 1);
+  CHECK(view_period.size() == 3);
+  CHECK(view_period.getLastTimestamp() == next_tick.getTimeStamp());
+
+  view_period.clear();
+
+  CHECK(!view_period.isView());
+  CHECK(view_period.empty());
+  CHECK(full_period.size() == 4);
+
+  TraderBot::deleteInstance();
+}
+
+TEST_CASE("tickperiod_late_ticks", "[basic][precommit]") {
+  COUT << CBLUE << "TEST: tickperiod_late_ticks [basic]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  const Time start_time(2019, 12, 17, 0, 0, 0);
+
+  TickPeriod tick_period(false);  // not consecutive
+  vector<Tick> late_ticks;
+
+  // every fourth tick arrives late
+  for (int64_t idx = 0; idx < 400; ++idx) {
+    Tick tick(start_time + Duration(0, 0, 0, idx), 1000 + idx, 100 + idx, 1);
+
+    if ((idx % 4) == 1)
+      late_ticks.push_back(tick);
+    else
+      REQUIRE(tick_period.append(tick) == 1);
+  }
+
+  CandlePeriod candle_period(1_min);
+  candle_period.convertFrom(tick_period);
+
+  // single late tick goes to its place, a second time it already exists
+  Tick late_tick = late_ticks.back();
+  late_ticks.pop_back();
+
+  CHECK(tick_period.append(late_tick) == 3);
+  CHECK(tick_period.append(late_tick) == 0);
+
+  late_ticks.push_back(late_ticks.front());  // duplicate in the batch
+  reverse(late_ticks.begin(), late_ticks.end());
+
+  CHECK(tick_period.merge(late_ticks) == 99);
+  REQUIRE(tick_period.size() == 400);
+
+  for (size_t idx = 0; idx < tick_period.size(); ++idx)
+    REQUIRE(tick_period[idx].getUniqueID() == static_cast<int64_t>(1000 + idx));
+
+  CHECK(tick_period.getFirstUniqueId() == 1000);
+  CHECK(tick_period.getLastUniqueId() == 1399);
+
+  // finished candles are rebuilt with their late ticks
+  CandlePeriod expected_period(1_min);
+  expected_period.convertFrom(tick_period);
+
+  for (size_t idx = 0; idx < candle_period.size(); ++idx) {
+    CHECK(candle_period[idx].getTotalVolume() != expected_period[idx].getTotalVolume());
+    CHECK(candle_period.updateCandle(tick_period, candle_period[idx].getTimeStamp()));
+    CHECK(candle_period[idx].getTotalVolume() == expected_period[idx].getTotalVolume());
+    CHECK(candle_period[idx].getMean() == expected_period[idx].getMean());
+  }
+
+  CHECK(!candle_period.updateCandle(tick_period, start_time - 1_min));  // not built
+
+  TraderBot::deleteInstance();
+}
+
+TEST_CASE("tickperiod_eviction", "[basic][precommit]") {
+  COUT << CBLUE << "TEST: tickperiod_eviction [basic]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  TickPeriod full_period;
+  CandlePeriod candle_period(1_min);
+
+  for (int64_t idx = 0; idx < 100; ++idx) {
+    Tick tick(Time(2019, 12, 17, 0, 0, 0) + Duration(0, 0, 0, 10 * idx), 1000000000 + idx, 10 + idx, 1);
+    REQUIRE(full_period.append(tick) == 1);
+    candle_period.appendTick(tick);
+  }
+
+  TickPeriod view_period;
+  view_period.setView(&full_period, 80);
+
+  // evicted ticks of the source are dropped from the front of the view too
+  CHECK(full_period.evictFront(30) == 30);
+  CHECK(view_period.evictFront(10) == 0);  // a view doesn't own its ticks
+  CHECK(full_period.size() == 70);
+  CHECK(full_period.getNumEvicted() == 30);
+  CHECK(full_period.getFirstUniqueId() == 1000000030);
+  CHECK(view_period.size() == 50);
+  CHECK(&view_period.front() == &full_period.front());
+
+  Tick next_tick = full_period[50];
+  CHECK(view_period.append(next_tick) == 1);
+  CHECK(view_period.size() == 51);
+  CHECK(view_period.back().getUniqueID() == 1000000080);
+  CHECK(view_period.getFirstUniqueId() == 1000000030);
+
+  // the last candle is always kept
+  const size_t num_candles = candle_period.size();
+  CHECK(candle_period.evictFront(num_candles) == (num_candles - 1));
+  CHECK(candle_period.size() == 1);
+  CHECK(candle_period.getFirstTimestamp() == candle_period.back().getTimeStamp());
+
+  // indices of indicator values keep counting from the first candle
+  DiscreteIndicator<MA> indicator(exchange_t::COINBASE, CurrencyPair(currency_t::BTC, currency_t::USD), 1_min,
+                                  MA(5, false, candle_price_t::CLOSE));
+  CandlePeriod candles(1_min);
+  candles.convertFrom(full_period);
+  indicator.constructFrom(candles);
+
+  const size_t num_values = indicator.getNumCandles();
+  const ma_t last_value = indicator.getIndicatorAtIdx<0>();
+  const ma_t third_last_value = indicator.getIndicatorAtIdx<0>(num_values - 3);
+
+  indicator.trimValues(3);
+  CHECK(indicator.getFirstIdx() == (num_values - 3));
+  CHECK(indicator.getIndicatorValues<0>().size() == 3);
+  CHECK(indicator.getIndicatorAtIdx<0>().ma == last_value.ma);
+  CHECK(indicator.getIndicatorAtIdx<0>(num_values - 3).ma == third_last_value.ma);
+
+  TraderBot::deleteInstance();
+}
+
+TEST_CASE("tick_columns", "[basic][precommit]") {
+  COUT << CBLUE << "TEST: tick_columns [basic]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  const int64_t num_ticks = 3 * TICK_COLUMNS_CHUNK_SIZE;
+  const Time start_time(2019, 12, 17, 0, 0, 0);
+
+  TickPeriod tick_period;
+  TickColumns tick_columns;
+
+  // fill both ends, so the first and last chunk are partially used
+  for (int64_t idx = num_ticks / 2; idx < num_ticks; ++idx) {
+    Tick tick(start_time + Duration(0, 0, 0, idx), 1000000000 + idx, 7000 + (idx % 100), ((idx % 3) ? 1 : -1) * 0.5);
+    tick_period.append(tick);
+    tick_columns.push_back(tick);
+  }
+
+  for (int64_t idx = (num_ticks / 2) - 1; idx >= 0; --idx) {
+    Tick tick(start_time + Duration(0, 0, 0, idx), 1000000000 + idx, 7000 + (idx % 100), ((idx % 3) ? 1 : -1) * 0.5);
+    tick_period.append(tick);
+    tick_columns.push_front(tick);
+  }
+
+  REQUIRE(tick_columns.size() == tick_period.size());
+
+  for (size_t idx = 0; idx < tick_period.size(); ++idx) {
+    REQUIRE(tick_columns[idx] == tick_period[idx]);
+    REQUIRE(tick_columns.getSize(idx) == tick_period[idx].getSize());
+  }
+
+  // read like a TickPeriod
+  CHECK(tick_columns.getFirstTimestamp() == tick_period.getFirstTimestamp());
+  CHECK(tick_columns.getLastTimestamp() == tick_period.getLastTimestamp());
+  CHECK(tick_columns.getFirstUniqueId() == tick_period.getFirstUniqueId());
+  CHECK(tick_columns.getLastUniqueId() == tick_period.getLastUniqueId());
+  CHECK((tick_columns.end() - tick_columns.begin()) == num_ticks);
+  CHECK(*(tick_columns.begin() + 5) == tick_period[5]);
+  CHECK(equal(tick_columns.begin(), tick_columns.end(), tick_period.begin()));
+
+  vector<tick_columns_t> spans;
+  CHECK(tick_columns.getSpans(0, tick_columns.size(), spans) == 4);
+
+  size_t num_span_ticks = 0;
+  for (auto& span : spans) num_span_ticks += span.num_ticks;
+  CHECK(num_span_ticks == tick_columns.size());
+  CHECK((reinterpret_cast<uintptr_t>(spans[1].price) % 64) == 0);  // a full chunk starts at an aligned row
+
+  // same candles as from the tick period
+  for (auto interval : {1_min, 5_min, 1_hour}) {
+    CandlePeriod from_ticks(interval);
+    CandlePeriod from_columns(interval);
+
+    from_ticks.convertFrom(tick_period);
+    from_columns.convertFrom(tick_columns);
+
+    REQUIRE(from_columns.size() == from_ticks.size());
+    for (size_t idx = 0; idx < from_ticks.size(); ++idx) {
+      CHECK(from_columns[idx].getTimeStamp() == from_ticks[idx].getTimeStamp());
+      CHECK(from_columns[idx].getClose() == from_ticks[idx].getClose());
+      CHECK(from_columns[idx].getMean() == from_ticks[idx].getMean());
+      CHECK(from_columns[idx].getTotalVolume() == from_ticks[idx].getTotalVolume());
+    }
+  }
+
+  for (int64_t idx = 0; idx < TICK_COLUMNS_CHUNK_SIZE; ++idx) tick_columns.pop_front();
+  tick_columns.pop_back();
+
+  CHECK(tick_columns.size() == static_cast<size_t>(num_ticks - TICK_COLUMNS_CHUNK_SIZE - 1));
+  CHECK(tick_columns.front() == tick_period[TICK_COLUMNS_CHUNK_SIZE]);
+  CHECK(tick_columns.back() == tick_period[num_ticks - 2]);
+
+  tick_columns.assign(tick_period);
+  CHECK(tick_columns.size() == tick_period.size());
+
+  TraderBot::deleteInstance();
+}
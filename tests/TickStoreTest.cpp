@@ -0,0 +1,104 @@
+//
+//*****************************************************************
+//
+// WARRANTY:
+// Use all material in this file at your own risk.
+//
+// Created by subhagato on 10/18/26.
+//
+// local columnar tick store test code.
+
+#include <catch2/catch.hpp>
+
+#include "Tick.h"
+#include "TickPeriod.h"
+#include "TickStore.h"
+#include "TraderBot.h"
+
+using namespace std;
+
+TEST_CASE("tick_store", "[basic][precommit]") {
+  COUT << CBLUE << "TEST: tick_store [basic]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  const string store_dir = g_trader_home + "/test_tick_store";
+
+  {
+    TickStore store(store_dir, "btc_usd_coinbase");
+
+    deque<Tick> ticks = {
+        Tick(Time(2019, 12, 16, 23, 59, 0), 1000000000, 1, 1), Tick(Time(2019, 12, 16, 23, 59, 30), 1000000001, 20, -1),
+        Tick(Time(2019, 12, 17, 0, 0, 0), 1000000002, 3, 10), Tick(Time(2019, 12, 17, 0, 1, 0), 1000000003, 41, -5)};
+
+    CHECK(store.append(ticks) == 4);
+    CHECK(store.append(ticks) == 0);  // already stored
+    CHECK(store.hasSegment(Time(2019, 12, 16, 0, 0, 0).days_since_epoch()));
+    CHECK(store.hasSegment(Time(2019, 12, 17, 0, 0, 0).days_since_epoch()));
+
+    vector<tick_columns_t> ranges;
+    CHECK(store.scan(Time(2019, 12, 16, 23, 59, 30), Time(2019, 12, 17, 0, 1, 0), ranges) == 2);
+    REQUIRE(ranges.size() == 2);
+    CHECK(ranges[0].trade_id[0] == 1000000001);
+    CHECK(ranges[1].price[0] == 3);
+
+    TickPeriod tick_period;
+    tick_period.loadFromDatabase(&store, Time(2019, 12, 16, 0, 0, 0), Time(2019, 12, 18, 0, 0, 0));
+
+    REQUIRE(tick_period.size() == ticks.size());
+    for (size_t idx = 0; idx < ticks.size(); ++idx) {
+      CHECK(tick_period[idx] == ticks[idx]);
+      CHECK(tick_period[idx].getSize() == ticks[idx].getSize());
+    }
+
+    // a day without ticks is recorded, and ticks can still be added to it
+    const int32_t empty_date = Time(2019, 12, 18, 0, 0, 0).days_since_epoch();
+
+    CHECK(!store.hasSegment(empty_date));
+    store.addEmptyDay(empty_date);
+    CHECK(store.hasSegment(empty_date));
+
+    ranges.clear();
+    CHECK(store.scan(Time(2019, 12, 18, 0, 0, 0), Time(2019, 12, 19, 0, 0, 0), ranges) == 0);
+
+    deque<Tick> late_ticks = {Tick(Time(2019, 12, 18, 1, 0, 0), 1000000004, 5, 1)};
+    CHECK(store.append(late_ticks) == 1);
+    CHECK(store.scan(Time(2019, 12, 18, 0, 0, 0), Time(2019, 12, 19, 0, 0, 0), ranges) == 1);
+
+    // a column left longer by a failed append is cut back, so the columns of the next append line up
+    const string price_filename = store.getDir() + "/" + to_string(Time(2019, 12, 17, 0, 0, 0).days_since_epoch()) +
+                                  ".price";
+    const double stray_price = 99;
+    FILE* p_file = fopen(price_filename.c_str(), "ab");
+    REQUIRE(p_file);
+    CHECK(fwrite(&stray_price, sizeof(double), 1, p_file) == 1);
+    fclose(p_file);
+
+    deque<Tick> next_ticks = {Tick(Time(2019, 12, 17, 0, 2, 0), 1000000005, 6, 1)};
+    CHECK(store.append(next_ticks) == 1);
+
+    ranges.clear();
+    REQUIRE(store.scan(Time(2019, 12, 17, 0, 2, 0), Time(2019, 12, 17, 0, 3, 0), ranges) == 1);
+    CHECK(ranges[0].trade_id[0] == 1000000005);
+    CHECK(ranges[0].price[0] == 6);
+
+    // segments, empty days included, copied from another generation of the table are dropped
+    CHECK(store.getGeneration() == -1);
+    store.setGeneration(1);
+    CHECK(store.getGeneration() == 1);
+    CHECK(!store.hasSegment(empty_date));
+
+    ranges.clear();
+    CHECK(store.scan(Time(2019, 12, 16, 0, 0, 0), Time(2019, 12, 19, 0, 0, 0), ranges) == 0);
+
+    CHECK(store.append(ticks) == 4);
+    store.setGeneration(1);
+    CHECK(store.scan(Time(2019, 12, 16, 0, 0, 0), Time(2019, 12, 19, 0, 0, 0), ranges) == 4);
+  }
+
+  const string command = "rm -rf " + store_dir;
+  CHECK(!system(command.c_str()));
+
+  TraderBot::deleteInstance();
+}
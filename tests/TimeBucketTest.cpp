@@ -0,0 +1,49 @@
+//
+//*****************************************************************
+//
+// WARRANTY:
+// Use all material in this file at your own risk.
+//
+// Created by subhagato on 10/18/26.
+//
+// time bucket test code.
+
+#include <catch2/catch.hpp>
+
+#include "DataTypes.h"
+#include "TraderBot.h"
+
+using namespace std;
+
+TEST_CASE("time_bucket", "[basic][precommit]") {
+  COUT << CBLUE << "TEST: time_bucket [basic]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  const Time time(2019, 12, 16, 7, 30, 0);
+
+  // day buckets are the legacy (date, micros since midnight) layout
+  TimeBucket day_bucket;
+  CHECK(day_bucket.getBucket(time) == time.days_since_epoch());
+  CHECK(day_bucket.getOffset(time) == time.micros_since_midnight());
+  CHECK(day_bucket.getTime(day_bucket.getBucket(time), day_bucket.getOffset(time)) == time);
+
+  TimeBucket hour_bucket(bucket_width_t::HOUR);
+  CHECK(hour_bucket.getBucket(time) == time.days_since_epoch() * 24 + 7);
+  CHECK(hour_bucket.getOffset(time) == 30 * 60 * 1000000LL);
+  CHECK(hour_bucket.getTime(hour_bucket.getBucket(time), hour_bucket.getOffset(time)) == time);
+
+  // start and end keys of a bucket are in the day form
+  const primary_key_t start_key = hour_bucket.getStartKey(hour_bucket.getBucket(time));
+  const primary_key_t end_key = hour_bucket.getEndKey(hour_bucket.getBucket(time));
+  CHECK(start_key.date == time.days_since_epoch());
+  CHECK(start_key.time == 7 * 3600 * 1000000LL);
+  CHECK(end_key.time == 8 * 3600 * 1000000LL - 1);
+  CHECK(hour_bucket.getBucket(end_key) == hour_bucket.getBucket(time));
+
+  TimeBucket week_bucket(bucket_width_t::WEEK);
+  CHECK(week_bucket.getBucket(time) == time.days_since_epoch() / 7);
+
+  TraderBot::deleteInstance();
+}
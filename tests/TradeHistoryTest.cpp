@@ -0,0 +1,131 @@
+//
+//*****************************************************************
+//
+// WARRANTY:
+// Use all material in this file at your own risk.
+//
+// Created by subhagato on 10/18/26.
+//
+// trade history test code.
+
+#include <catch2/catch.hpp>
+
+#include "Tick.h"
+#include "TickPeriod.h"
+#include "TradeHistory.h"
+#include "TraderBot.h"
+
+using namespace std;
+
+TEST_CASE("tradehistory_append_trades", "[basic][precommit]") {
+  COUT << CBLUE << "TEST: tradehistory_append_trades [basic]\n";
+
+  TraderBot* trader_bot = TraderBot::getInstance();
+  REQUIRE(!trader_bot->traderMain());
+
+  const CurrencyPair currency_pair(currency_t::BTC, currency_t::USD);
+
+  SECTION("consecutive") {
+    TradeHistory history(exchange_t::COINBASE, currency_pair, true, {1_min});
+
+    TickPeriod ticks;
+    for (int64_t idx = 0; idx < 100; ++idx) {
+      Tick tick(Time(2019, 12, 17, 0, 0, idx), 1000 + idx, 100, 1);
+      ticks.append(tick);
+    }
+
+    // one notification for the whole batch
+    REQUIRE(history.appendTrades(ticks));
+    CHECK(history.getNumCallBacks() == 1);
+    CHECK(history.getNumCallBackTicks() == 100);
+
+    // ticks which already exist don't notify
+    REQUIRE(history.appendTrades(ticks));
+    CHECK(history.getNumCallBacks() == 1);
+
+    // only the new ticks of an overlapping batch are counted
+    TickPeriod overlapping;
+    for (int64_t idx = 90; idx < 150; ++idx) {
+      Tick tick(Time(2019, 12, 17, 0, 0, idx), 1000 + idx, 100, 1);
+      overlapping.append(tick);
+    }
+
+    REQUIRE(history.appendTrades(overlapping));
+    CHECK(history.getNumCallBacks() == 2);
+    CHECK(history.getNumCallBackTicks() == 150);
+
+    Tick tick(Time(2019, 12, 17, 0, 2, 30), 1150, 100, 1);
+    REQUIRE(history.appendTrade(tick));
+    CHECK(history.getNumCallBacks() == 3);
+    CHECK(history.getNumCallBackTicks() == 151);
+  }
+
+  SECTION("non consecutive") {
+    TradeHistory history(exchange_t::COINBASE, currency_pair, false, {1_min});
+
+    TickPeriod ticks(false);
+    for (int64_t idx = 0; idx < 60; ++idx) {
+      Tick tick(Time(2019, 12, 17, 0, 0, idx), 1000 + idx, 100, 1);
+      ticks.append(tick);
+    }
+
+    REQUIRE(history.appendTrades(ticks));
+    CHECK(history.getNumCallBacks() == 1);
+    CHECK(history.getNumCallBackTicks() == 60);
+
+    // late ticks of the batch are merged with one candle update, only the ticks after the last one are counted
+    TickPeriod late_and_new(false);
+    for (int64_t idx = 0; idx < 60; ++idx) {
+      Tick tick(Time(2019, 12, 17, 0, 0, 29) + Duration(0, 0, 0, idx, 500), 2000 + idx, 100, 1);
+      late_and_new.append(tick);
+    }
+
+    REQUIRE(history.appendTrades(late_and_new));
+    CHECK(history.getTickPeriod()->size() == 120);
+    CHECK(history.getNumCallBacks() == 2);
+    CHECK(history.getNumCallBackTicks() == 90);
+    CHECK(history.getNumCandleUpdates() == 1);
+
+    // a repeat of the last tick is dropped
+    Tick last_tick = history.getLatestTick();
+    REQUIRE(history.appendTrade(last_tick));
+    history.flushReorderWindow();
+    CHECK(history.getTickPeriod()->size() == 120);
+    CHECK(history.getNumCallBacks() == 2);
+    CHECK(history.getNumCandleUpdates() == 1);
+
+    // a single late tick waits in the window until it's flushed
+    Tick late_tick(Time(2019, 12, 17, 0, 0, 10) + Duration(0, 0, 0, 0, 250), 3000, 100, 1);
+    REQUIRE(history.appendTrade(late_tick));
+    CHECK(history.getTickPeriod()->size() == 120);
+
+    history.flushReorderWindow();
+    CHECK(history.getTickPeriod()->size() == 121);
+    CHECK(history.getNumCallBacks() == 2);
+    CHECK(history.getNumCandleUpdates() == 2);
+  }
+
+  SECTION("view") {
+    TradeHistory full_history(exchange_t::COINBASE, currency_pair, true, {1_min});
+    TradeHistory past_history(exchange_t::COINBASE, currency_pair, true, {1_min});
+
+    TickPeriod ticks;
+    for (int64_t idx = 0; idx < 100; ++idx) {
+      Tick tick(Time(2019, 12, 17, 0, 0, 0) + Duration(0, 0, 0, idx / 2), 1000 + idx, 100, 1);
+      ticks.append(tick);
+    }
+
+    REQUIRE(full_history.appendTrades(ticks));
+
+    // the view ends before the first tick at the end time, ticks of the same second included
+    past_history.setViewOf(&full_history, Time(2019, 12, 17, 0, 0, 25));
+    REQUIRE(past_history.getTickPeriod()->isView());
+    CHECK(past_history.getTickPeriod()->size() == 50);
+    CHECK(past_history.getTickPeriod()->back() == ticks[49]);
+
+    past_history.setViewOf(&full_history);
+    CHECK(past_history.getTickPeriod()->size() == 100);
+  }
+
+  TraderBot::deleteInstance();
+}